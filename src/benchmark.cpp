@@ -0,0 +1,458 @@
+// Adam micro benchmarks
+//
+// Times the recall and training hot paths over a matrix of topologies and
+// reports ns/sample, samples/sec, GFLOP/s and heap allocations per sample,
+// as a table or as JSON (--json) for regression tracking.
+//
+// Usage: AdamBenchmark [--json] [--float] [--topology NAME] [--time SECONDS] [--threads N]
+
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <iostream>
+
+#include "neuralNetworkTrainer.hpp"
+
+/*********************** ALLOCATION COUNTING ***********************/
+
+/// Heap allocations made by the process
+static std::atomic<unsigned long> allocationCount(0);
+
+void * operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = (std::size_t)alignment;
+    void *ptr = std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+/*********************** BENCHMARK *********************************/
+
+/**
+ * A network shape: the input count, then the neuron count of each layer
+ */
+struct BenchmarkTopology
+{
+    /// Name used to select and report the topology
+    const char *name;
+
+    /// Inputs, then neurons per layer
+    std::vector<unsigned int> sizes;
+};
+
+/**
+ * One timed measurement
+ */
+struct BenchmarkResult
+{
+    /// The topology measured
+    std::string topology;
+
+    /// The hot path measured
+    std::string benchmark;
+
+    /// Wall time per sample
+    double nsPerSample;
+
+    /// Samples per second
+    double samplesPerSecond;
+
+    /// Floating point operations per second, in billions
+    double gflops;
+
+    /// Heap allocations per sample
+    double allocationsPerSample;
+};
+
+/**
+ * The benchmark settings, from the command line
+ */
+struct BenchmarkOptions
+{
+    /// Emit JSON instead of a table - default: false
+    bool json = false;
+
+    /// Run in single precision - default: false
+    bool singlePrecision = false;
+
+    /// Only run the named topology - default: "" (all)
+    std::string topology;
+
+    /// Minimum timed duration of each measurement - default: 0.25 seconds
+    double minSeconds = 0.25;
+
+    /// Trainer worker threads for the epoch measurement - default: 1
+    unsigned int threads = 1;
+};
+
+/**
+ * This class runs the measurements of one precision, through the public API
+ * only.
+ *
+ * FLOP counts are nominal, one multiply and one add per weight and pass:
+ * recall 2W, a training pass 6W (forward, then the input deltas and the
+ * gradient of the backward pass), and an epoch 8W per sample (the training
+ * pass and the evaluation recall).
+ */
+template<typename T>
+class NeuralBenchmarkT
+{
+public: // Public Methods
+
+    /**
+     * This method runs every benchmark of a topology
+     *
+     * @param topology - the network shape
+     * @param options - the benchmark settings
+     * @param results - receives one result per benchmark
+     */
+    static void run(const BenchmarkTopology &topology, const BenchmarkOptions &options,
+                    std::vector<BenchmarkResult> *results)
+    {
+        const std::vector<unsigned int> &sizes = topology.sizes;
+        const unsigned int inputCount = sizes.front();
+        const unsigned int outputCount = sizes.back();
+
+        double weightCount = 0.0;
+        for (unsigned int layerIdx = 1; layerIdx < sizes.size(); layerIdx++)
+        {
+            weightCount += (double)sizes[layerIdx] * (sizes[layerIdx - 1] + 1);
+        }
+
+        // Enough rows for a meaningful epoch, few enough that it stays short on wide networks
+        const unsigned int rows = (unsigned int)std::max(16.0, std::min(4096.0, (1 << 24) / weightCount));
+        AlignedVector<T> inputs((size_t)rows * inputCount);
+        AlignedVector<T> truths((size_t)rows * outputCount);
+        for (T &value : inputs)
+        {
+            value = (T)rand() / RAND_MAX;
+        }
+        for (T &value : truths)
+        {
+            value = (T)(rand() % 2);
+        }
+        std::vector<T> sample(inputs.begin(), inputs.begin() + inputCount);
+
+        NeuralNetworkTrainerT<T> trainer;
+        trainer.addLayer(sizes[1], inputCount);
+        for (unsigned int layerIdx = 2; layerIdx < sizes.size(); layerIdx++)
+        {
+            trainer.addLayer(sizes[layerIdx]);
+        }
+        trainer.setThreadCount(options.threads);
+
+        // Neuron::recall - one neuron of the first layer
+        {
+            NeuronT<T> neuron(inputCount);
+            volatile T sink = 0;
+            results->push_back(measure(topology.name, "neuron_recall", [&]() { sink = neuron.recall(&sample); },
+                                       1, 2.0 * (inputCount + 1), options.minSeconds));
+        }
+
+        // NeuralLayer::recall - the first layer
+        {
+            NeuralLayerT<T> layer(sizes[1], inputCount);
+            volatile T sink = 0;
+            results->push_back(measure(topology.name, "layer_recall", [&]() { sink = layer.recall(&sample)[0]; },
+                                       1, 2.0 * sizes[1] * (inputCount + 1), options.minSeconds));
+        }
+
+        // NeuralNetwork::recall - one sample through every layer
+        {
+            volatile T sink = 0;
+            results->push_back(measure(topology.name, "network_recall", [&]() { sink = trainer.recall(&sample)[0]; },
+                                       1, 2.0 * weightCount, options.minSeconds));
+        }
+
+        // NeuralNetwork::recallBatch - every row, layer by layer
+        {
+            AlignedVector<T> outputs((size_t)rows * outputCount);
+            results->push_back(measure(topology.name, "network_recall_batch",
+                                       [&]() { trainer.recallBatch(inputs.data(), rows, outputs.data()); },
+                                       rows, 2.0 * weightCount, options.minSeconds));
+        }
+
+        // Training pass - forward, backward and update over one fixed mini-batch, timed by the trainer
+        {
+            const unsigned int batchRows = std::min(rows, 100u);
+            const NeuralDataViewT<T> inputView(inputs.data(), batchRows, inputCount);
+            const NeuralDataViewT<T> truthView(truths.data(), batchRows, outputCount);
+            trainer.setDataSplitRatio(1.0);
+            trainer.setBatchSize(batchRows);
+            results->push_back(measureTraining(topology.name, "train_pass", &trainer, inputView, truthView,
+                                               6.0 * weightCount, options.minSeconds));
+        }
+
+        // trainTestLoop - one training cycle over every row, then the evaluation
+        {
+            const NeuralDataViewT<T> inputView(inputs.data(), rows, inputCount);
+            const NeuralDataViewT<T> truthView(truths.data(), rows, outputCount);
+            trainer.setDataSplitRatio(1.0);
+            trainer.setTrainingCycles(1);
+            results->push_back(measure(topology.name, "train_epoch",
+                                       [&]() { trainer.trainTestLoop(inputView, truthView); },
+                                       rows, 8.0 * weightCount, options.minSeconds));
+        }
+    }
+
+private: // Private Methods
+
+    /**
+     * This method times a body, doubling the number of calls per timed run
+     * until one run lasts the minimum duration, so clock reads stay out of
+     * short bodies
+     *
+     * @param topology - the topology name
+     * @param benchmark - the benchmark name
+     * @param body - the call to time
+     * @param samplesPerCall - the samples processed by one call
+     * @param flopsPerSample - the nominal operations per sample
+     * @param minSeconds - the minimum timed duration
+     * @return - the measurement
+     */
+    template<typename Body>
+    static BenchmarkResult measure(const char *topology, const char *benchmark, Body &&body,
+                                   unsigned long samplesPerCall, double flopsPerSample, double minSeconds)
+    {
+        // Warm the caches and any lazily sized buffers
+        body();
+
+        unsigned long calls = 1;
+        double seconds = 0.0;
+        unsigned long allocations = 0;
+        while (true)
+        {
+            const unsigned long allocationStart = allocationCount.load(std::memory_order_relaxed);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (unsigned long call = 0; call < calls; call++)
+            {
+                body();
+            }
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            allocations = allocationCount.load(std::memory_order_relaxed) - allocationStart;
+            if (seconds >= minSeconds)
+            {
+                break;
+            }
+            calls *= 2;
+        }
+
+        const double samples = (double)calls * samplesPerCall;
+        BenchmarkResult result;
+        result.topology = topology;
+        result.benchmark = benchmark;
+        result.nsPerSample = seconds * 1e9 / samples;
+        result.samplesPerSecond = samples / seconds;
+        result.gflops = flopsPerSample * samples / seconds / 1e9;
+        result.allocationsPerSample = allocations / samples;
+        return result;
+    }
+
+    /**
+     * This method times the training cycles of trainTestLoop with the
+     * trainer's own clock, which leaves out the setup and the evaluation.
+     * The cycle count doubles until the cycles last the minimum duration.
+     *
+     * @param topology - the topology name
+     * @param benchmark - the benchmark name
+     * @param trainer - the network to train
+     * @param inputs - the batch inputs
+     * @param truths - the batch truths
+     * @param flopsPerSample - the nominal operations per sample
+     * @param minSeconds - the minimum timed duration
+     * @return - the measurement
+     */
+    static BenchmarkResult measureTraining(const char *topology, const char *benchmark,
+                                           NeuralNetworkTrainerT<T> *trainer, const NeuralDataViewT<T> &inputs,
+                                           const NeuralDataViewT<T> &truths, double flopsPerSample, double minSeconds)
+    {
+        // Warm the caches and any lazily sized buffers
+        trainer->setTrainingCycles(1);
+        trainer->trainTestLoop(inputs, truths);
+
+        unsigned int cycles = 1;
+        double samples = 0.0;
+        double samplesPerSecond = 0.0;
+        unsigned long allocations = 0;
+        while (true)
+        {
+            trainer->setTrainingCycles(cycles);
+            const unsigned long allocationStart = allocationCount.load(std::memory_order_relaxed);
+            trainer->trainTestLoop(inputs, truths);
+            allocations = allocationCount.load(std::memory_order_relaxed) - allocationStart;
+            samples = (double)cycles * inputs.getRowCount();
+            samplesPerSecond = trainer->getSamplesPerSecond();
+            if (samplesPerSecond > 0.0 && samples / samplesPerSecond >= minSeconds)
+            {
+                break;
+            }
+            cycles *= 2;
+        }
+
+        BenchmarkResult result;
+        result.topology = topology;
+        result.benchmark = benchmark;
+        result.nsPerSample = 1e9 / samplesPerSecond;
+        result.samplesPerSecond = samplesPerSecond;
+        result.gflops = flopsPerSample * samplesPerSecond / 1e9;
+        result.allocationsPerSample = allocations / samples;
+        return result;
+    }
+
+};
+
+/*********************** REPORTING *********************************/
+
+// Print Table
+static void printTable(const std::vector<BenchmarkResult> &results, const BenchmarkOptions &options)
+{
+    std::printf("Instruction set: %s, precision: %s, threads: %u\n", NeuralKernels::getInstructionSet(),
+                options.singlePrecision ? "float" : "double", options.threads);
+    std::printf("%-8s %-22s %14s %14s %10s %12s\n", "topology", "benchmark", "ns/sample", "samples/s",
+                "GFLOP/s", "allocs/smp");
+    for (const BenchmarkResult &result : results)
+    {
+        std::printf("%-8s %-22s %14.1f %14.4g %10.3f %12.3f\n", result.topology.c_str(), result.benchmark.c_str(),
+                    result.nsPerSample, result.samplesPerSecond, result.gflops, result.allocationsPerSample);
+    }
+}
+
+// Print JSON
+static void printJson(const std::vector<BenchmarkResult> &results, const BenchmarkOptions &options)
+{
+    std::printf("{\n  \"instruction_set\": \"%s\",\n  \"precision\": \"%s\",\n  \"threads\": %u,\n  \"results\": [\n",
+                NeuralKernels::getInstructionSet(), options.singlePrecision ? "float" : "double", options.threads);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &result = results[i];
+        std::printf("    {\"topology\": \"%s\", \"benchmark\": \"%s\", \"ns_per_sample\": %.3f, "
+                    "\"samples_per_second\": %.6g, \"gflops\": %.6g, \"allocations_per_sample\": %.6g}%s\n",
+                    result.topology.c_str(), result.benchmark.c_str(), result.nsPerSample, result.samplesPerSecond,
+                    result.gflops, result.allocationsPerSample, (i + 1 < results.size()) ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+/*********************** MAIN **************************************/
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+    for (int argIdx = 1; argIdx < argc; argIdx++)
+    {
+        const std::string arg = argv[argIdx];
+        if (arg == "--json")
+        {
+            options.json = true;
+        }
+        else if (arg == "--float")
+        {
+            options.singlePrecision = true;
+        }
+        else if (arg == "--topology" && argIdx + 1 < argc)
+        {
+            options.topology = argv[++argIdx];
+        }
+        else if (arg == "--time" && argIdx + 1 < argc)
+        {
+            options.minSeconds = std::atof(argv[++argIdx]);
+        }
+        else if (arg == "--threads" && argIdx + 1 < argc)
+        {
+            options.threads = std::max(1, std::atoi(argv[++argIdx]));
+        }
+        else
+        {
+            std::cout << "Usage: " << argv[0]
+                      << " [--json] [--float] [--topology NAME] [--time SECONDS] [--threads N]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Tiny to 4096 wide, shallow to deep
+    std::vector<unsigned int> deep = {32};
+    deep.insert(deep.end(), 12, 64);
+    deep.push_back(10);
+    const std::vector<BenchmarkTopology> topologies =
+    {
+        {"tiny", {2, 2, 1}},
+        {"small", {16, 32, 32, 1}},
+        {"medium", {128, 256, 256, 10}},
+        {"deep", deep},
+        {"wide", {784, 1024, 1024, 10}},
+        {"xwide", {4096, 4096, 10}}
+    };
+
+    srand(1);
+    std::vector<BenchmarkResult> results;
+    for (const BenchmarkTopology &topology : topologies)
+    {
+        if (!options.topology.empty() && options.topology != topology.name)
+        {
+            continue;
+        }
+        if (options.singlePrecision)
+        {
+            NeuralBenchmarkT<float>::run(topology, options, &results);
+        }
+        else
+        {
+            NeuralBenchmarkT<double>::run(topology, options, &results);
+        }
+    }
+
+    if (results.empty())
+    {
+        std::cout << "Error: unknown topology " << options.topology << std::endl;
+        return 1;
+    }
+
+    if (options.json)
+    {
+        printJson(results, options);
+    }
+    else
+    {
+        printTable(results, options);
+    }
+    return 0;
+}
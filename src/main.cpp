@@ -37,6 +37,13 @@ int main() {
     time_req = clock() - time_req;
 
     std::cout << "Processor time taken for training: " << (float)time_req/CLOCKS_PER_SEC << " seconds" << std::endl;
+    std::cout << "Training throughput: " << trainer.getSamplesPerSecond() << " samples/sec" << std::endl;
+    std::cout << "Cycles trained: " << trainer.getCompletedCycles() << std::endl;
+    std::cout << "Trained accuracy: " << trainer.getTrainedAccuracy() << std::endl;
+    if (NeuralInstrumentation::isEnabled())
+    {
+        std::cout << trainer.getInstrumentation().toText();
+    }
 
 
     std::cout << "------------------End Valuation------------------" << std::endl;
@@ -0,0 +1,153 @@
+#ifndef NEURALARENA_H
+#define NEURALARENA_H
+
+#ifndef NEURALLAYER_H
+#include "neuralLayer.hpp"
+#endif
+
+#ifndef ALIGNEDALLOCATOR_H
+#include "alignedAllocator.hpp"
+#endif
+
+// #include <vector> // Sourced from neuron.hpp
+// #include <iostream> // Sourced from neuron.hpp
+
+/**
+ * This class carves the per sample buffers of a training pass (EX: the
+ * activations and the dC/dz deltas of every layer) out of one aligned
+ * allocation sized from the network topology.  Each layer holds one buffer
+ * per slot, every buffer one value per neuron and starting on an
+ * ADAM_ALIGNMENT boundary; the buffers of a layer sit next to each other so
+ * a layer's forward and backward state share cache lines and pages.
+ *
+ * The arena is shaped once per training run, when the topology is fixed, and
+ * keeps its storage between samples, so the forward and backward passes
+ * address it by index without ever touching the heap.  It is owned by one
+ * worker thread.
+ */
+template<typename T>
+class NeuralArenaT
+{
+public: // Public Members
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default - empty arena, must be shaped before use
+    NeuralArenaT();
+
+    /**
+     * Constructor shaped to the given network
+     *
+     * @param network - the layers to size the buffers to
+     * @param slots - the number of buffers per layer
+     */
+    NeuralArenaT(std::vector<NeuralLayerT<T>> *network, unsigned int slots);
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Default
+    ~NeuralArenaT();
+
+    /*********************** SETTERS ***********************************/
+
+    /**
+     * This method (re)shapes the arena to the given network and zeroes it.
+     * Storage is only reallocated if it has to grow.
+     *
+     * @param network - the layers to size the buffers to
+     * @param slots - the number of buffers per layer
+     */
+    void shape(std::vector<NeuralLayerT<T>> *network, unsigned int slots);
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns the number of layers in the arena
+     *
+     * @return - number of layers
+     */
+    unsigned int layerCount() const;
+
+    /**
+     * This returns the number of buffers per layer
+     *
+     * @return - number of slots
+     */
+    unsigned int slotCount() const;
+
+    /**
+     * This returns the number of values in each buffer of a layer
+     *
+     * @param layerIdx - the layer of interest
+     * @return - the neuron count of the layer
+     */
+    unsigned int getWidth(unsigned int layerIdx) const;
+
+    /**
+     * This returns the total number of values held, padding included
+     *
+     * @return - the element count of the arena
+     */
+    size_t size() const;
+
+    /**
+     * This returns one buffer of a layer
+     *
+     * @param slot - the buffer of interest
+     * @param layerIdx - the layer of interest
+     * @return - getWidth(layerIdx) values
+     */
+    T * buffer(unsigned int slot, unsigned int layerIdx);
+
+    /**
+     * This returns one buffer of a layer, read only
+     *
+     * @param slot - the buffer of interest
+     * @param layerIdx - the layer of interest
+     * @return - getWidth(layerIdx) values
+     */
+    const T * buffer(unsigned int slot, unsigned int layerIdx) const;
+
+private: // Private Members
+
+    /// All the buffers, layer after layer
+    AlignedVector<T> storage;
+
+    /// The offset of each buffer into storage (layerIdx * slots + slot)
+    std::vector<size_t> offsets;
+
+    /// The neuron count of each layer
+    std::vector<unsigned int> widths;
+
+    /// The number of buffers per layer - default: 0
+    unsigned int slots;
+
+private: // Private Methods
+
+};
+
+/*********************** INLINE ACCESSORS **************************/
+
+// Buffer
+template<typename T>
+inline T * NeuralArenaT<T>::buffer(unsigned int slot, unsigned int layerIdx)
+{
+    return this->storage.data() + this->offsets[(size_t)layerIdx * this->slots + slot];
+}
+
+// Buffer (read only)
+template<typename T>
+inline const T * NeuralArenaT<T>::buffer(unsigned int slot, unsigned int layerIdx) const
+{
+    return this->storage.data() + this->offsets[(size_t)layerIdx * this->slots + slot];
+}
+
+/// Double precision activation arena (reference)
+typedef NeuralArenaT<double> NeuralArena;
+
+/// Single precision activation arena
+typedef NeuralArenaT<float> NeuralArenaF;
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef NEURALCHECKPOINT_H
+#define NEURALCHECKPOINT_H
+
+#ifndef ALIGNEDALLOCATOR_H
+#include "alignedAllocator.hpp"
+#endif
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+/**
+ * This structure is everything a training loop needs to carry on exactly
+ * where it left off: the weights, the optimizer state, the cycle count, the
+ * generator, the shuffled row order and the convergence state
+ */
+template<typename T>
+struct NeuralSnapshotT
+{
+    /// Training cycles completed
+    unsigned int cycle;
+
+    /// Rows of the dataset the snapshot was taken over
+    unsigned int rowCount;
+
+    /// Consecutive cycles without enough loss improvement
+    unsigned int convergenceCount;
+
+    /// Lowest loss of the run so far
+    double bestLoss;
+
+    /// Mean training loss of the last cycle
+    double epochLoss;
+
+    /// Mean sampled blind loss of the last cycle
+    double blindLoss;
+
+    /// The optimizer the state belongs to
+    unsigned int optimizerType;
+
+    /// Optimizer steps applied (ADAM bias correction)
+    unsigned long optimizerSteps;
+
+    /// Neuron count, input count and weight stride of each layer
+    std::vector<unsigned int> shape;
+
+    /// Every layer weight matrix, back to back
+    AlignedVector<T> weights;
+
+    /// The optimizer state, as NeuralOptimizerT::getState
+    AlignedVector<T> optimizerState;
+
+    /// The training rows, in their current shuffled order
+    std::vector<int> indexes;
+
+    /// The blind rows sampled for the blind loss
+    std::vector<unsigned int> blindIndexes;
+
+    /// The serialized std::mt19937 of the trainer
+    std::string generatorState;
+};
+
+/**
+ * This class writes training snapshots to a checkpoint file on a background
+ * thread, so the training loop only pays for copying its state into memory.
+ *
+ * It is double buffered: while the writer saves one snapshot, the trainer
+ * fills the other.  If the trainer checkpoints again before the writer has
+ * picked up the last one, the waiting snapshot is overwritten rather than
+ * queued, so the loop never blocks on the disk and the file always receives
+ * the newest state.  Each file is written beside the target and renamed over
+ * it once complete, so a process killed mid-write leaves the previous
+ * checkpoint intact.
+ */
+template<typename T>
+class NeuralCheckpointT
+{
+public: // Public Members
+
+    /// The checkpoint file format version
+    const static unsigned int CHECKPOINT_VERSION = 1;
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /**
+     * Constructor with the checkpoint file.  An empty path disables the
+     * checkpoint, and no thread is started.
+     *
+     * @param path - the file to (over)write
+     */
+    NeuralCheckpointT(const std::string &path);
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Writes any waiting snapshot, then stops and joins the writer
+    ~NeuralCheckpointT();
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns if the checkpoint has a file to write
+     *
+     * @return - true - if snapshots are written
+     */
+    bool isEnabled() const;
+
+    /**
+     * This returns the number of snapshots written to disk so far
+     *
+     * @return - the written count
+     */
+    unsigned long getWrittenCount();
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This method hands out the buffer to fill with the next snapshot, the
+     * one the writer is not saving.  Its storage is reused between snapshots.
+     *
+     * @return - the buffer to fill, then publish()
+     */
+    NeuralSnapshotT<T> * acquire();
+
+    /**
+     * This method queues the acquired snapshot for the writer and returns
+     * straight away
+     */
+    void publish();
+
+    /**
+     * This method blocks until every published snapshot is on disk
+     */
+    void flush();
+
+    /**
+     * This method reads a checkpoint file
+     *
+     * @param path - the checkpoint file
+     * @param snapshot - receives the snapshot
+     * @return - false - if the file is missing or malformed
+     */
+    static bool read(const std::string &path, NeuralSnapshotT<T> *snapshot);
+
+private: // Private Members
+
+    /// The file snapshots are written to
+    std::string path;
+
+    /// The two snapshot buffers
+    NeuralSnapshotT<T> buffers[2];
+
+    /// The buffer being filled (-1 for none)
+    int filling;
+
+    /// The buffer waiting for the writer (-1 for none)
+    int pending;
+
+    /// The buffer being written (-1 for none)
+    int writing;
+
+    /// Snapshots written so far
+    unsigned long written;
+
+    /// Tells the writer to exit once nothing is pending
+    bool stopping;
+
+    /// Guards the members above
+    std::mutex checkpointMutex;
+
+    /// Signals the writer a snapshot is pending (or stop)
+    std::condition_variable snapshotPosted;
+
+    /// Signals flush() the writer went idle
+    std::condition_variable snapshotWritten;
+
+    /// The background writer
+    std::thread writer;
+
+private: // Private Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Copying a writer thread is not meaningful
+    NeuralCheckpointT(const NeuralCheckpointT &) = delete;
+
+    /// Copying a writer thread is not meaningful
+    NeuralCheckpointT & operator=(const NeuralCheckpointT &) = delete;
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /// This is the loop run by the writer thread
+    void writerLoop();
+
+    /**
+     * This method writes one snapshot to a file, replacing it atomically
+     *
+     * @param snapshot - the snapshot to write
+     * @return - false - if the file could not be written
+     */
+    bool write(const NeuralSnapshotT<T> &snapshot);
+
+};
+
+/// Double precision training checkpoint (reference)
+typedef NeuralCheckpointT<double> NeuralCheckpoint;
+
+/// Single precision training checkpoint
+typedef NeuralCheckpointT<float> NeuralCheckpointF;
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef NEURALCONTEXT_H
+#define NEURALCONTEXT_H
+
+#ifndef ALIGNEDALLOCATOR_H
+#include "alignedAllocator.hpp"
+#endif
+
+/**
+ * This class is the scratch space of one inference call: the activations
+ * passed between layers, and any input rows packed for a batch.  It is
+ * owned by the caller (EX: one per serving thread) and handed to the const
+ * NeuralNetwork::recall, so the network itself is never written during
+ * inference and one model can be shared by any number of threads, each with
+ * its own context.
+ *
+ * A context is not tied to a network.  It grows to the widest layer (times
+ * the batch chunk, for a batch recall) of the network it is used with and
+ * keeps that storage, so after the first call the pointer and view recall
+ * overloads allocate nothing.  The std::vector overloads still build the
+ * vector they return.  A context must not be used by two threads at the same
+ * time.
+ */
+template<typename T>
+class NeuralContextT
+{
+public: // Public Members
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default - empty, grows on first use
+    NeuralContextT();
+
+    /**
+     * Constructor reserving room for a given layer width
+     *
+     * @param width - the neuron count of the widest layer it will serve
+     */
+    NeuralContextT(unsigned int width);
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Default
+    ~NeuralContextT();
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns the widest layer the context can currently hold
+     *
+     * @return - the reserved layer width
+     */
+    unsigned int getWidth() const;
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This method grows the context to hold a layer of the given width.  It
+     * never shrinks.
+     *
+     * @param width - the neuron count of the widest layer
+     */
+    void reserve(unsigned int width);
+
+    /**
+     * This returns the buffer the next layer is to write its activations to
+     *
+     * @return - getWidth() values of scratch
+     */
+    T * next();
+
+    /**
+     * This returns a buffer of at least count values to pack input rows into
+     * (EX: the rows of a non-contiguous view for a batch recall).  It grows to
+     * fit and never shrinks; its contents are lost on the next call.
+     *
+     * @param count - the number of values needed
+     * @return - count values of scratch
+     */
+    T * stage(size_t count);
+
+private: // Private Members
+
+    /// Activations between layers, alternating between the two buffers
+    AlignedVector<T> front;
+
+    /// Activations between layers, alternating between the two buffers
+    AlignedVector<T> back;
+
+    /// Packed input rows of the current call
+    AlignedVector<T> staging;
+
+    /// The reserved layer width
+    unsigned int width;
+
+};
+
+/// Double precision inference context
+typedef NeuralContextT<double> NeuralContext;
+
+/// Single precision inference context
+typedef NeuralContextT<float> NeuralContextF;
+
+#endif
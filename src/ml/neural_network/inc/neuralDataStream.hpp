@@ -0,0 +1,243 @@
+#ifndef NEURALDATASTREAM_H
+#define NEURALDATASTREAM_H
+
+#ifndef ALIGNEDALLOCATOR_H
+#include "alignedAllocator.hpp"
+#endif
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <condition_variable>
+
+/**
+ * This structure is one block of parsed rows: the inputs and the truths of
+ * each row, back to back in contiguous row-major buffers
+ */
+template<typename T>
+struct NeuralDataBlockT
+{
+    /// rows * input count values
+    AlignedVector<T> inputs;
+
+    /// rows * truth count values
+    AlignedVector<T> truths;
+
+    /// The number of rows held
+    unsigned int rows;
+};
+
+/**
+ * This class streams a delimited text dataset (CSV, TSV, ...) from disk, so
+ * a dataset larger than memory can be trained on.  A background thread reads
+ * the file in large chunks and parses it into blocks of rows while the
+ * caller consumes the blocks before it, so parsing overlaps training.  Only
+ * a few blocks are in flight at a time, and consumed blocks are recycled,
+ * so memory use is fixed however large the file is.
+ *
+ * Each row is split on the delimiter and the configured columns (zero based)
+ * are picked out as the inputs and the truths, in the order given.  Other
+ * columns are ignored.  Rows with a missing or malformed configured column
+ * are skipped and counted.
+ *
+ * A pass over the file begins with rewind() and ends when nextBlock()
+ * returns false; each training cycle is one pass.
+ * @see NeuralNetworkTrainer::trainTestStream
+ */
+template<typename T>
+class NeuralDataStreamT
+{
+public: // Public Members
+
+    /// The number of rows per block
+    const static unsigned int BLOCK_ROWS = 4096;
+
+    /// The number of parsed blocks the reader may run ahead of the consumer
+    const static unsigned int QUEUE_DEPTH = 4;
+
+    /// The number of bytes read from the file at a time
+    const static unsigned int READ_CHUNK = 1 << 20;
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /**
+     * Constructor with the file and the column mapping.  Nothing is read
+     * until the first rewind().  An input column listed twice is reported
+     * and the stream will not rewind.
+     *
+     * @param path - the delimited text file
+     * @param inputColumns - the columns holding the inputs, in input order
+     * @param truthColumns - the columns holding the truths, in output order
+     * @param delimiter - the field separator (EX: ',' or '\t')
+     * @param header - true if the first line holds column names
+     */
+    NeuralDataStreamT(const std::string &path, const std::vector<unsigned int> &inputColumns,
+                      const std::vector<unsigned int> &truthColumns, char delimiter = ',', bool header = false);
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Stops and joins the reader
+    ~NeuralDataStreamT();
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns the number of inputs per row
+     *
+     * @return - the input column count
+     */
+    unsigned int getInputCount() const;
+
+    /**
+     * This returns the number of truths per row
+     *
+     * @return - the truth column count
+     */
+    unsigned int getTruthCount() const;
+
+    /**
+     * This returns the number of rows parsed so far in the current pass
+     *
+     * @return - rows parsed
+     */
+    unsigned long getRowCount();
+
+    /**
+     * This returns the number of malformed rows skipped so far in the current
+     * pass
+     *
+     * @return - rows skipped
+     */
+    unsigned long getSkippedRows();
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This method starts a pass from the first row, abandoning any pass in
+     * progress
+     *
+     * @return - true - if the file was opened and the reader started
+     * @return - false - if the file could not be opened or a column is mapped twice
+     */
+    bool rewind();
+
+    /**
+     * This method hands out the next block of the current pass, waiting for
+     * the reader if needed.  The block given in is recycled by the reader,
+     * so keep nothing pointing into it.
+     *
+     * @param block - receives the next block (its previous contents recycled)
+     * @return - true - if a block was given
+     * @return - false - if the pass is over (or was never started)
+     */
+    bool nextBlock(NeuralDataBlockT<T> *block);
+
+private: // Private Members
+
+    /// The delimited text file
+    std::string path;
+
+    /// The file of the current pass
+    std::ifstream file;
+
+    /// The number of inputs per row
+    unsigned int inputCount;
+
+    /// The number of truths per row
+    unsigned int truthCount;
+
+    /// Per column: the input slot (>= 0), the truth slot (-1 - slot), or unused (INT_MIN)
+    std::vector<int> columnSlots;
+
+    /// No input column was listed twice (otherwise the stream refuses to rewind)
+    bool mappingValid;
+
+    /// The field separator
+    char delimiter;
+
+    /// The first line holds column names
+    bool header;
+
+    /// The reader of the current pass
+    std::thread reader;
+
+    /// Guards the members below
+    std::mutex streamMutex;
+
+    /// Signals the consumer that a block is queued (or the pass is done)
+    std::condition_variable blockQueued;
+
+    /// Signals the reader that a block was taken (or to stop)
+    std::condition_variable blockTaken;
+
+    /// Parsed blocks waiting for the consumer
+    std::deque<NeuralDataBlockT<T>> queued;
+
+    /// Consumed blocks waiting for reuse
+    std::vector<NeuralDataBlockT<T>> spares;
+
+    /// The reader has queued the last block of the pass
+    bool passDone;
+
+    /// The reader is asked to abandon the pass
+    bool stopping;
+
+    /// Rows parsed in the current pass
+    unsigned long rowCount;
+
+    /// Malformed rows skipped in the current pass
+    unsigned long skippedRows;
+
+private: // Private Methods
+
+    /**
+     * This method stops the reader (if running) and recycles queued blocks
+     */
+    void stop();
+
+    /**
+     * This method is the reader thread body: one pass over the file
+     */
+    void readPass();
+
+    /**
+     * This method parses one line into the next row of the block
+     *
+     * @param begin - the first character of the line
+     * @param end - one past the last character (line break excluded)
+     * @param block - the block to append the row to
+     * @return - true - if the row was appended
+     * @return - false - if a configured column was missing or malformed
+     */
+    bool parseLine(const char *begin, const char *end, NeuralDataBlockT<T> *block);
+
+    /**
+     * This method queues a full (or final) block and returns a fresh one,
+     * waiting while the queue is full
+     *
+     * @param block - the block to queue, replaced by an empty block
+     * @param skipped - rows skipped while filling the block
+     * @return - false - if the reader was asked to stop
+     */
+    bool queueBlock(NeuralDataBlockT<T> *block, unsigned long skipped);
+
+};
+
+/// Double precision data block
+typedef NeuralDataBlockT<double> NeuralDataBlock;
+
+/// Single precision data block
+typedef NeuralDataBlockT<float> NeuralDataBlockF;
+
+/// Double precision data stream
+typedef NeuralDataStreamT<double> NeuralDataStream;
+
+/// Single precision data stream
+typedef NeuralDataStreamT<float> NeuralDataStreamF;
+
+#endif
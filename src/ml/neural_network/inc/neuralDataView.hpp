@@ -0,0 +1,161 @@
+#ifndef NEURALDATAVIEW_H
+#define NEURALDATAVIEW_H
+
+#include <cstddef>
+
+/**
+ * This class is a non-owning view of a table of samples (one sample per row)
+ * so datasets can be handed to the trainer and to batch recall without being
+ * copied.  The rows are either laid out in one row-major buffer with a fixed
+ * stride (EX: a memory mapped file, or a block of parsed rows), or found
+ * through a caller owned table of row pointers (EX: the rows of a
+ * std::vector<std::vector<T>>).
+ *
+ * The view never owns or frees anything; the caller keeps the data (and the
+ * row table) alive and unchanged while the view is in use.  It is small and
+ * meant to be passed around by value.
+ */
+template<typename T>
+class NeuralDataViewT
+{
+public: // Public Members
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default - an empty view
+    NeuralDataViewT()
+    {
+        this->data = nullptr;
+        this->rowTable = nullptr;
+        this->rows = 0;
+        this->cols = 0;
+        this->stride = 0;
+    }
+
+    /**
+     * Constructor over a row-major buffer
+     *
+     * @param data - the first value of the first row
+     * @param rows - the number of rows
+     * @param cols - the number of values per row
+     * @param stride - the distance between rows in values (0 - packed, stride = cols)
+     */
+    NeuralDataViewT(const T *data, unsigned int rows, unsigned int cols, size_t stride = 0): NeuralDataViewT()
+    {
+        this->data = data;
+        this->rows = rows;
+        this->cols = cols;
+        this->stride = (stride == 0) ? cols : stride;
+    }
+
+    /**
+     * Constructor over a table of row pointers
+     *
+     * @param rowTable - rows pointers, each to cols values
+     * @param rows - the number of rows
+     * @param cols - the number of values per row
+     */
+    NeuralDataViewT(const T *const *rowTable, unsigned int rows, unsigned int cols): NeuralDataViewT()
+    {
+        this->rowTable = rowTable;
+        this->rows = rows;
+        this->cols = cols;
+    }
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns the number of rows (samples) in the view
+     *
+     * @return - the row count
+     */
+    unsigned int getRowCount() const
+    {
+        return this->rows;
+    }
+
+    /**
+     * This returns the number of values per row
+     *
+     * @return - the column count
+     */
+    unsigned int getColumnCount() const
+    {
+        return this->cols;
+    }
+
+    /**
+     * This returns true if the rows are packed back to back in one buffer,
+     * so the view can be consumed as a single row-major block
+     *
+     * @return - true if contiguous
+     */
+    bool isContiguous() const
+    {
+        return !this->rowTable && this->stride == this->cols;
+    }
+
+    /**
+     * This returns a row of the view.  No bounds check is performed.
+     *
+     * @param rowIdx - the row to fetch
+     * @return - pointer to the cols values of the row
+     */
+    const T * row(unsigned int rowIdx) const
+    {
+        return this->rowTable ? this->rowTable[rowIdx] : this->data + rowIdx * this->stride;
+    }
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This returns a view of a run of rows of this view.  No bounds check is
+     * performed.
+     *
+     * @param first - the first row of the slice
+     * @param count - the number of rows in the slice
+     * @return - the sub view
+     */
+    NeuralDataViewT slice(unsigned int first, unsigned int count) const
+    {
+        NeuralDataViewT view(*this);
+        if (this->rowTable)
+        {
+            view.rowTable = this->rowTable + first;
+        }
+        else
+        {
+            view.data = this->data + first * this->stride;
+        }
+        view.rows = count;
+        return view;
+    }
+
+private: // Private Members
+
+    /// The first value of the first row (buffer views)
+    const T *data;
+
+    /// The row pointers (table views)
+    const T *const *rowTable;
+
+    /// The number of rows
+    unsigned int rows;
+
+    /// The number of values per row
+    unsigned int cols;
+
+    /// The distance between rows in values (buffer views)
+    size_t stride;
+
+};
+
+/// Double precision data view
+typedef NeuralDataViewT<double> NeuralDataView;
+
+/// Single precision data view
+typedef NeuralDataViewT<float> NeuralDataViewF;
+
+#endif
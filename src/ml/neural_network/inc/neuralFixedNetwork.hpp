@@ -0,0 +1,279 @@
+#ifndef NEURALFIXEDNETWORK_H
+#define NEURALFIXEDNETWORK_H
+
+#ifndef NEURALTYPES_H
+#include "neuralTypes.hpp"
+#endif
+
+#ifndef NEURALNETWORK_H
+#include "neuralNetwork.hpp"
+#endif
+
+#include <array>
+#include <cmath>
+#include <utility>
+// #include <iostream> // Sourced from neuron.hpp
+
+/**
+ * These templates form a frozen network whose topology is fixed at compile
+ * time, for tiny latency-critical models (EX: the 2-2-1 network in main.cpp).
+ *
+ * FixedNetwork<SIGMOID, 2, 2, 1> is a network of 2 inputs, a hidden layer of
+ * 2 neurons and 1 output.  All weights live in std::array members of one
+ * object (row-major per layer, bias first, as in NeuralLayer), the activation
+ * is resolved at compile time, and every loop is expanded from an index
+ * sequence, so recall is straight-line code with no allocation, validation
+ * or dispatch.  Every neuron uses the one activation.
+ *
+ * The network is filled from a trained NeuralNetwork of the same shape and
+ * activation; it is a snapshot and is not updated by further training.
+ */
+
+/*********************** ACTIVATION ********************************/
+
+/**
+ * The activation function, resolved at compile time
+ * @see NeuronT::activate for the runtime equivalent
+ *
+ * @param sum - the weighted sum (bias included)
+ * @return - the activation value
+ */
+template<NeuralActivationType Activation, typename T>
+inline T fixedActivate(T sum)
+{
+    if constexpr (Activation == NeuralActivationType::SWITCH)
+    {
+        return (sum > 0) ? 1 : 0;
+    }
+    else if constexpr (Activation == NeuralActivationType::SIGMOID)
+    {
+        return 1 / (1 + std::exp(-sum));
+    }
+    else if constexpr (Activation == NeuralActivationType::HYPERBOLIC_TANGENT)
+    {
+        return std::tanh(sum);
+    }
+    else if constexpr (Activation == NeuralActivationType::CATEGORICAL)
+    {
+        return std::floor(sum);
+    }
+    else
+    {
+        return sum;
+    }
+}
+
+/*********************** LAYERS ************************************/
+
+/**
+ * The layers of a fixed network, from a layer of In inputs onward.  Each
+ * step holds one layer and the rest of the network as a member, so the
+ * whole network is one contiguous object.
+ */
+template<typename T, NeuralActivationType Activation, unsigned int In, unsigned int... Rest>
+struct FixedLayers;
+
+/// The end of the network, its outputs are its inputs
+template<typename T, NeuralActivationType Activation, unsigned int In>
+struct FixedLayers<T, Activation, In>
+{
+    /// The number of network outputs
+    static constexpr unsigned int OUTPUTS = In;
+
+    // Load (nothing left to load)
+    bool load(NeuralNetworkT<T> *, unsigned int)
+    {
+        return true;
+    }
+
+    // Recall (hand the last activations out)
+    inline void recall(const std::array<T, In> &inputs, std::array<T, In> &outputs) const
+    {
+        outputs = inputs;
+    }
+};
+
+/// One layer of Out neurons over In inputs, followed by the rest
+template<typename T, NeuralActivationType Activation, unsigned int In, unsigned int Out, unsigned int... Rest>
+struct FixedLayers<T, Activation, In, Out, Rest...>
+{
+    /// The layers after this one
+    typedef FixedLayers<T, Activation, Out, Rest...> Next;
+
+    /// The number of network outputs
+    static constexpr unsigned int OUTPUTS = Next::OUTPUTS;
+
+    /// Row-major weights, row n is the bias of neuron n then its In weights
+    std::array<T, Out * (In + 1)> weights;
+
+    /// The rest of the network
+    Next next;
+
+    // Load the weights of this and the following layers
+    bool load(NeuralNetworkT<T> *network, unsigned int layerIdx)
+    {
+        NeuralLayerT<T> *layer = network->getLayer(layerIdx);
+        if (!layer || layer->getInputCount() != In || layer->neuronCount() != Out)
+        {
+            std::cout << "Error: layer " << layerIdx << " does not match the fixed topology" << std::endl;
+            return false;
+        }
+
+        const T *matrix = layer->getWeightMatrix();
+        for (unsigned int neuronIdx = 0; neuronIdx < Out; neuronIdx++)
+        {
+            if (layer->getActivationTypes()[neuronIdx] != Activation)
+            {
+                std::cout << "Error: layer " << layerIdx << " has a neuron of another activation type" << std::endl;
+                return false;
+            }
+            const T *row = matrix + (size_t)neuronIdx * layer->getWeightStride();
+            std::copy(row, row + In + 1, this->weights.begin() + (size_t)neuronIdx * (In + 1));
+        }
+        return this->next.load(network, layerIdx + 1);
+    }
+
+    // Recall through this and the following layers
+    inline void recall(const std::array<T, In> &inputs, std::array<T, OUTPUTS> &outputs) const
+    {
+        std::array<T, Out> activations;
+        this->fire(inputs, activations, std::make_integer_sequence<unsigned int, Out>());
+        this->next.recall(activations, outputs);
+    }
+
+    // Every neuron of the layer
+    template<unsigned int... Neuron>
+    inline void fire(const std::array<T, In> &inputs, std::array<T, Out> &activations,
+                     std::integer_sequence<unsigned int, Neuron...>) const
+    {
+        ((activations[Neuron] = fixedActivate<Activation>(
+              this->sum<Neuron>(inputs, std::make_integer_sequence<unsigned int, In>()))), ...);
+    }
+
+    // The weighted sum of one neuron, bias first
+    template<unsigned int Neuron, unsigned int... Input>
+    inline T sum(const std::array<T, In> &inputs, std::integer_sequence<unsigned int, Input...>) const
+    {
+        return (this->weights[Neuron * (In + 1)] + ... + (this->weights[Neuron * (In + 1) + 1 + Input] * inputs[Input]));
+    }
+};
+
+/*********************** NETWORK ***********************************/
+
+/**
+ * A fixed topology network of scalar T and a single activation function.
+ * Sizes lists the input count followed by the neuron count of each layer.
+ */
+template<typename T, NeuralActivationType Activation, unsigned int... Sizes>
+class FixedNetworkT
+{
+    static_assert(sizeof...(Sizes) >= 2, "a fixed network needs an input size and at least one layer");
+
+public: // Public Members
+
+    /// The number of network inputs
+    static constexpr unsigned int INPUTS = std::array<unsigned int, sizeof...(Sizes)>{Sizes...}[0];
+
+    /// The number of network outputs
+    static constexpr unsigned int OUTPUTS = FixedLayers<T, Activation, Sizes...>::OUTPUTS;
+
+    /// The number of layers
+    static constexpr unsigned int LAYERS = sizeof...(Sizes) - 1;
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default - zero weights, must be loaded before use
+    FixedNetworkT()
+    {
+        this->initialized = false;
+        this->layers = FixedLayers<T, Activation, Sizes...>();
+    }
+
+    /**
+     * Constructor taking the weights of a trained network
+     * @see load
+     *
+     * @param network - the trained network (same shape and activation)
+     */
+    FixedNetworkT(NeuralNetworkT<T> *network): FixedNetworkT()
+    {
+        this->load(network);
+    }
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This is the internal mechanism to identify if the network was loaded
+     *
+     * @return - true - if the weights were loaded
+     * @return - false - if not loaded / the load failed
+     */
+    bool isInitialized() const
+    {
+        return this->initialized;
+    }
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This method copies the weights of a trained network.  The network must
+     * have exactly the fixed shape, and every neuron the fixed activation.
+     *
+     * @param network - the trained network
+     * @return - true - if the weights were loaded
+     * @return - false - if the network does not match (weights left unchanged)
+     */
+    bool load(NeuralNetworkT<T> *network)
+    {
+        if (!network || network->layerCount() != LAYERS)
+        {
+            std::cout << "Error: network layer count does not match the fixed topology" << std::endl;
+            return false;
+        }
+
+        // Load into a copy, so a mismatch part way leaves this untouched
+        FixedLayers<T, Activation, Sizes...> loaded = this->layers;
+        if (!loaded.load(network, 0))
+        {
+            return false;
+        }
+        this->layers = loaded;
+        this->initialized = true;
+        return true;
+    }
+
+    /**
+     * This method feeds the inputs through the network.  No validation is
+     * performed and nothing is allocated.
+     *
+     * @param inputs - the network inputs
+     * @return - the network outputs
+     */
+    inline std::array<T, OUTPUTS> recall(const std::array<T, INPUTS> &inputs) const
+    {
+        std::array<T, OUTPUTS> outputs;
+        this->layers.recall(inputs, outputs);
+        return outputs;
+    }
+
+private: // Private Members
+
+    /// The layers, input to output
+    FixedLayers<T, Activation, Sizes...> layers;
+
+    /// Valuation of if the weights were loaded - default: false
+    bool initialized;
+
+};
+
+/// Double precision fixed network
+template<NeuralActivationType Activation, unsigned int... Sizes>
+using FixedNetwork = FixedNetworkT<double, Activation, Sizes...>;
+
+/// Single precision fixed network
+template<NeuralActivationType Activation, unsigned int... Sizes>
+using FixedNetworkF = FixedNetworkT<float, Activation, Sizes...>;
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef NEURALGRADIENT_H
+#define NEURALGRADIENT_H
+
+#ifndef NEURALLAYER_H
+#include "neuralLayer.hpp"
+#endif
+
+#ifndef ALIGNEDALLOCATOR_H
+#include "alignedAllocator.hpp"
+#endif
+
+// #include <vector> // Sourced from neuron.hpp
+// #include <iostream> // Sourced from neuron.hpp
+
+/**
+ * This class holds the cost gradient of a network, laid out to mirror the
+ * network shape.  Each layer has a contiguous row-major gradient matrix with
+ * the same stride as the layer's weight matrix: row n is the gradient of
+ * neuron n, with the bias gradient in column 0 followed by one weight
+ * gradient per input.
+ *
+ * All layers live in one aligned allocation that is sized once (typically
+ * per training run) and zeroed in place between mini-batches, so the
+ * backward pass can write into it by index without allocating.
+ */
+template<typename T>
+class NeuralGradientT
+{
+public: // Public Members
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default - empty gradient, must be shaped before use
+    NeuralGradientT();
+
+    /**
+     * Constructor shaped to mirror the given network
+     *
+     * @param network - the layers to mirror
+     */
+    NeuralGradientT(std::vector<NeuralLayerT<T>> *network);
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Default
+    ~NeuralGradientT();
+
+    /*********************** SETTERS ***********************************/
+
+    /**
+     * This method (re)shapes the gradient to mirror the given network and
+     * zeroes it.  Storage is only reallocated if the size changed.
+     *
+     * @param network - the layers to mirror
+     */
+    void shape(std::vector<NeuralLayerT<T>> *network);
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns the number of layers in the gradient
+     *
+     * @return - number of layers
+     */
+    unsigned int layerCount() const;
+
+    /**
+     * This returns the gradient matrix of a layer.  Row n starts at
+     * (n * getStride(layerIdx)), with the bias gradient in column 0.
+     *
+     * @param layerIdx - the layer of interest
+     * @return - pointer to the first element of the layer gradient
+     */
+    T * getLayerGradient(unsigned int layerIdx);
+
+    /**
+     * This returns the row stride of a layer gradient (matches the layer)
+     *
+     * @param layerIdx - the layer of interest
+     * @return - the row stride in elements
+     */
+    unsigned int getStride(unsigned int layerIdx) const;
+
+    /**
+     * This returns the number of elements in a layer gradient, padding
+     * included (neuronCount * stride)
+     *
+     * @param layerIdx - the layer of interest
+     * @return - the element count of the layer gradient
+     */
+    size_t getLayerSize(unsigned int layerIdx) const;
+
+    /**
+     * This returns the bias gradient of a neuron
+     *
+     * @param layerIdx - the layer of the neuron
+     * @param neuronIdx - the neuron in the layer
+     * @return - reference to the bias gradient
+     */
+    T & bias(unsigned int layerIdx, unsigned int neuronIdx);
+
+    /**
+     * This returns the gradient of one input weight of a neuron
+     *
+     * @param layerIdx - the layer of the neuron
+     * @param neuronIdx - the neuron in the layer
+     * @param inputIdx - the input of the neuron
+     * @return - reference to the weight gradient
+     */
+    T & weight(unsigned int layerIdx, unsigned int neuronIdx, unsigned int inputIdx);
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /// This method zeroes the gradient in place
+    void reset();
+
+    /**
+     * This method adds another gradient of the same shape into this one
+     *
+     * @param other - the gradient to sum in
+     */
+    void accumulate(const NeuralGradientT &other);
+
+private: // Private Members
+
+    /// All the layer gradients, back to back
+    AlignedVector<T> gradients;
+
+    /// The offset of each layer into gradients
+    std::vector<size_t> offsets;
+
+    /// The row stride of each layer
+    std::vector<unsigned int> strides;
+
+    /// The neuron count of each layer
+    std::vector<unsigned int> neuronCounts;
+
+private: // Private Methods
+
+};
+
+/*********************** INLINE ACCESSORS **************************/
+
+// Bias Gradient
+template<typename T>
+inline T & NeuralGradientT<T>::bias(unsigned int layerIdx, unsigned int neuronIdx)
+{
+    return this->gradients[this->offsets[layerIdx] + (size_t)neuronIdx * this->strides[layerIdx]];
+}
+
+// Weight Gradient
+template<typename T>
+inline T & NeuralGradientT<T>::weight(unsigned int layerIdx, unsigned int neuronIdx, unsigned int inputIdx)
+{
+    return this->gradients[this->offsets[layerIdx] + (size_t)neuronIdx * this->strides[layerIdx] + inputIdx + 1];
+}
+
+/// Double precision network gradient (reference)
+typedef NeuralGradientT<double> NeuralGradient;
+
+/// Single precision network gradient
+typedef NeuralGradientT<float> NeuralGradientF;
+
+#endif
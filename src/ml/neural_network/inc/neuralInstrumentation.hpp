@@ -0,0 +1,226 @@
+#ifndef NEURALINSTRUMENTATION_H
+#define NEURALINSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Runs the statement only in instrumented builds (compiled with
+ * -DADAM_INSTRUMENTATION, EX: make ADAM_INSTRUMENTATION=1).  Otherwise the
+ * statement, clock reads included, is compiled out entirely.
+ */
+#ifdef ADAM_INSTRUMENTATION
+#define ADAM_INSTRUMENT(...) __VA_ARGS__
+#else
+#define ADAM_INSTRUMENT(...)
+#endif
+
+/**
+ * This structure is a snapshot of the totals of one layer
+ */
+struct NeuralLayerTiming
+{
+    /// Time spent in the forward pass (recall and training)
+    uint64_t forwardNs;
+
+    /// Samples run forward
+    uint64_t forwardSamples;
+
+    /// Time spent in the backward pass
+    uint64_t backwardNs;
+
+    /// Samples run backward
+    uint64_t backwardSamples;
+
+    /// Time spent applying weight updates
+    uint64_t updateNs;
+
+    /// Weight updates applied
+    uint64_t updates;
+};
+
+/**
+ * This class accumulates per layer hot path timings and counters for a
+ * network: forward, backward and weight update time, and the samples /
+ * updates they covered.  The network and the trainer record into it only in
+ * instrumented builds @see ADAM_INSTRUMENT, so slow training can be pinned
+ * on the forward pass, the backward pass or the update without a profiler.
+ *
+ * Times are read from the steady clock (a vDSO read of the TSC on Linux),
+ * and totals are relaxed atomics, so recording is safe from any number of
+ * worker threads.  Workers share the counters of a layer, so small networks
+ * trained on many threads pay for it in cache line traffic; this is a
+ * diagnostic build.
+ */
+class NeuralInstrumentation
+{
+public: // Public Members
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default - no layers
+    NeuralInstrumentation();
+
+    /// Copy - copies the current totals
+    NeuralInstrumentation(const NeuralInstrumentation &other);
+
+    /// Copy assignment - copies the current totals
+    NeuralInstrumentation & operator=(const NeuralInstrumentation &other);
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Default
+    ~NeuralInstrumentation();
+
+    /*********************** SETTERS ***********************************/
+
+    /**
+     * This method sizes the totals to the layers of a network and zeroes
+     * them.  Not safe against concurrent recording.
+     *
+     * @param layerCount - the number of layers
+     */
+    void shape(unsigned int layerCount);
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns true if the build records (ADAM_INSTRUMENTATION defined)
+     *
+     * @return - true if instrumented
+     */
+    static bool isEnabled();
+
+    /**
+     * This returns a steady clock reading for timing a section
+     *
+     * @return - nanoseconds since an arbitrary epoch
+     */
+    static uint64_t now();
+
+    /**
+     * This returns the number of layers tracked
+     *
+     * @return - the layer count
+     */
+    unsigned int layerCount() const;
+
+    /**
+     * This returns a copy of the per layer totals
+     *
+     * @return - one entry per layer
+     */
+    std::vector<NeuralLayerTiming> snapshot() const;
+
+    /**
+     * This returns the totals as a text table
+     *
+     * @return - the table, one row per layer
+     */
+    std::string toText() const;
+
+    /**
+     * This returns the totals as a JSON object
+     *
+     * @return - {"enabled": ..., "layers": [...]}
+     */
+    std::string toJson() const;
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /// This method zeroes the totals in place
+    void reset();
+
+    /**
+     * This method adds forward pass time of a layer
+     *
+     * @param layerIdx - the layer (ignored if not tracked)
+     * @param ns - the time spent
+     * @param samples - the samples covered
+     */
+    void recordForward(unsigned int layerIdx, uint64_t ns, uint64_t samples);
+
+    /**
+     * This method adds backward pass time of a layer
+     *
+     * @param layerIdx - the layer (ignored if not tracked)
+     * @param ns - the time spent
+     * @param samples - the samples covered
+     */
+    void recordBackward(unsigned int layerIdx, uint64_t ns, uint64_t samples);
+
+    /**
+     * This method adds weight update time of a layer
+     *
+     * @param layerIdx - the layer (ignored if not tracked)
+     * @param ns - the time spent
+     */
+    void recordUpdate(unsigned int layerIdx, uint64_t ns);
+
+private: // Private Members
+
+    /// The totals of one layer, on a cache line of its own
+    struct alignas(64) LayerCounters
+    {
+        std::atomic<uint64_t> forwardNs;
+        std::atomic<uint64_t> forwardSamples;
+        std::atomic<uint64_t> backwardNs;
+        std::atomic<uint64_t> backwardSamples;
+        std::atomic<uint64_t> updateNs;
+        std::atomic<uint64_t> updates;
+    };
+
+    /// The totals of each layer
+    std::unique_ptr<LayerCounters[]> counters;
+
+    /// The number of layers tracked
+    unsigned int layers;
+
+};
+
+/*********************** INLINE FUNCTIONS **************************/
+
+// Now
+inline uint64_t NeuralInstrumentation::now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Record Forward
+inline void NeuralInstrumentation::recordForward(unsigned int layerIdx, uint64_t ns, uint64_t samples)
+{
+    if (layerIdx < this->layers)
+    {
+        this->counters[layerIdx].forwardNs.fetch_add(ns, std::memory_order_relaxed);
+        this->counters[layerIdx].forwardSamples.fetch_add(samples, std::memory_order_relaxed);
+    }
+}
+
+// Record Backward
+inline void NeuralInstrumentation::recordBackward(unsigned int layerIdx, uint64_t ns, uint64_t samples)
+{
+    if (layerIdx < this->layers)
+    {
+        this->counters[layerIdx].backwardNs.fetch_add(ns, std::memory_order_relaxed);
+        this->counters[layerIdx].backwardSamples.fetch_add(samples, std::memory_order_relaxed);
+    }
+}
+
+// Record Update
+inline void NeuralInstrumentation::recordUpdate(unsigned int layerIdx, uint64_t ns)
+{
+    if (layerIdx < this->layers)
+    {
+        this->counters[layerIdx].updateNs.fetch_add(ns, std::memory_order_relaxed);
+        this->counters[layerIdx].updates.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+#endif
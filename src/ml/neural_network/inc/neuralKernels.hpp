@@ -0,0 +1,428 @@
+#ifndef NEURALKERNELS_H
+#define NEURALKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * This class houses the vectorized numeric kernels behind the neuron, layer
+ * and trainer hot loops.  Each kernel has a scalar, SSE2, AVX2/FMA and
+ * AVX-512 implementation; the widest one the processor supports is selected
+ * once at startup (via CPUID) and called through a function pointer.  Every
+ * kernel is provided in single and double precision, the float variants
+ * carrying twice the lanes per register.  An int8 dot product with int32
+ * accumulation serves quantized inference, fused per-weight update steps
+ * serve the trainer's optimizers (see NeuralOptimizer), and the sigmoid /
+ * hyperbolic tangent kernels activate a whole layer at a time.
+ *
+ * The reductions keep several independent accumulators per call so that the
+ * loop is bound by load / FMA throughput, not by the add latency chain.  As a
+ * consequence sums are associated differently than a plain left-to-right
+ * loop, and may differ from it in the last bits.
+ */
+class NeuralKernels
+{
+public: // Public Members
+
+    /// Signature of the dot product kernel
+    typedef double (*DotKernel)(const double *a, const double *b, unsigned int n);
+
+    /// Signature of the one row against four vectors dot product kernel
+    typedef void (*Dot4Kernel)(const double *w, const double *x0, const double *x1,
+                               const double *x2, const double *x3, unsigned int n, double *sums);
+
+    /// Signature of the y += alpha * x kernel
+    typedef void (*AxpyKernel)(double alpha, const double *x, double *y, unsigned int n);
+
+    /// Signature of the single precision dot product kernel
+    typedef float (*DotKernelF)(const float *a, const float *b, unsigned int n);
+
+    /// Signature of the single precision one row against four vectors dot product kernel
+    typedef void (*Dot4KernelF)(const float *w, const float *x0, const float *x1,
+                                const float *x2, const float *x3, unsigned int n, float *sums);
+
+    /// Signature of the single precision y += alpha * x kernel
+    typedef void (*AxpyKernelF)(float alpha, const float *x, float *y, unsigned int n);
+
+    /// Signature of the int8 dot product kernel (int32 accumulation)
+    typedef int32_t (*DotKernelI8)(const int8_t *a, const int8_t *b, unsigned int n);
+
+    /// Signature of the momentum update kernel
+    typedef void (*MomentumKernel)(double *w, double *velocity, const double *g, unsigned int n,
+                                   double scale, double rate, double momentum, bool nesterov);
+
+    /// Signature of the RMSProp update kernel
+    typedef void (*RmspropKernel)(double *w, double *meanSquare, const double *g, unsigned int n,
+                                  double scale, double rate, double decay, double epsilon);
+
+    /// Signature of the Adam update kernel
+    typedef void (*AdamKernel)(double *w, double *m, double *v, const double *g, unsigned int n,
+                               double scale, double rate, double beta1, double beta2, double epsilon);
+
+    /// Signature of the single precision momentum update kernel
+    typedef void (*MomentumKernelF)(float *w, float *velocity, const float *g, unsigned int n,
+                                    float scale, float rate, float momentum, bool nesterov);
+
+    /// Signature of the single precision RMSProp update kernel
+    typedef void (*RmspropKernelF)(float *w, float *meanSquare, const float *g, unsigned int n,
+                                   float scale, float rate, float decay, float epsilon);
+
+    /// Signature of the single precision Adam update kernel
+    typedef void (*AdamKernelF)(float *w, float *m, float *v, const float *g, unsigned int n,
+                                float scale, float rate, float beta1, float beta2, float epsilon);
+
+    /// Signature of the activation kernels
+    typedef void (*ActivationKernel)(const double *x, double *y, unsigned int n, bool fast);
+
+    /// Signature of the single precision activation kernels
+    typedef void (*ActivationKernelF)(const float *x, float *y, unsigned int n, bool fast);
+
+public: // Public Methods
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns the name of the instruction set the kernels dispatch to
+     *
+     * @return - "AVX-512", "AVX2", "SSE2" or "SCALAR"
+     */
+    static const char * getInstructionSet();
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * Dot product of two contiguous vectors
+     *
+     * @param a - first vector of n values
+     * @param b - second vector of n values
+     * @param n - the number of values
+     * @return - sum of a[i] * b[i]
+     */
+    static double dot(const double *a, const double *b, unsigned int n);
+
+    /**
+     * Dot product of one vector against four others, so every load of w is
+     * shared by four sums (the batched forward pass micro-kernel)
+     *
+     * @param w - the shared vector of n values (a weight row)
+     * @param x0 - first vector of n values
+     * @param x1 - second vector of n values
+     * @param x2 - third vector of n values
+     * @param x3 - fourth vector of n values
+     * @param n - the number of values
+     * @param sums - receives the four dot products
+     */
+    static void dot4(const double *w, const double *x0, const double *x1,
+                     const double *x2, const double *x3, unsigned int n, double *sums);
+
+    /**
+     * Scaled vector addition, y += alpha * x
+     *
+     * @param alpha - the scale applied to x
+     * @param x - the vector of n values to add
+     * @param y - the vector of n values to add into
+     * @param n - the number of values
+     */
+    static void axpy(double alpha, const double *x, double *y, unsigned int n);
+
+    /// Dot product of two contiguous vectors (single precision)
+    static float dot(const float *a, const float *b, unsigned int n);
+
+    /// Dot product of one vector against four others (single precision)
+    static void dot4(const float *w, const float *x0, const float *x1,
+                     const float *x2, const float *x3, unsigned int n, float *sums);
+
+    /// Scaled vector addition, y += alpha * x (single precision)
+    static void axpy(float alpha, const float *x, float *y, unsigned int n);
+
+    /**
+     * Dot product of two int8 vectors, accumulated in int32.  Values are
+     * expected in [-127, 127] (symmetric quantization) so that the paired
+     * 16 bit products cannot overflow.
+     *
+     * @param a - first vector of n values
+     * @param b - second vector of n values
+     * @param n - the number of values
+     * @return - sum of a[i] * b[i]
+     */
+    static int32_t dot(const int8_t *a, const int8_t *b, unsigned int n);
+
+    /**
+     * Momentum update step, in one pass over the weights.  With gi = scale * g[i]:
+     * velocity = momentum * velocity + gi, then w -= rate * velocity (heavy
+     * ball), or w -= rate * (gi + momentum * velocity) (Nesterov look ahead)
+     *
+     * @param w - the n weights to update
+     * @param velocity - the n velocities, updated
+     * @param g - the n summed gradients
+     * @param n - the number of values
+     * @param scale - applied to the gradient (EX: 1 / batch size)
+     * @param rate - the learning rate
+     * @param momentum - the velocity decay, [0, 1)
+     * @param nesterov - true for the Nesterov variant
+     */
+    static void momentumStep(double *w, double *velocity, const double *g, unsigned int n,
+                             double scale, double rate, double momentum, bool nesterov);
+
+    /**
+     * RMSProp update step, in one pass over the weights.  With gi = scale * g[i]:
+     * meanSquare = decay * meanSquare + (1 - decay) * gi^2, then
+     * w -= rate * gi / (sqrt(meanSquare) + epsilon)
+     *
+     * @param w - the n weights to update
+     * @param meanSquare - the n running mean squared gradients, updated
+     * @param g - the n summed gradients
+     * @param n - the number of values
+     * @param scale - applied to the gradient (EX: 1 / batch size)
+     * @param rate - the learning rate
+     * @param decay - the running mean decay, [0, 1)
+     * @param epsilon - keeps the denominator from zero
+     */
+    static void rmspropStep(double *w, double *meanSquare, const double *g, unsigned int n,
+                            double scale, double rate, double decay, double epsilon);
+
+    /**
+     * Adam update step, in one pass over the weights.  With gi = scale * g[i]:
+     * m = beta1 * m + (1 - beta1) * gi, v = beta2 * v + (1 - beta2) * gi^2,
+     * then w -= rate * m / (sqrt(v) + epsilon).  The bias correction of both
+     * moments is expected to be folded into rate by the caller.
+     *
+     * @param w - the n weights to update
+     * @param m - the n first moments, updated
+     * @param v - the n second moments, updated
+     * @param g - the n summed gradients
+     * @param n - the number of values
+     * @param scale - applied to the gradient (EX: 1 / batch size)
+     * @param rate - the (bias corrected) learning rate
+     * @param beta1 - the first moment decay, [0, 1)
+     * @param beta2 - the second moment decay, [0, 1)
+     * @param epsilon - keeps the denominator from zero
+     */
+    static void adamStep(double *w, double *m, double *v, const double *g, unsigned int n,
+                         double scale, double rate, double beta1, double beta2, double epsilon);
+
+    /// Momentum update step (single precision)
+    static void momentumStep(float *w, float *velocity, const float *g, unsigned int n,
+                             float scale, float rate, float momentum, bool nesterov);
+
+    /// RMSProp update step (single precision)
+    static void rmspropStep(float *w, float *meanSquare, const float *g, unsigned int n,
+                            float scale, float rate, float decay, float epsilon);
+
+    /// Adam update step (single precision)
+    static void adamStep(float *w, float *m, float *v, const float *g, unsigned int n,
+                         float scale, float rate, float beta1, float beta2, float epsilon);
+
+    /**
+     * Sigmoid of every value, y = 1 / (1 + exp(-x)).  The exponential is
+     * range reduced to 2^k * exp(r), |r| <= ln2 / 2, and exp(r) taken from a
+     * Taylor polynomial: degree 13 (7 in single precision) when exact, within
+     * a few ULP of libm, or degree 5 when fast, within about 1e-5 relative.
+     * Every value is computed alike, the tail included, so a result does not
+     * depend on its position.  x and y may be the same buffer.
+     *
+     * @param x - the n values to activate (EX: a layer's weighted sums)
+     * @param y - receives the n activations
+     * @param n - the number of values
+     * @param fast - true for the low degree approximation
+     */
+    static void sigmoid(const double *x, double *y, unsigned int n, bool fast);
+
+    /**
+     * Hyperbolic tangent of every value, y = expm1(2|x|) / (expm1(2|x|) + 2)
+     * with the sign of x, on the same exponential as sigmoid (and the same
+     * accuracy).  x and y may be the same buffer.
+     *
+     * @param x - the n values to activate
+     * @param y - receives the n activations
+     * @param n - the number of values
+     * @param fast - true for the low degree approximation
+     */
+    static void hyperbolicTangent(const double *x, double *y, unsigned int n, bool fast);
+
+    /// Sigmoid of every value (single precision)
+    static void sigmoid(const float *x, float *y, unsigned int n, bool fast);
+
+    /// Hyperbolic tangent of every value (single precision)
+    static void hyperbolicTangent(const float *x, float *y, unsigned int n, bool fast);
+
+    /**
+     * This method selects the kernels for the running processor.  It is run
+     * automatically at startup, and is safe to call again.  The environment
+     * variable ADAM_KERNELS (SCALAR, SSE2 or AVX2) caps the selection.
+     */
+    static void select();
+
+private: // Private Members
+
+    /// The selected dot product kernel
+    static DotKernel dotKernel;
+
+    /// The selected one against four dot product kernel
+    static Dot4Kernel dot4Kernel;
+
+    /// The selected axpy kernel
+    static AxpyKernel axpyKernel;
+
+    /// The selected single precision dot product kernel
+    static DotKernelF dotKernelF;
+
+    /// The selected single precision one against four dot product kernel
+    static Dot4KernelF dot4KernelF;
+
+    /// The selected single precision axpy kernel
+    static AxpyKernelF axpyKernelF;
+
+    /// The selected int8 dot product kernel
+    static DotKernelI8 dotKernelI8;
+
+    /// The selected momentum update kernel
+    static MomentumKernel momentumKernel;
+
+    /// The selected RMSProp update kernel
+    static RmspropKernel rmspropKernel;
+
+    /// The selected Adam update kernel
+    static AdamKernel adamKernel;
+
+    /// The selected single precision momentum update kernel
+    static MomentumKernelF momentumKernelF;
+
+    /// The selected single precision RMSProp update kernel
+    static RmspropKernelF rmspropKernelF;
+
+    /// The selected single precision Adam update kernel
+    static AdamKernelF adamKernelF;
+
+    /// The selected sigmoid kernel
+    static ActivationKernel sigmoidKernel;
+
+    /// The selected hyperbolic tangent kernel
+    static ActivationKernel tanhKernel;
+
+    /// The selected single precision sigmoid kernel
+    static ActivationKernelF sigmoidKernelF;
+
+    /// The selected single precision hyperbolic tangent kernel
+    static ActivationKernelF tanhKernelF;
+
+    /// Name of the selected instruction set
+    static const char *instructionSet;
+
+private: // Private Methods
+
+};
+
+/*********************** INLINE DISPATCH ***************************/
+
+// Dot Product
+inline double NeuralKernels::dot(const double *a, const double *b, unsigned int n)
+{
+    return NeuralKernels::dotKernel(a, b, n);
+}
+
+// Dot Product (one against four)
+inline void NeuralKernels::dot4(const double *w, const double *x0, const double *x1,
+                                const double *x2, const double *x3, unsigned int n, double *sums)
+{
+    NeuralKernels::dot4Kernel(w, x0, x1, x2, x3, n, sums);
+}
+
+// Axpy
+inline void NeuralKernels::axpy(double alpha, const double *x, double *y, unsigned int n)
+{
+    NeuralKernels::axpyKernel(alpha, x, y, n);
+}
+
+// Dot Product (single precision)
+inline float NeuralKernels::dot(const float *a, const float *b, unsigned int n)
+{
+    return NeuralKernels::dotKernelF(a, b, n);
+}
+
+// Dot Product (one against four, single precision)
+inline void NeuralKernels::dot4(const float *w, const float *x0, const float *x1,
+                                const float *x2, const float *x3, unsigned int n, float *sums)
+{
+    NeuralKernels::dot4KernelF(w, x0, x1, x2, x3, n, sums);
+}
+
+// Axpy (single precision)
+inline void NeuralKernels::axpy(float alpha, const float *x, float *y, unsigned int n)
+{
+    NeuralKernels::axpyKernelF(alpha, x, y, n);
+}
+
+// Dot Product (int8)
+inline int32_t NeuralKernels::dot(const int8_t *a, const int8_t *b, unsigned int n)
+{
+    return NeuralKernels::dotKernelI8(a, b, n);
+}
+
+// Momentum Step
+inline void NeuralKernels::momentumStep(double *w, double *velocity, const double *g, unsigned int n,
+                                        double scale, double rate, double momentum, bool nesterov)
+{
+    NeuralKernels::momentumKernel(w, velocity, g, n, scale, rate, momentum, nesterov);
+}
+
+// RMSProp Step
+inline void NeuralKernels::rmspropStep(double *w, double *meanSquare, const double *g, unsigned int n,
+                                       double scale, double rate, double decay, double epsilon)
+{
+    NeuralKernels::rmspropKernel(w, meanSquare, g, n, scale, rate, decay, epsilon);
+}
+
+// Adam Step
+inline void NeuralKernels::adamStep(double *w, double *m, double *v, const double *g, unsigned int n,
+                                    double scale, double rate, double beta1, double beta2, double epsilon)
+{
+    NeuralKernels::adamKernel(w, m, v, g, n, scale, rate, beta1, beta2, epsilon);
+}
+
+// Momentum Step (single precision)
+inline void NeuralKernels::momentumStep(float *w, float *velocity, const float *g, unsigned int n,
+                                        float scale, float rate, float momentum, bool nesterov)
+{
+    NeuralKernels::momentumKernelF(w, velocity, g, n, scale, rate, momentum, nesterov);
+}
+
+// RMSProp Step (single precision)
+inline void NeuralKernels::rmspropStep(float *w, float *meanSquare, const float *g, unsigned int n,
+                                       float scale, float rate, float decay, float epsilon)
+{
+    NeuralKernels::rmspropKernelF(w, meanSquare, g, n, scale, rate, decay, epsilon);
+}
+
+// Adam Step (single precision)
+inline void NeuralKernels::adamStep(float *w, float *m, float *v, const float *g, unsigned int n,
+                                    float scale, float rate, float beta1, float beta2, float epsilon)
+{
+    NeuralKernels::adamKernelF(w, m, v, g, n, scale, rate, beta1, beta2, epsilon);
+}
+
+// Sigmoid
+inline void NeuralKernels::sigmoid(const double *x, double *y, unsigned int n, bool fast)
+{
+    NeuralKernels::sigmoidKernel(x, y, n, fast);
+}
+
+// Hyperbolic Tangent
+inline void NeuralKernels::hyperbolicTangent(const double *x, double *y, unsigned int n, bool fast)
+{
+    NeuralKernels::tanhKernel(x, y, n, fast);
+}
+
+// Sigmoid (single precision)
+inline void NeuralKernels::sigmoid(const float *x, float *y, unsigned int n, bool fast)
+{
+    NeuralKernels::sigmoidKernelF(x, y, n, fast);
+}
+
+// Hyperbolic Tangent (single precision)
+inline void NeuralKernels::hyperbolicTangent(const float *x, float *y, unsigned int n, bool fast)
+{
+    NeuralKernels::tanhKernelF(x, y, n, fast);
+}
+
+#endif
@@ -9,9 +9,18 @@
 #include "neuron.hpp"
 #endif
 
+#ifndef ALIGNEDALLOCATOR_H
+#include "alignedAllocator.hpp"
+#endif
+
+#include <memory>
+
 // #include <vector> // Sourced from neuron.hpp
 // #include <iostream> // Sourced from neuron.hpp
 
+/// The network imports mapped layers
+template<typename T> class NeuralNetworkT;
+
 /**
  * This class forms an interactive container of sorts, to house and expose
  * individual neurons in a layer.  This layer is the effective owner of a
@@ -26,8 +35,20 @@
  * The alternative is to provide a neuron vector containing all the defined
  * neurons.  The configuration is assumed complete as is, but manual layer
  * configuration / training is still allowed after-the-fact.
+ *
+ * Storage is owned by the layer as a single contiguous, cache line aligned,
+ * row-major weight matrix.  Row n holds the weights of neuron n with the bias
+ * in column 0, followed by one weight per input; rows are padded to the
+ * weight stride so each begins on an aligned boundary.  Activations are kept
+ * in one contiguous buffer.  The neurons handed out are views onto this
+ * storage, so editing a neuron edits the layer.
+ *
+ * A layer imported by the network may instead view a weight matrix inside a
+ * memory mapped model file (zero-copy).  Copies of such a layer always take
+ * their own storage; moves keep viewing the mapping.
  */
-class NeuralLayer
+template<typename T>
+class NeuralLayerT
 {
 public: // Public Members
     
@@ -40,15 +61,27 @@ public: // Public Methods
      * weights for neurons.  Be sure to call SRAND external to the network
      * and neuron generation process (EX: in main.cpp)
      */ 
-    NeuralLayer(unsigned int neuronCount, unsigned int inputCount);
+    NeuralLayerT(unsigned int neuronCount, unsigned int inputCount);
 
     /// Constructor with pre-defined neurons
-    NeuralLayer(std::vector<Neuron> *layer);
+    NeuralLayerT(std::vector<NeuronT<T>> *layer);
+
+    /// Copy constructor - neuron views are re-bound to the new storage
+    NeuralLayerT(const NeuralLayerT &other);
+
+    /// Move constructor - neuron views are re-bound to the new storage
+    NeuralLayerT(NeuralLayerT &&other);
+
+    /// Copy assignment - neuron views are re-bound to the new storage
+    NeuralLayerT & operator=(const NeuralLayerT &other);
+
+    /// Move assignment - neuron views are re-bound to the new storage
+    NeuralLayerT & operator=(NeuralLayerT &&other);
 
     /*********************** DESTRUCTORS *******************************/
 
     /// Default
-    ~NeuralLayer();
+    ~NeuralLayerT();
     
     /*********************** SETTERS ***********************************/
 
@@ -57,6 +90,14 @@ public: // Public Methods
      */
     void finalize();
 
+    /**
+     * This method sets how accurately sigmoid and hyperbolic tangent neurons
+     * are evaluated.  Networks set this on all of their layers.
+     * 
+     * @param mode - the activation accuracy
+     */
+    void setActivationMode(NeuralActivationMode mode);
+
     /*********************** GETTERS ***********************************/
     
     /**
@@ -93,7 +134,7 @@ public: // Public Methods
      * 
      * @return - Input size requirements
      */
-    unsigned int getInputCount();
+    unsigned int getInputCount() const;
 
     /**
      * This method returns the last activation state for the neurons in
@@ -101,15 +142,64 @@ public: // Public Methods
      * 
      * @return - The last activation values of the layer
      */
-    std::vector<double> getLayerMemory();
+    std::vector<T> getLayerMemory();
+
+    /**
+     * This method exposes the contiguous activation buffer of the layer
+     * without copying.  Only meaningful if the layer has activated.
+     * 
+     * @return - pointer to neuronCount activation values
+     */
+    const T * getLayerMemoryData() const;
 
     /**
-     * This method exposes the neuron to external changes and read 
+     * This method exposes the neuron to external changes and read.  The
+     * neuron views the layer matrix, so the pointer is invalidated by the
+     * next addNeuron (which may reallocate the matrix).
      * 
      * @param neuronIdx - the index of the neuron to fetch
      * @return - A pointer to the neuron of interest
      */
-    Neuron * getNeuron(unsigned int neuronIdx);
+    NeuronT<T> * getNeuron(unsigned int neuronIdx);
+
+    /**
+     * This method exposes the contiguous row-major weight matrix.  Row n
+     * starts at (n * getWeightStride()), with the bias in column 0.
+     * 
+     * @return - pointer to the first weight of the first neuron
+     */
+    T * getWeightMatrix();
+
+    /**
+     * This method returns the row length of the weight matrix in elements,
+     * which is (inputCount + 1) padded up to the storage alignment.
+     * 
+     * @return - the weight matrix row stride
+     */
+    unsigned int getWeightStride() const;
+
+    /**
+     * Is the internal mechanism to identify if the weight matrix is a view
+     * of memory mapped model storage rather than owned by the layer
+     * 
+     * @return true - if the weights are mapped
+     * @return false - if the weights are owned
+     */
+    bool isMapped() const;
+
+    /**
+     * This method exposes the activation type of every neuron, in order
+     * 
+     * @return - pointer to neuronCount activation types
+     */
+    const NeuralActivationType * getActivationTypes() const;
+
+    /**
+     * This method returns how accurately the layer evaluates its activations
+     * 
+     * @return - the activation accuracy
+     */
+    NeuralActivationMode getActivationMode() const;
 
     /*********************** FUNCTIONAL ********************************/
     
@@ -118,9 +208,11 @@ public: // Public Methods
      * is added is the order that is persisted.  If you add a neuron, the
      * input size is compared to the first element for validity.
      * This method is mainly here for deliberate layer building.
+     * Growing the matrix rebinds every neuron to it, so pointers taken
+     * from getNeuron beforehand no longer refer to the layer.
      * @param neuron - a neuron to add to the network
      */
-    void addNeuron(Neuron neuron);
+    void addNeuron(NeuronT<T> neuron);
 
     /**
      * This method simply sets the 'activated' field to false.  This is to
@@ -134,7 +226,7 @@ public: // Public Methods
      * This method returns the current number of neurons in the layer
      * @returns - number of neurons in the layer
      */
-    unsigned int neuronCount();
+    unsigned int neuronCount() const;
 
     /**
      * This method receives an input vector and feeds it through
@@ -145,13 +237,52 @@ public: // Public Methods
      * The output from the network doesn't regard as trained or untrained...
      * It just fires based on current values.
      * 
-     * @param inputs - a vector of double containing the expected inputs
+     * @param inputs - a vector of values containing the expected inputs
      * @return - the output from the network
      */
-    std::vector<double> recall(std::vector<double> *inputs);
+    std::vector<T> recall(std::vector<T> *inputs);
+
+    /**
+     * This method is the layer forward pass over raw contiguous buffers. No
+     * validation is performed, and no layer state is changed.
+     * 
+     * @param inputs - inputCount values feeding the layer
+     * @param outputs - neuronCount values to receive the activations
+     */
+    void forward(const T *inputs, T *outputs) const;
+
+    /**
+     * This method is the layer forward pass over a batch of samples, computed
+     * as a cache blocked matrix-matrix product so each block of weights is
+     * loaded once per block of samples rather than once per sample.  No
+     * validation is performed, and no layer state is changed.
+     * 
+     * @param inputs - sampleCount rows of inputCount values (row-major)
+     * @param sampleCount - the number of samples in the batch
+     * @param outputs - sampleCount rows of neuronCount values (row-major)
+     */
+    void forwardBatch(const T *inputs, unsigned int sampleCount, T *outputs) const;
+
+    /**
+     * This method is the training forward pass.  On top of the activations
+     * it keeps the slope of each neuron's activation, so the backward pass
+     * reads them rather than deriving them again.  No validation is
+     * performed, and no layer state is changed.
+     * 
+     * @param inputs - inputCount values feeding the layer
+     * @param outputs - neuronCount values to receive the activations
+     * @param derivatives - neuronCount values to receive d(output)/d(sum)
+     */
+    void forwardTrain(const T *inputs, T *outputs, T *derivatives) const;
 
 private: // Private Members
 
+    /// The number of samples sharing each block of weights in forwardBatch
+    const static unsigned int SAMPLE_BLOCK = 16;
+
+    /// The number of inputs per weight block in forwardBatch (fits L1 with the sample block)
+    const static unsigned int INPUT_BLOCK = 256;
+
     /// Valuation of if layer is initialized - default: false
     bool initialized;
 
@@ -161,24 +292,96 @@ private: // Private Members
     /// If the layer has been activated
     bool activated;
 
-    /// Retains the the output of the layer after firing
-    std::vector<double> layerMemory;
+    /// Retains the the output of the layer after firing (one slot per neuron)
+    AlignedVector<T> layerMemory;
 
     /// Expected input count for the layer
     unsigned int inputCount;
 
-    /// The layer of neurons
-    std::vector<Neuron> layer;
+    /// Row length of the weight matrix: (inputCount + 1) padded to alignment
+    unsigned int weightStride;
+
+    /// Owned row-major weight matrix, bias in column 0 (neuronCount * weightStride)
+    AlignedVector<T> weights;
+
+    /// The weight matrix in use, either the owned storage or mapped storage
+    T *weightData;
+
+    /// Keeps mapped weight storage alive - default: null (owned storage)
+    std::shared_ptr<void> mappedStorage;
+
+    /// The activation type of each neuron
+    std::vector<NeuralActivationType> activationTypes;
+
+    /// How accurately sigmoid and hyperbolic tangent are evaluated - default: EXACT
+    NeuralActivationMode activationMode;
+
+    /// The layer of neurons (views onto the storage above)
+    std::vector<NeuronT<T>> layer;
 
 private: // Private Methods
     
     /*********************** CONSTRUCTORS ******************************/
 
     /// Default contructer is privatized due to initilization requirements
-    NeuralLayer();
+    NeuralLayerT();
+
+    /**
+     * Constructor viewing a weight matrix the layer does not own, used by
+     * the network import to run straight from a memory mapped file
+     * 
+     * @param inputCount - the number of inputs to the layer
+     * @param weightStride - the row stride of the weight matrix
+     * @param types - the activation type of each neuron
+     * @param weights - the row-major weight matrix (neuronCount * weightStride)
+     * @param storage - keeps the underlying storage alive
+     */
+    NeuralLayerT(unsigned int inputCount, unsigned int weightStride,
+                std::vector<NeuralActivationType> *types,
+                T *weights, std::shared_ptr<void> storage);
+
+    /// The network constructs mapped layers on import
+    friend class NeuralNetworkT<T>;
 
     /*********************** FUNCTIONAL ********************************/    
 
+    /**
+     * This method appends one row to the weight matrix, and a slot to the
+     * activation buffer.  The neuron views must be re-bound afterwards.
+     * 
+     * @param weights - (inputCount + 1) weights, bias first
+     * @param type - the activation type of the neuron
+     */
+    void appendRow(const T *weights, NeuralActivationType type);
+
+    /// This method (re)creates the neuron views onto the layer storage
+    void bindNeurons();
+
+    /**
+     * This method activates the weighted sums of one sample, each run of
+     * neurons sharing an activation type in one kernel call
+     * 
+     * @param sums - neuronCount weighted sums
+     * @param outputs - neuronCount values to receive the activations (may be sums)
+     */
+    void activateRow(const T *sums, T *outputs) const;
+
+    /**
+     * This method activates values that all share one activation type
+     * 
+     * @param type - the activation type
+     * @param sums - count weighted sums
+     * @param outputs - count values to receive the activations (may be sums)
+     * @param count - the number of values
+     */
+    void activateValues(NeuralActivationType type, const T *sums, T *outputs, size_t count) const;
+
 };
 
-#endif
\ No newline at end of file
+/// Double precision neural layer (reference)
+typedef NeuralLayerT<double> NeuralLayer;
+
+/// Single precision neural layer
+typedef NeuralLayerT<float> NeuralLayerF;
+
+#endif
@@ -9,7 +9,20 @@
 #include "neuralLayer.hpp"
 #endif
 
+#ifndef NEURALCONTEXT_H
+#include "neuralContext.hpp"
+#endif
+
+#ifndef NEURALDATAVIEW_H
+#include "neuralDataView.hpp"
+#endif
+
+#ifndef NEURALINSTRUMENTATION_H
+#include "neuralInstrumentation.hpp"
+#endif
+
 #include <map> 
+#include <string>
 // #include <vector> // Sourced from neuron.hpp
 // #include <iostream> // Sourced from neuron.hpp
 
@@ -28,8 +41,26 @@
  * The alternative is to provide a neural layer OR a network containing
  * all the defined neurons.  The configuration is assumed complete as is,
  * but manual layer configuration is still allowed after-the-fact.
+ *
+ * A network can be exported to / imported from a compact binary model file.
+ * Import memory maps the file and the layers run straight from the mapped
+ * pages, so loading costs no parse or copy and processes loading the same
+ * model share one page cached copy (until one of them trains it).
+ *
+ * Model file layout (version 1, native byte order, all offsets from file start):
+ *   [0, 64)     header - magic "ADAMNNET", version, scalar size, endian marker,
+ *               layer count, input count, trained accuracy, true accuracy
+ *   [64, ...)   one 32 byte entry per layer - neuron count, input count,
+ *               weight stride, activation offset, weight offset
+ *   ...         per layer, one byte activation type per neuron
+ *   ...         per layer, the row-major weight matrix (neuronCount * stride
+ *               scalars, bias in column 0), each starting 64 byte aligned
+ *
+ * The scalar size records the precision the model was saved in; a model only
+ * imports into a network of the same precision (NeuralNetwork / NeuralNetworkF).
  */
-class NeuralNetwork
+template<typename T>
+class NeuralNetworkT
 {
 public: // Public Members
     
@@ -38,15 +69,15 @@ public: // Public Methods
     /*********************** CONSTRUCTORS ******************************/
 
     /// Default
-    NeuralNetwork();
+    NeuralNetworkT();
 
     /// Constructor with pre-defined neural network
-    NeuralNetwork(std::vector<NeuralLayer> *network);
+    NeuralNetworkT(std::vector<NeuralLayerT<T>> *network);
 
     /*********************** DESTRUCTORS *******************************/
 
     /// Default
-    ~NeuralNetwork();
+    ~NeuralNetworkT();
     
     /*********************** SETTERS ***********************************/
 
@@ -55,6 +86,16 @@ public: // Public Methods
      */
     void finalize();
 
+    /**
+     * This method sets how accurately the sigmoid and hyperbolic tangent
+     * neurons of every layer are evaluated.  FAST trades accuracy (about
+     * 1e-5 relative) for speed on wide layers.  The mode is a runtime
+     * setting and is not saved with the model.
+     * 
+     * @param mode - the activation accuracy
+     */
+    void setActivationMode(NeuralActivationMode mode);
+
     /*********************** GETTERS ***********************************/
     
     /**
@@ -96,6 +137,16 @@ public: // Public Methods
      */
     double getTrueAccuracy();
 
+    /**
+     * This method returns a confusion count from the last evaluation of a
+     * dataset.  Every output of every sample is one binary classification.
+     * 
+     * @param dataset - the dataset evaluated (training or blind)
+     * @param classifier - the outcome to count
+     * @return - the number of classifications with that outcome (0 if not evaluated)
+     */
+    unsigned long getClassifierCount(DatasetType dataset, BinaryClassifierType classifier);
+
     /**
      * This reutrns the nuber of expected inputs into the network
      * 
@@ -108,7 +159,7 @@ public: // Public Methods
      * 
      * @return - The last output values of the network
      */
-    std::vector<double> getNetworkMemory();
+    std::vector<T> getNetworkMemory();
 
     /*********************** FUNCTIONAL ********************************/
     
@@ -139,7 +190,7 @@ public: // Public Methods
      * match the previous layer's neuon count (if not first layer)
      * @param layer - the Neural Layer to add to the network
      */
-    void addLayer(NeuralLayer layer);
+    void addLayer(NeuralLayerT<T> layer);
 
     /**
      * This method returns the number of layers in the network
@@ -148,6 +199,14 @@ public: // Public Methods
      */
     unsigned int layerCount();
 
+    /**
+     * This method exposes a layer to external changes and read
+     * 
+     * @param layerIdx - the index of the layer to fetch
+     * @return - A pointer to the layer of interest (nullptr if out of range)
+     */
+    NeuralLayerT<T> * getLayer(unsigned int layerIdx);
+
     /**
      * This method receives an input vector and feeds it through
      * the various layers and neurons.  At the first layer, the inputs
@@ -157,15 +216,151 @@ public: // Public Methods
      * The output from the network doesn't regard as trained or untrained...
      * It just fires based on current values.
      * 
-     * @param inputs - a vector of double containing the expected inputs
+     * @param inputs - a vector of values containing the expected inputs
      * @return - the output from the network
      */
-    std::vector<double> recall(std::vector<double> *inputs);
+    std::vector<T> recall(std::vector<T> *inputs);
+
+    /**
+     * This method feeds the inputs through the network without changing any
+     * network state (the network memory included).  The intermediate
+     * activations live in the caller's context, so any number of threads may
+     * recall one network at the same time, each with its own context.
+     * @see NeuralContext.hpp
+     * 
+     * @param inputs - a vector of values containing the expected inputs
+     * @param context - the caller owned scratch (grown to fit if needed)
+     * @return - the output from the network (empty on error)
+     */
+    std::vector<T> recall(const std::vector<T> &inputs, NeuralContextT<T> *context) const;
+
+    /**
+     * This method feeds the inputs through the network over raw buffers
+     * without changing any network state.  No validation is performed.
+     * 
+     * @param inputs - getInputCount() values
+     * @param context - the caller owned scratch (grown to fit if needed)
+     * @return - getOutputCount() output values, held in the context until
+     *      its next use
+     */
+    const T * recall(const T *inputs, NeuralContextT<T> *context) const;
+
+    /**
+     * This method feeds a batch of samples through the network.  The samples
+     * are given back to back in one contiguous row-major buffer, and each
+     * layer is evaluated as a blocked matrix-matrix product over a chunk of
+     * samples.  The network memory is not updated by a batch recall.
+     * 
+     * @param inputs - sampleCount rows of getInputCount() values
+     * @param sampleCount - the number of samples in the buffer
+     * @return - sampleCount rows of output values (row-major)
+     */
+    std::vector<T> recallBatch(std::vector<T> *inputs, unsigned int sampleCount);
+
+    /**
+     * This method feeds a batch of samples through the network over raw
+     * contiguous buffers.  No validation is performed.  The activations are
+     * held in the network's own context, so repeated batches allocate nothing
+     * but one network must not batch recall on two threads at once (use the
+     * context overload for that).
+     * 
+     * @param inputs - sampleCount rows of getInputCount() values
+     * @param sampleCount - the number of samples in the buffer
+     * @param outputs - sampleCount rows to receive the network outputs
+     */
+    void recallBatch(const T *inputs, unsigned int sampleCount, T *outputs);
+
+    /**
+     * This method feeds every row of a data view through the network.  A
+     * contiguous view is used in place; the rows of any other view are
+     * packed a chunk at a time, in the network's own context as above.
+     * @see NeuralDataView.hpp
+     * 
+     * @param inputs - the samples, getInputCount() columns
+     * @param outputs - inputs.getRowCount() rows to receive the network outputs
+     */
+    void recallBatch(const NeuralDataViewT<T> &inputs, T *outputs);
+
+    /**
+     * This method feeds a batch of samples through the network over raw
+     * contiguous buffers, with the layer activations held in the caller's
+     * context, so repeated batches allocate nothing.  No validation is
+     * performed.
+     * 
+     * @param inputs - sampleCount rows of getInputCount() values
+     * @param sampleCount - the number of samples in the buffer
+     * @param outputs - sampleCount rows to receive the network outputs
+     * @param context - the caller owned scratch (grown to fit if needed)
+     */
+    void recallBatch(const T *inputs, unsigned int sampleCount, T *outputs, NeuralContextT<T> *context) const;
+
+    /**
+     * This method feeds every row of a data view through the network, with
+     * the layer activations and any packed rows held in the caller's context
+     * 
+     * @param inputs - the samples, getInputCount() columns
+     * @param outputs - inputs.getRowCount() rows to receive the network outputs
+     * @param context - the caller owned scratch (grown to fit if needed)
+     */
+    void recallBatch(const NeuralDataViewT<T> &inputs, T *outputs, NeuralContextT<T> *context) const;
+
+    /**
+     * This method returns the number of outputs of the network (the neuron
+     * count of the last layer)
+     * 
+     * @return - Output size of the network
+     */
+    unsigned int getOutputCount();
+
+    /**
+     * This returns the per layer forward / backward / update timings and
+     * counters.  They are only recorded in instrumented builds, and stay zero
+     * otherwise.  @see NeuralInstrumentation
+     * 
+     * @return - the instrumentation, for snapshot(), toText() or toJson()
+     */
+    const NeuralInstrumentation & getInstrumentation() const;
+
+    /**
+     * This method returns how accurately the layers evaluate their activations
+     * 
+     * @return - the activation accuracy
+     */
+    NeuralActivationMode getActivationMode() const;
+
+    /**
+     * This method writes the network to a binary model file.  The file is
+     * written beside the target and renamed over it, so exporting an imported
+     * network back to its own (mapped) file is safe.
+     * @see the class description for the layout
+     * 
+     * @param path - the file to write
+     * @return true - if the model was written
+     * @return false - if the network is empty or the file could not be written
+     */
+    bool exportNetwork(const std::string &path);
+
+    /**
+     * This method replaces the network with the one in a binary model file.
+     * The file is memory mapped and the weights are used in place (zero-copy).
+     * The mapping is private, so training an imported network never writes
+     * back to the file.
+     * 
+     * @param path - the model file to read
+     * @return true - if the model was loaded
+     * @return false - if the file is missing or malformed, the network is unchanged
+     */
+    bool importNetwork(const std::string &path);
+
+    /**
+     * This method zeroes the instrumentation totals (EX: between runs)
+     */
+    void resetInstrumentation();
 
 protected: // Protected Members
 
     /// The network of neural layers
-    std::vector<NeuralLayer> network;
+    std::vector<NeuralLayerT<T>> network;
 
     // //////////////////////////////////////////////////////////////////////////////////////
     // The variables below are configured and set by the trainer, and cannot be set otherwise
@@ -177,6 +372,12 @@ protected: // Protected Members
     /// Accuracy of trained network againsted a blind dataset
     double trueAccuracy;
 
+    /// Confusion counts of the last evaluation of each dataset
+    std::map<DatasetType, std::map<BinaryClassifierType, unsigned long>> classifierCounts;
+
+    /// Per layer timings and counters, recorded in instrumented builds (const recalls record too)
+    mutable NeuralInstrumentation instrumentation;
+
 private: // Private Members
 
     /// Valuation of if object is initialized - default: false
@@ -188,8 +389,23 @@ private: // Private Members
     /// Network input size
     unsigned int inputCount;
 
+    /// How accurately sigmoid and hyperbolic tangent are evaluated - default: EXACT
+    NeuralActivationMode activationMode;
+
     /// Retains the the output of the network (last layer) after firing
-    std::vector<double> networkMemory;
+    std::vector<T> networkMemory;
+
+    /// Scratch of the batch recalls made without a caller context
+    NeuralContextT<T> batchContext;
+
+    /// The number of samples carried through all the layers together in a batch recall
+    const static unsigned int BATCH_CHUNK = 64;
+
+    /// The number of rows of a non-contiguous view packed together for a batch recall
+    const static unsigned int VIEW_CHUNK = 1024;
+
+    /// The model file format version written by exportNetwork
+    const static unsigned int MODEL_VERSION = 1;
 
 
 private: // Private Methods
@@ -198,4 +414,10 @@ private: // Private Methods
 
 };
 
-#endif
\ No newline at end of file
+/// Double precision neural network (reference)
+typedef NeuralNetworkT<double> NeuralNetwork;
+
+/// Single precision neural network
+typedef NeuralNetworkT<float> NeuralNetworkF;
+
+#endif
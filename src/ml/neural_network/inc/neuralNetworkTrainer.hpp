@@ -13,13 +13,66 @@
 #include "neuralNetwork.hpp"
 #endif
 
+#ifndef NEURALGRADIENT_H
+#include "neuralGradient.hpp"
+#endif
+
+#ifndef NEURALARENA_H
+#include "neuralArena.hpp"
+#endif
+
+#ifndef NEURALCONTEXT_H
+#include "neuralContext.hpp"
+#endif
+
+#ifndef NEURALOPTIMIZER_H
+#include "neuralOptimizer.hpp"
+#endif
+
+#ifndef NEURALWORKERPOOL_H
+#include "neuralWorkerPool.hpp"
+#endif
+
+#ifndef NEURALDATASTREAM_H
+#include "neuralDataStream.hpp"
+#endif
+
+#ifndef NEURALCHECKPOINT_H
+#include "neuralCheckpoint.hpp"
+#endif
+
+#include <array>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 #include <thread>
-#include <sstream>
+#include <random>
 #include <algorithm>
 
 // #include <map> // Sourced from neuralNetwork.hpp
 
+/**
+ * This structure is the outcome of one fold of a cross validation: the
+ * model trained on every other fold, scored on this one
+ */
+struct NeuralFoldResult
+{
+    /// Rows held out as the fold
+    unsigned int rows;
+
+    /// Cycles the fold's model trained
+    unsigned int cycles;
+
+    /// Accuracy of the fold's model against the rows it trained on
+    double trainedAccuracy;
+
+    /// Accuracy of the fold's model against the held out rows
+    double trueAccuracy;
+
+    /// Mean loss, 1/2*(a - y)^2 summed over the outputs, of the held out rows
+    double loss;
+};
+
 /**
  * This class is a heavy weight wrapper to the Neural Nerwork class.  The
  * primary purpose of this class is to train the base class network. A
@@ -37,7 +90,8 @@
  * can be made. The recall and the backward propigation are decoupled to allows
  * for this use case.
  */
-class NeuralNetworkTrainer: public NeuralNetwork
+template<typename T>
+class NeuralNetworkTrainerT: public NeuralNetworkT<T>
 {
 public: // Public Members
 
@@ -49,15 +103,15 @@ public: // Public Methods
     /*********************** CONSTRUCTORS ******************************/
 
     /// Trainer with unassigned weights
-    NeuralNetworkTrainer();
+    NeuralNetworkTrainerT();
 
     /// Trainer with assigned weights
-    NeuralNetworkTrainer(std::vector<NeuralLayer> *network);
+    NeuralNetworkTrainerT(std::vector<NeuralLayerT<T>> *network);
 
     /*********************** DESTRUCTORS *******************************/
 
     /// Default
-    ~NeuralNetworkTrainer();
+    ~NeuralNetworkTrainerT();
     
     /*********************** SETTERS ***********************************/
 
@@ -76,10 +130,12 @@ public: // Public Methods
      * This method returns sets the convergence factors for the training
      * loop.  If the number or training cycles is achieved before this,
      * than the training will stop.  The convergence factors are determined
-     * as follows.  If the training accuracy doesn't change by a factor
-     * greater than 'margin' for 'count' number of times, convergence is
+     * as follows.  If the loss doesn't improve on the best loss so far by
+     * more than 'margin' for 'count' consecutive cycles, convergence is
      * achieved.  This will stop training even if the number of cycles
-     * hasn't been achieved.
+     * hasn't been achieved.  The loss is the sampled blind loss when blind
+     * loss samples are set, and the training epoch loss otherwise.
+     * @see setBlindLossSamples
      * 
      * If either value is 0, convergence is ignored, and the training will
      * continue until max training cycles is reached.  Margin should be
@@ -87,8 +143,8 @@ public: // Public Methods
      * 
      * @param count - the number of times the result must be less than margin
      *      This is a consecutive count.
-     * @param margin - the delta between consecutive training accuracies must
-     *      be less than this value.
+     * @param margin - the improvement on the best loss must be less than
+     *      this value.
      */
     void setConvergenceFactors(unsigned int count, double margin);
 
@@ -113,6 +169,106 @@ public: // Public Methods
      */
     void setLearnRate(float rate);
 
+    /**
+     * This method sets the number of worker threads used for training.  Each
+     * mini-batch is partitioned across the workers, each with its own
+     * activation state and gradient accumulator, and the worker gradients are
+     * reduced before the weights are updated.  A count of 1 trains on the
+     * calling thread only.
+     * 
+     * @param count - the number of worker threads (>= 1)
+     */
+    void setThreadCount(unsigned int count);
+
+    /**
+     * This method sets the number of samples per mini-batch: the gradient is
+     * summed over this many samples before each weight update.  Smaller
+     * batches update more often, larger ones spread better over the workers.
+     * A size of 0 trains full batch, one update per cycle (per block when
+     * training from a stream).  Asynchronous training always updates per
+     * sample and ignores this.
+     * 
+     * @param size - samples per mini-batch - 0 for full batch
+     */
+    void setBatchSize(unsigned int size);
+
+    /**
+     * This method sets how weight updates are scheduled across the worker
+     * threads: synchronous mini-batches, or lock-free asynchronous updates.
+     * @see NeuralTrainingMode
+     * 
+     * @param mode - the training mode
+     */
+    void setTrainingMode(NeuralTrainingMode mode);
+
+    /**
+     * This method sets the rule the summed gradient is applied to the weights
+     * with.  Momentum, RMSProp and Adam keep per-weight state for the length
+     * of a training run, and usually converge in far fewer cycles than plain
+     * SGD (typically with a smaller learn rate, EX: 0.01 for Adam).
+     * Asynchronous training always applies plain SGD.
+     * @see NeuralOptimizerType
+     * 
+     * @param type - the optimizer
+     */
+    void setOptimizer(NeuralOptimizerType type);
+
+    /**
+     * This method sets the factors of the optimizer, see NeuralOptimizer for
+     * which optimizer uses which.  Decays must be in [0, 1).
+     * 
+     * @param beta1 - momentum / first moment decay - default: 0.9
+     * @param beta2 - mean square / second moment decay - default: 0.999
+     * @param epsilon - denominator guard - default: 1e-8
+     */
+    void setOptimizerFactors(double beta1, double beta2, double epsilon);
+
+    /**
+     * This method sets the threshold that splits each output (and truth)
+     * into a positive or negative classification when a dataset is
+     * evaluated.  EX: 0.5 for sigmoid outputs, 0.0 for hyperbolic tangent.
+     * 
+     * @param threshold - values at or above are positive
+     */
+    void setClassificationThreshold(double threshold);
+
+    /**
+     * This method sets the number of blind (held out) samples, drawn at random
+     * without repeats once per training run, used to measure the blind loss
+     * after each cycle.  At or above the blind row count, every blind row is
+     * measured.
+     * When set, convergence is judged on the blind loss, so training stops
+     * once it no longer generalises better.  This costs one batch recall of
+     * the samples per cycle.
+     * 
+     * @param samples - the number of blind samples - 0 for off
+     */
+    void setBlindLossSamples(unsigned int samples);
+
+    /**
+     * This method seeds the generator behind the training shuffles and the
+     * blind loss sample, so a run can be repeated exactly.  Each trainer has
+     * its own generator, so trainers running on separate threads neither
+     * share nor contend on random state.  It is seeded from rand() when the
+     * trainer is constructed.
+     * 
+     * @param seed - the generator seed
+     */
+    void setSeed(unsigned int seed);
+
+    /**
+     * This method makes trainTestLoop checkpoint itself every 'interval'
+     * cycles: the weights, the optimizer state, the cycle, the generator and
+     * the shuffled row order are copied aside and written to the file by a
+     * background thread, so training does not wait on the disk.  A run cut
+     * short can then carry on from its last checkpoint with resumeTestLoop.
+     * @see NeuralCheckpoint.hpp
+     * 
+     * @param path - the checkpoint file, replaced at each checkpoint
+     * @param interval - cycles between checkpoints - 0 for off
+     */
+    void setCheckpoint(const std::string &path, unsigned int interval);
+
     /*********************** GETTERS ***********************************/
 
     /** 
@@ -153,6 +309,93 @@ public: // Public Methods
      */
     float getLearnRate();
 
+    /**
+     * This returns the number of worker threads used for training
+     * 
+     * @return - the worker thread count
+     */
+    unsigned int getThreadCount();
+
+    /**
+     * This returns the number of samples per mini-batch
+     * 
+     * @return - the batch size (0 for full batch)
+     */
+    unsigned int getBatchSize();
+
+    /**
+     * This returns the current training mode
+     * 
+     * @return - the training mode
+     */
+    NeuralTrainingMode getTrainingMode();
+
+    /**
+     * This returns the current optimizer
+     * 
+     * @return - the optimizer type
+     */
+    NeuralOptimizerType getOptimizer();
+
+    /**
+     * This returns the current classification threshold
+     * 
+     * @return - the classification threshold
+     */
+    double getClassificationThreshold();
+
+    /**
+     * This returns the number of blind samples used for the blind loss
+     * 
+     * @return - blind samples (0 if off)
+     */
+    unsigned int getBlindLossSamples();
+
+    /**
+     * This returns the checkpoint file
+     * 
+     * @return - the checkpoint path (empty if not set)
+     */
+    std::string getCheckpointPath();
+
+    /**
+     * This returns the number of cycles between checkpoints
+     * 
+     * @return - the checkpoint interval (0 if off)
+     */
+    unsigned int getCheckpointInterval();
+
+    /**
+     * This returns the number of cycles the last training loop ran, which is
+     * less than the training cycles if it stopped on convergence
+     * 
+     * @return - the number of cycles trained
+     */
+    unsigned int getCompletedCycles();
+
+    /**
+     * This returns the mean loss, 1/2*(a - y)^2 summed over the outputs, of
+     * the training samples during the last cycle
+     * 
+     * @return - the last epoch loss (-1.0 if not trained yet)
+     */
+    double getEpochLoss();
+
+    /**
+     * This returns the mean loss of the blind samples after the last cycle
+     * 
+     * @return - the last blind loss (-1.0 if not sampled)
+     */
+    double getBlindLoss();
+
+    /**
+     * This returns the training throughput achieved by the last training
+     * loop, so the training modes and thread counts can be compared
+     * 
+     * @return - samples trained per second (0.0 if not trained yet)
+     */
+    double getSamplesPerSecond();
+
     /**
      * This returns the the base class of the training network (which is simply
      * a NeuralNetwork).  This object will only have the necessary pieces
@@ -160,11 +403,124 @@ public: // Public Methods
      * 
      * @return - base class of trainer
      */
-    NeuralNetwork getNetwork();
+    NeuralNetworkT<T> getNetwork();
+
+    /**
+     * This returns the outcome of every fold of the last cross validation,
+     * in fold order
+     * 
+     * @return - the fold results (empty if not cross validated)
+     */
+    const std::vector<NeuralFoldResult> & getFoldResults() const;
+
+    /**
+     * This returns the mean held out accuracy over the folds of the last
+     * cross validation, weighted by fold size
+     * 
+     * @return - the cross validated accuracy (-1.0 if not cross validated)
+     */
+    double getCrossValidationAccuracy() const;
 
     /*********************** FUNCTIONAL ********************************/
 
-    void trainTestLoop(std::vector<std::vector<double>> inputs, std::vector<std::vector<double>> truths);
+    /**
+     * This method trains the network on the first dataSplitRatio portion of
+     * the data, then evaluates both the training and the blind portion,
+     * setting the trained and true accuracies and the confusion counts.
+     * Samples of the wrong size are reported and left out; the caller's
+     * data is neither copied nor reordered.
+     * 
+     * @param inputs - the sample inputs
+     * @param truths - the expected outputs of each sample
+     */
+    void trainTestLoop(const std::vector<std::vector<T>> &inputs, const std::vector<std::vector<T>> &truths);
+
+    /**
+     * This method trains and evaluates the network as above, straight from
+     * views of the caller's data (EX: one contiguous row-major buffer), so
+     * the dataset is never copied.
+     * @see NeuralDataView.hpp
+     * 
+     * @param inputs - the sample inputs, getInputCount() columns
+     * @param truths - the expected outputs, getOutputCount() columns, one row per input row
+     */
+    void trainTestLoop(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths);
+
+    /**
+     * This method carries on a trainTestLoop from a checkpoint it wrote,
+     * exactly as if the run had never stopped: same weights, optimizer
+     * state, shuffles and convergence state, training on to
+     * getTrainingCycles() cycles in all or until convergence (a checkpoint
+     * of the converging cycle trains no further).  The network, optimizer,
+     * data and split must be those of the checkpointed run.
+     * @see setCheckpoint
+     * 
+     * @param path - the checkpoint file
+     * @param inputs - the sample inputs, getInputCount() columns
+     * @param truths - the expected outputs, getOutputCount() columns, one row per input row
+     * @return true - if the run was resumed
+     * @return false - if the checkpoint is unreadable or does not match, nothing is trained
+     */
+    bool resumeTestLoop(const std::string &path, const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths);
+
+    /**
+     * This method trains the network from a data stream, so the dataset
+     * never has to be held in memory.  Each training cycle is one pass over
+     * the stream.  Every block is split by dataSplitRatio: its leading rows
+     * are trained on (shuffled within the block) and the rest are blind.
+     * The blind loss, when sampled, is measured on the first blind rows of
+     * each pass.  After training, one more pass evaluates both portions,
+     * setting the trained and true accuracies and the confusion counts.  If
+     * the stream cannot be rewound, the error is reported and the accuracies
+     * are left at -1 (not evaluated).
+     * @see NeuralDataStream.hpp
+     * 
+     * @param stream - the stream, its columns matching the network inputs / outputs
+     */
+    void trainTestStream(NeuralDataStreamT<T> *stream);
+
+    /**
+     * This method estimates how well the network generalises with k-fold
+     * cross validation.  The rows are shuffled once into k folds; one model
+     * per fold, with this trainer's settings and layer shapes but freshly
+     * randomised weights, trains on the other folds and is scored on its
+     * own.  The held out fold never feeds the blind loss, so convergence is
+     * judged on the training folds alone.  The folds train in parallel
+     * over the caller's data, the worker threads split into groups, one fold
+     * per group at a time (EX: 8 threads, 4 folds -> 4 folds at once on 2
+     * threads each; 10 threads -> on 3, 3, 2 and 2 threads).  The data split
+     * ratio is not used.  This network is left untouched: train it on all of
+     * the data once satisfied.
+     * @see getFoldResults
+     * 
+     * @param inputs - the sample inputs, getInputCount() columns
+     * @param truths - the expected outputs, getOutputCount() columns, one row per input row
+     * @param folds - the number of folds, [2, rows]
+     */
+    void crossValidate(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths, unsigned int folds);
+
+    /**
+     * This method evaluates the network over a dataset with batched recall
+     * spread over the worker threads, replacing the accuracy and confusion
+     * counts of the given dataset type.  Every output of every sample is
+     * one binary classification, split at the classification threshold.
+     * Samples of the wrong size are reported and skipped.
+     * 
+     * @param inputs - the sample inputs
+     * @param truths - the expected outputs of each sample
+     * @param dataset - which accuracy to set (TRAINING or TRUE)
+     */
+    void evaluate(const std::vector<std::vector<T>> &inputs, const std::vector<std::vector<T>> &truths,
+                  DatasetType dataset);
+
+    /**
+     * This method evaluates the network over views of a dataset as above
+     * 
+     * @param inputs - the sample inputs, getInputCount() columns
+     * @param truths - the expected outputs, getOutputCount() columns, one row per input row
+     * @param dataset - which accuracy to set (TRAINING or TRUE)
+     */
+    void evaluate(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths, DatasetType dataset);
 
 private: // Private Members
 
@@ -186,25 +542,263 @@ private: // Private Members
     /// Global index for current training cycle
     unsigned int currentCycle;
 
-    /// Global index keeping track of number of times accuracy deltas < margin
+    /// Global index keeping track of number of times loss improvements < margin
     unsigned int currentConvergenceCount;
 
+    /// Number of worker threads used for training - default: 1
+    unsigned int threadCount;
+
+    /// Samples per mini-batch, 0 for full batch - default: 100
+    unsigned int batchSize;
+
+    /// Scheduling of weight updates across workers - default: SYNCHRONOUS
+    NeuralTrainingMode trainingMode;
+
+    /// Applies the summed gradient to the weights, with its per-weight state - default: SGD
+    NeuralOptimizerT<T> optimizer;
+
+    /// Throughput of the last training loop - default: 0.0
+    double samplesPerSecond;
+
+    /// Split between positive and negative classifications - default: 0.5
+    double classificationThreshold;
+
+    /// Blind samples drawn to measure the blind loss - default: 0 (off)
+    unsigned int blindLossSamples;
+
+    /// Mean training loss of the last cycle - default: -1.0 (not trained)
+    double epochLoss;
+
+    /// Mean sampled blind loss of the last cycle - default: -1.0 (not sampled)
+    double blindLoss;
+
+    /// Shuffles the training rows and draws the blind samples - default: seeded from rand()
+    std::mt19937 generator;
+
+    /// Outcome of each fold of the last cross validation
+    std::vector<NeuralFoldResult> foldResults;
+
+    /// The file training checkpoints are written to - default: empty
+    std::string checkpointPath;
+
+    /// Cycles between training checkpoints - default: 0 (off)
+    unsigned int checkpointInterval;
+
+    /// Lowest loss of the current training run
+    double bestLoss;
+
+    /// Number of shuffled samples a worker claims at a time in asynchronous mode
+    const static unsigned int ASYNC_CHUNK = 16;
+
+    /// Number of samples packed into each batch recall when evaluating
+    const static unsigned int EVALUATION_CHUNK = 256;
+
+    /// The workspace arena slot holding the activations of each layer
+    const static unsigned int ACTIVATION_SLOT = 0;
+
+    /// The workspace arena slot holding the dC/dz deltas of each layer
+    const static unsigned int DELTA_SLOT = 1;
+
+    /// The workspace arena slot holding the activation slopes of each layer
+    const static unsigned int DERIVATIVE_SLOT = 2;
+
+    /// The number of workspace arena slots per layer
+    const static unsigned int ARENA_SLOTS = 3;
+
     std::map<std::string, double> dataMap;
 
+    /**
+     * The training state owned by one worker thread: the activations and the
+     * dC/dz deltas of every layer for the current sample, the worker's
+     * gradient accumulator for the current mini-batch, the scratch of the
+     * batch recalls it runs to measure and evaluate, and its summed cost.
+     * All of it is sized by shapeWorkspaces, so a training cycle does not
+     * touch the heap.
+     */
+    struct Workspace
+    {
+        /// Per layer activations, dC/dz and slopes of the current sample (*_SLOT)
+        NeuralArenaT<T> arena;
+
+        /// Summed cost gradient of this worker's share of the mini-batch
+        NeuralGradientT<T> gradient;
+
+        /// Layer activations and packed rows of this worker's batch recalls
+        NeuralContextT<T> context;
+
+        /// Outputs of this worker's batch recalls, EVALUATION_CHUNK rows
+        AlignedVector<T> outputs;
+
+        /// Summed squared error of this worker's samples for the cycle
+        double cost;
+    };
+
+    /// One workspace per worker thread, shaped once per training run
+    std::vector<Workspace> workspaces;
+
 private: // Private Methods
     
     /*********************** FUNCTIONAL ********************************/    
 
-    void train(std::vector<double> inputs, std::vector<double> truths);
+    void train(std::vector<T> inputs, std::vector<T> truths);
 
-    void updateNetworkWeights(std::map<std::string, double> weight_change, int count);
+    /**
+     * This method trains the network on the leading rows of the data and
+     * evaluates both those and the blind remainder
+     * 
+     * @param inputs - the sample inputs
+     * @param truths - the expected outputs of each sample
+     * @param trainingSize - the number of leading rows to train on
+     * @param resume - a checkpoint of the run to carry on from (nullptr to start afresh)
+     * @return - false - if the checkpoint could not be restored, nothing is trained
+     */
+    bool trainTest(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths, unsigned int trainingSize,
+                   const NeuralSnapshotT<T> *resume = nullptr);
+
+    /**
+     * This method copies the training state into a snapshot, reusing its storage
+     * 
+     * @param snapshot - receives the state
+     * @param indexes - the training rows in their current order
+     * @param blindIndexes - the rows sampled for the blind loss
+     * @param rowCount - the rows of the dataset
+     * @param cycle - the training cycles completed
+     */
+    void captureSnapshot(NeuralSnapshotT<T> *snapshot, const std::vector<int> &indexes,
+                         const std::vector<unsigned int> &blindIndexes, unsigned int rowCount, unsigned int cycle);
+
+    /**
+     * This method restores the weights, optimizer, generator and convergence
+     * state of a snapshot already checked against the network
+     * 
+     * @param snapshot - the state to restore
+     * @return - false - if the generator state is corrupt, nothing is restored
+     */
+    bool restoreSnapshot(const NeuralSnapshotT<T> &snapshot);
+
+    /**
+     * This method sizes one workspace per worker to the current network.
+     * Storage is only reallocated if the network grew.
+     */
+    void shapeWorkspaces();
+
+    /**
+     * This method sizes the optimizer state to the current network and clears
+     * it, for a fresh training run
+     */
+    void shapeOptimizer();
+
+    /**
+     * This method runs one sample forward and backward, adding its cost to
+     * the workspace cost and its gradient to the workspace gradient
+     * 
+     * @param inputs - the sample inputs (getInputCount() values)
+     * @param truths - the expected outputs (output layer neuron count values)
+     * @param workspace - the worker state to use
+     */
+    void trainSample(const T *inputs, const T *truths, Workspace *workspace);
+
+    /**
+     * This method runs one training cycle over the indexed rows: synchronous
+     * mini-batches or asynchronous updates, per the training mode
+     * 
+     * @param inputs - the sample inputs
+     * @param truths - the expected outputs of each sample
+     * @param indexes - the (shuffled) rows to train, in order
+     * @param count - the number of indexes
+     * @param pool - the workers to train on
+     * @return - the summed squared error of the samples
+     */
+    double trainIndexes(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths, const int *indexes,
+                        unsigned int count, NeuralWorkerPool *pool);
+
+    /**
+     * This method runs rows through batch recall and sums their squared error
+     * 
+     * @param inputs - the sample inputs
+     * @param truths - the expected outputs of each sample
+     * @return - the summed squared error of the samples
+     */
+    double rowsCost(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths);
 
-    std::map<std::string, double> backPropigation(std::vector<double> * inputs, std::vector<double> * truths);
+    /**
+     * This method clears the losses and the convergence count for a new run
+     */
+    void resetConvergence();
+
+    /**
+     * This method counts a cycle towards convergence if its loss fails to
+     * improve on the best loss so far by more than the margin
+     * 
+     * @param loss - the loss of the cycle
+     * @return - true if the convergence count was reached
+     */
+    bool checkConvergence(double loss);
+
+    /**
+     * This method classifies rows across the worker pool, each worker running
+     * its share through batch recall a chunk at a time, and adds the outcomes
+     * to the counts
+     * 
+     * @param inputs - the sample inputs
+     * @param truths - the expected outputs of each sample
+     * @param pool - the workers to spread the evaluation over
+     * @param counts - the counts to add to, indexed by BinaryClassifierType
+     */
+    void classifyRows(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths,
+                      NeuralWorkerPool *pool, std::array<unsigned long, 4> *counts);
+
+    /**
+     * This method sets the confusion counts and accuracy of a dataset type
+     * 
+     * @param dataset - which accuracy to set (TRAINING or TRUE)
+     * @param counts - the outcome counts, indexed by BinaryClassifierType
+     */
+    void recordEvaluation(DatasetType dataset, const std::array<unsigned long, 4> &counts);
 
-    double d_activation_fun(Neuron neuron);
+    /**
+     * This method applies the summed gradient to the network weights with the
+     * optimizer, as one fused pass over each layer matrix
+     * 
+     * @param gradient - the summed cost gradient
+     * @param count - the number of samples summed into the gradient
+     */
+    void updateNetworkWeights(NeuralGradientT<T> *gradient, int count);
+
+    /**
+     * This method applies a worker's gradient straight to the shared weights
+     * with relaxed atomic loads / stores, and zeroes the gradient in the same
+     * pass.  Elements with a zero gradient are not written, so workers only
+     * contend on the weights their samples actually touched.
+     * 
+     * The forward and backward passes of the other workers read the same
+     * weights with plain vectorized loads.  That read is a data race by the
+     * C++ memory model, kept deliberately as in Hogwild: relaxed loads would
+     * rule out the SIMD kernels, and an aligned float or double is never torn
+     * on the targets the kernels support, so a reader sees the old or the new
+     * weight.
+     * 
+     * @param gradient - the worker's summed cost gradient (reset on return)
+     * @param count - the number of samples summed into the gradient
+     */
+    void applyNetworkWeightsAsync(NeuralGradientT<T> *gradient, int count);
 
-    double d_sigmoid(double value, bool recalc = false);
+    /**
+     * This method calculates the cost gradient of the sample last run forward
+     * in the workspace, and adds it into the workspace gradient by index
+     * 
+     * @param inputs - the inputs of the sample
+     * @param truths - the expected outputs of the sample
+     * @param workspace - the worker state holding the sample activations
+     */
+    void backPropigation(const T *inputs, const T *truths, Workspace *workspace);
 
 };
 
-#endif
\ No newline at end of file
+/// Double precision network trainer (reference)
+typedef NeuralNetworkTrainerT<double> NeuralNetworkTrainer;
+
+/// Single precision network trainer
+typedef NeuralNetworkTrainerT<float> NeuralNetworkTrainerF;
+
+#endif
@@ -0,0 +1,237 @@
+#ifndef NEURALOPTIMIZER_H
+#define NEURALOPTIMIZER_H
+
+#ifndef NEURALTYPES_H
+#include "neuralTypes.hpp"
+#endif
+
+#ifndef NEURALLAYER_H
+#include "neuralLayer.hpp"
+#endif
+
+#ifndef NEURALGRADIENT_H
+#include "neuralGradient.hpp"
+#endif
+
+#ifndef ALIGNEDALLOCATOR_H
+#include "alignedAllocator.hpp"
+#endif
+
+// #include <vector> // Sourced from neuron.hpp
+// #include <iostream> // Sourced from neuron.hpp
+
+/**
+ * This class applies a summed cost gradient to the weights of a network
+ * with the selected update rule.  @see NeuralOptimizerType
+ *
+ * The per-weight state of the rule (velocity, or first / second moments)
+ * mirrors the weight matrices element for element: each layer has one block
+ * per state slot, laid out with the layer's weight stride, and all layers
+ * live back to back in one aligned allocation.  A layer is updated in a
+ * single fused pass (NeuralKernels) that streams its weights, its gradient
+ * and its state once.  Padding columns have a zero gradient, so they keep
+ * zero state and are never moved.
+ *
+ * The factors are shared across the rules:
+ *  beta1 - the momentum (MOMENTUM, NESTEROV) or first moment decay (ADAM)
+ *  beta2 - the mean square decay (RMSPROP) or second moment decay (ADAM)
+ *  epsilon - keeps the RMSPROP / ADAM denominators from zero
+ */
+template<typename T>
+class NeuralOptimizerT
+{
+public: // Public Members
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default - plain SGD, must be shaped before use
+    NeuralOptimizerT();
+
+    /**
+     * Constructor with the update rule
+     *
+     * @param type - the update rule
+     */
+    NeuralOptimizerT(NeuralOptimizerType type);
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Default
+    ~NeuralOptimizerT();
+
+    /*********************** SETTERS ***********************************/
+
+    /**
+     * This method sets the update rule.  The state is dropped, so the
+     * optimizer must be shaped again before the next step.
+     *
+     * @param type - the update rule
+     */
+    void setType(NeuralOptimizerType type);
+
+    /**
+     * This method sets the factors of the update rules (see the class
+     * description for which rule uses which).  Decays must be in [0, 1).
+     *
+     * @param beta1 - momentum / first moment decay - default: 0.9
+     * @param beta2 - mean square / second moment decay - default: 0.999
+     * @param epsilon - denominator guard - default: 1e-8
+     */
+    void setFactors(double beta1, double beta2, double epsilon);
+
+    /**
+     * This method (re)shapes the state to mirror the given network and
+     * clears it.  Storage is only reallocated if the size changed.
+     *
+     * @param network - the layers to mirror
+     */
+    void shape(std::vector<NeuralLayerT<T>> *network);
+
+    /**
+     * This method restores state saved from an optimizer of the same type,
+     * shaped to the same network (EX: from a training checkpoint)
+     *
+     * @param state - getStateSize() values, as returned by getState()
+     * @param size - the number of values
+     * @param steps - the step count the state was saved at
+     * @return - false - if the size does not match the shaped state
+     */
+    bool restoreState(const T *state, size_t size, unsigned long steps);
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns the update rule
+     *
+     * @return - the optimizer type
+     */
+    NeuralOptimizerType getType() const;
+
+    /**
+     * This returns the momentum / first moment decay
+     *
+     * @return - beta1
+     */
+    double getBeta1() const;
+
+    /**
+     * This returns the mean square / second moment decay
+     *
+     * @return - beta2
+     */
+    double getBeta2() const;
+
+    /**
+     * This returns the denominator guard
+     *
+     * @return - epsilon
+     */
+    double getEpsilon() const;
+
+    /**
+     * This returns the number of steps applied since the last shape / reset
+     *
+     * @return - the step count
+     */
+    unsigned long getStepCount() const;
+
+    /**
+     * This returns the per-weight state of all layers, back to back
+     *
+     * @return - getStateSize() values
+     */
+    const T * getState() const;
+
+    /**
+     * This returns the number of state values
+     *
+     * @return - the state size (0 for SGD)
+     */
+    size_t getStateSize() const;
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /// This method zeroes the state and the step count in place
+    void reset();
+
+    /**
+     * This method applies one update to the network weights (bias column
+     * included) from a summed gradient of the same shape
+     *
+     * @param network - the layers to update, as shaped
+     * @param gradient - the summed cost gradient
+     * @param rate - the learning rate
+     * @param count - the number of samples summed into the gradient
+     */
+    void step(std::vector<NeuralLayerT<T>> *network, NeuralGradientT<T> *gradient, T rate, int count);
+
+    /**
+     * This method starts a step applied one layer at a time (as step() does
+     * internally), checking the shapes and advancing the step count
+     *
+     * @param network - the layers to update, as shaped
+     * @param gradient - the summed cost gradient
+     * @return - false - if the optimizer is not shaped to the network
+     */
+    bool beginStep(std::vector<NeuralLayerT<T>> *network, NeuralGradientT<T> *gradient);
+
+    /**
+     * This method applies the current step to one layer, in one fused pass
+     *
+     * @param layerIdx - the layer to update
+     * @param weights - the layer weight matrix
+     * @param gradient - the layer gradient matrix (same stride)
+     * @param rate - the learning rate
+     * @param count - the number of samples summed into the gradient
+     */
+    void updateLayer(unsigned int layerIdx, T *weights, const T *gradient, T rate, int count);
+
+private: // Private Members
+
+    /// The update rule - default: SGD
+    NeuralOptimizerType type;
+
+    /// Momentum / first moment decay - default: 0.9
+    double beta1;
+
+    /// Mean square / second moment decay - default: 0.999
+    double beta2;
+
+    /// Denominator guard - default: 1e-8
+    double epsilon;
+
+    /// Steps applied since the state was cleared (ADAM bias correction)
+    unsigned long steps;
+
+    /// The ADAM bias corrections of the current step, folded into one rate factor
+    double rateCorrection;
+
+    /// All the layer state blocks, back to back
+    AlignedVector<T> state;
+
+    /// The offset of each layer into state
+    std::vector<size_t> offsets;
+
+    /// The element count of each layer block (neuronCount * stride)
+    std::vector<size_t> sizes;
+
+private: // Private Methods
+
+    /**
+     * This returns the number of state slots per weight of the update rule
+     *
+     * @return - 0 (SGD), 1 (MOMENTUM, NESTEROV, RMSPROP) or 2 (ADAM)
+     */
+    unsigned int slotCount() const;
+
+};
+
+/// Double precision optimizer (reference)
+typedef NeuralOptimizerT<double> NeuralOptimizer;
+
+/// Single precision optimizer
+typedef NeuralOptimizerT<float> NeuralOptimizerF;
+
+#endif
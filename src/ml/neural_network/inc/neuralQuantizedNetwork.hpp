@@ -0,0 +1,234 @@
+#ifndef NEURALQUANTIZEDNETWORK_H
+#define NEURALQUANTIZEDNETWORK_H
+
+#ifndef NEURALTYPES_H
+#include "neuralTypes.hpp"
+#endif
+
+#ifndef NEURALNETWORK_H
+#include "neuralNetwork.hpp"
+#endif
+
+#ifndef ALIGNEDALLOCATOR_H
+#include "alignedAllocator.hpp"
+#endif
+
+#include <cstdint>
+// #include <vector> // Sourced from neuron.hpp
+// #include <iostream> // Sourced from neuron.hpp
+
+/**
+ * This structure reports how far the outputs of a quantized network drift
+ * from those of the network it was quantized from, over a set of samples
+ */
+struct NeuralQuantizationDrift
+{
+    /// Largest absolute difference of any output
+    double maxAbsError;
+
+    /// Mean absolute difference over every output of every sample
+    double meanAbsError;
+
+    /// Root mean square difference over every output of every sample
+    double rmsError;
+
+    /// The number of samples compared
+    unsigned int sampleCount;
+};
+
+/**
+ * This class is a frozen, int8 weight copy of a trained network for fast
+ * inference.  It cannot be trained or edited; re-quantize from the source
+ * network after further training.
+ *
+ * Each weight row is quantized symmetrically with its own scale
+ * (w ~ rowScale * w_q, w_q in [-127, 127]) and the bias is kept at full
+ * precision.  The input of each layer is quantized with a per-layer scale
+ * (x ~ inputScale * x_q) found by a calibration pass: the source network is
+ * run over sample data and the largest input magnitude seen by each layer
+ * sets its scale.  The weighted sum is accumulated in int32, dequantized
+ * (bias + rowScale * inputScale * sum) and then activated as usual.
+ *
+ * Weight rows are padded to a 64 byte stride, so the weights take a quarter
+ * of the double (or half of the float) matrix.  The quantization drift is
+ * measured on the calibration data, and can be measured on any other data
+ * against the source network.
+ */
+template<typename T>
+class NeuralQuantizedNetworkT
+{
+public: // Public Members
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default - empty, must be quantized before use
+    NeuralQuantizedNetworkT();
+
+    /**
+     * Constructor quantizing a trained network
+     * @see quantize
+     *
+     * @param network - the trained network to quantize
+     * @param calibration - sample inputs representative of production data
+     */
+    NeuralQuantizedNetworkT(NeuralNetworkT<T> *network, std::vector<std::vector<T>> *calibration);
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Default
+    ~NeuralQuantizedNetworkT();
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This is the internal mechanism to identify if the network was properly
+     * quantized
+     *
+     * @return - true - if quantized
+     * @return - false - if not quantized / quantization failed
+     */
+    bool isInitialized();
+
+    /**
+     * This reutrns the nuber of expected inputs into the network
+     *
+     * @return - Input size requirements
+     */
+    unsigned int getInputCount();
+
+    /**
+     * This method returns the number of outputs of the network
+     *
+     * @return - Output size of the network
+     */
+    unsigned int getOutputCount();
+
+    /**
+     * This method returns the number of layers in the network
+     *
+     * @return - Integer number of layers
+     */
+    unsigned int layerCount();
+
+    /**
+     * This method returns the storage taken by the quantized weights,
+     * padding included
+     *
+     * @return - weight bytes
+     */
+    size_t getWeightBytes();
+
+    /**
+     * This method returns the drift measured over the calibration data when
+     * the network was quantized
+     *
+     * @return - the calibration drift
+     */
+    NeuralQuantizationDrift getCalibrationDrift();
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This method quantizes a trained network, replacing any previous
+     * contents.  The calibration inputs are run through the source network
+     * to set the input scale of each layer, then through both networks to
+     * measure the drift.
+     *
+     * @param network - the trained network to quantize
+     * @param calibration - sample inputs representative of production data
+     * @return - true - if the network was quantized
+     * @return - false - if the network or calibration data was unusable
+     */
+    bool quantize(NeuralNetworkT<T> *network, std::vector<std::vector<T>> *calibration);
+
+    /**
+     * This method measures the drift of the quantized outputs against a
+     * reference network (normally the source network) over a set of inputs
+     *
+     * @param reference - the network to compare against
+     * @param inputs - the sample inputs to compare on
+     * @return - the drift (zeroed if nothing could be compared)
+     */
+    NeuralQuantizationDrift measureDrift(NeuralNetworkT<T> *reference, std::vector<std::vector<T>> *inputs);
+
+    /**
+     * This method feeds the inputs through the quantized network
+     *
+     * @param inputs - a vector of values containing the expected inputs
+     * @return - the output from the network (empty on error)
+     */
+    std::vector<T> recall(std::vector<T> *inputs);
+
+    /**
+     * This method feeds the inputs through the quantized network over raw
+     * contiguous buffers.  No validation is performed.
+     *
+     * @param inputs - getInputCount() values
+     * @param outputs - getOutputCount() values to receive the outputs
+     */
+    void recall(const T *inputs, T *outputs);
+
+private: // Private Members
+
+    /**
+     * One frozen layer: the int8 weight matrix (row-major, rows padded to
+     * the stride), the per-row scales and the full precision biases
+     */
+    struct QuantizedLayer
+    {
+        /// Expected input count for the layer
+        unsigned int inputCount;
+
+        /// Row length of the int8 weight matrix
+        unsigned int weightStride;
+
+        /// Multiplier to quantize the layer inputs (1 / inputScale)
+        T inputInverseScale;
+
+        /// The int8 input weights, bias excluded (neuronCount * weightStride)
+        AlignedVector<int8_t> weights;
+
+        /// Dequantization factor of each row (rowScale * inputScale)
+        std::vector<T> rowScales;
+
+        /// The bias of each neuron
+        std::vector<T> biases;
+
+        /// The activation type of each neuron
+        std::vector<NeuralActivationType> activationTypes;
+    };
+
+    /// Valuation of if object is quantized - default: false
+    bool initialized;
+
+    /// Network input size
+    unsigned int inputCount;
+
+    /// The frozen layers, input to output
+    std::vector<QuantizedLayer> network;
+
+    /// Scratch for the quantized inputs of a layer
+    AlignedVector<int8_t> quantizedInputs;
+
+    /// Scratch for the activations between layers
+    AlignedVector<T> front;
+
+    /// Scratch for the activations between layers
+    AlignedVector<T> back;
+
+    /// Drift measured on the calibration data
+    NeuralQuantizationDrift calibrationDrift;
+
+private: // Private Methods
+
+};
+
+/// Double precision quantized network (double sourced)
+typedef NeuralQuantizedNetworkT<double> NeuralQuantizedNetwork;
+
+/// Single precision quantized network (float sourced)
+typedef NeuralQuantizedNetworkT<float> NeuralQuantizedNetworkF;
+
+#endif
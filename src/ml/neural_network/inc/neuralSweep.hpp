@@ -0,0 +1,376 @@
+#ifndef NEURALSWEEP_H
+#define NEURALSWEEP_H
+
+#ifndef NEURALTYPES_H
+#include "neuralTypes.hpp"
+#endif
+
+#ifndef NEURALNETWORKTRAINER_H
+#include "neuralNetworkTrainer.hpp"
+#endif
+
+#include <deque>
+#include <string>
+
+// #include <mutex> // Sourced from neuralNetworkTrainer.hpp
+// #include <random> // Sourced from neuralNetworkTrainer.hpp
+
+/**
+ * This structure is one configuration of a sweep and how it fared
+ */
+struct NeuralSweepResult
+{
+    /// Index of the configuration, in the order the search space produced it
+    unsigned int candidate;
+
+    /// Neurons per layer, first layer first (the input count comes from the data)
+    std::vector<unsigned int> topology;
+
+    /// Learning rate the configuration trained with
+    float learnRate;
+
+    /// Portion of the data the configuration trained on
+    float dataSplitRatio;
+
+    /// Samples per mini-batch (0 for full batch)
+    unsigned int batchSize;
+
+    /// Update rule the configuration trained with
+    NeuralOptimizerType optimizer;
+
+    /// The last rung the configuration trained in (the final rung if it was never halved out)
+    unsigned int rung;
+
+    /// Training cycles run over all of its rungs
+    unsigned int cycles;
+
+    /// The loss it was ranked on: the held out loss, or the epoch loss with none held out (-1 if unscored)
+    double loss;
+
+    /// Accuracy against the data it trained on
+    double trainedAccuracy;
+
+    /// Accuracy against the blind remainder of the data
+    double trueAccuracy;
+
+    /// Wall time spent training it, in seconds
+    double seconds;
+};
+
+/**
+ * This class searches NeuralNetworkTrainer settings (topology, learn rate,
+ * data split, batch size and optimizer) for the configuration that trains
+ * the best network on a dataset.  The configurations come from a grid or a
+ * random search over the listed values, and are trained side by side on a
+ * pool of worker threads, one trainer per configuration, all reading the one
+ * caller owned dataset.
+ *
+ * Losing configurations are dropped early by successive halving: every
+ * configuration trains a small share of the cycles, the best 1 / halvingRate
+ * of them go on to train for halvingRate times as many, and so on until the
+ * last rung trains the survivors to the full cycle count.  Survivors resume
+ * from their weights at each rung (the optimizer state and the convergence
+ * count restart).  Configurations differ widely in cost, so each worker
+ * takes the next configuration of a rung from its own queue and steals from
+ * the back of the others' once it runs dry.
+ *
+ * Every configuration is ranked on one set of held out rows, drawn once per
+ * run from the rows past the largest data split, so each rung compares the
+ * survivors on the same data none of them trained on.
+ *
+ * Weights are drawn with rand() on the calling thread as the configurations
+ * are built, and every trainer is seeded from the sweep seed, so a sweep is
+ * repeatable for a given srand() and seed whatever the thread count.
+ */
+template<typename T>
+class NeuralSweepT
+{
+public: // Public Members
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default - empty search space
+    NeuralSweepT();
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Default
+    ~NeuralSweepT();
+
+    /*********************** SETTERS ***********************************/
+
+    /**
+     * This method adds a topology to the search space: the neuron count of
+     * each layer, first layer first.  The last layer must match the truth
+     * columns of the data.
+     *
+     * @param layers - neurons per layer
+     */
+    void addTopology(const std::vector<unsigned int> &layers);
+
+    /**
+     * This method adds a learn rate to the search space.  With none listed,
+     * the trainer default is used.
+     *
+     * @param rate - the learn rate multiplier
+     */
+    void addLearnRate(float rate);
+
+    /**
+     * This method adds a data split ratio to the search space, [0,1].  With
+     * none listed, the trainer default is used.  The rows past the largest
+     * split are the ones held out to rank the configurations.
+     *
+     * @param ratio - the portion of input data used to train the network
+     */
+    void addDataSplitRatio(float ratio);
+
+    /**
+     * This method adds a mini-batch size to the search space.  With none
+     * listed, the trainer default is used.
+     *
+     * @param size - samples per mini-batch - 0 for full batch
+     */
+    void addBatchSize(unsigned int size);
+
+    /**
+     * This method adds an optimizer to the search space.  With none listed,
+     * the trainer default is used.
+     *
+     * @param type - the optimizer
+     */
+    void addOptimizer(NeuralOptimizerType type);
+
+    /**
+     * This method sets a range random search draws learn rates from,
+     * log-uniformly, in place of the listed rates.  Grid search ignores it.
+     *
+     * @param low - the smallest learn rate (> 0)
+     * @param high - the largest learn rate (>= low)
+     */
+    void setLearnRateRange(float low, float high);
+
+    /**
+     * This method sets how configurations are drawn from the search space
+     *
+     * @param type - grid or random search
+     * @param samples - the number of configurations of a random search
+     */
+    void setSearch(NeuralSearchType type, unsigned int samples = 0);
+
+    /**
+     * This method sets the number of training cycles of the last rung, which
+     * is the most any configuration trains for.  It also caps the rungs, as
+     * each rung must train more cycles than the one before it.
+     *
+     * @param cycles - training cycles of the surviving configurations
+     */
+    void setTrainingCycles(unsigned int cycles);
+
+    /**
+     * This method sets the factor each rung of successive halving cuts the
+     * configurations by and grows the cycles by.  A rate below 2 trains every
+     * configuration to the full cycle count.
+     *
+     * @param rate - the halving rate - default: 2
+     */
+    void setHalvingRate(unsigned int rate);
+
+    /**
+     * This method sets the number of configurations trained at once, one per
+     * worker thread (each trainer itself runs on a single thread)
+     *
+     * @param count - the number of worker threads (>= 1)
+     */
+    void setThreadCount(unsigned int count);
+
+    /**
+     * This method sets the number of held out rows every configuration is
+     * ranked on.  They are drawn once per run, without repeats, from the
+     * rows past the largest data split, which no configuration trains on.
+     * With none (or no rows past the split), configurations are ranked on
+     * their training loss.
+     *
+     * @param samples - the number of held out rows - default: 1000 - 0 for off
+     */
+    void setBlindLossSamples(unsigned int samples);
+
+    /**
+     * This method seeds the random search and the trainers
+     *
+     * @param seed - the generator seed
+     */
+    void setSeed(unsigned int seed);
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns every configuration of the last run, best first: those
+     * that reached later rungs rank above those halved out earlier, and
+     * within a rung the lower loss ranks first
+     *
+     * @return - the ranked results (empty if not run)
+     */
+    const std::vector<NeuralSweepResult> & getResults() const;
+
+    /**
+     * This returns the network trained by the best configuration
+     *
+     * @return - the best network (empty if not run)
+     */
+    NeuralNetworkT<T> getBestNetwork();
+
+    /**
+     * This returns the ranked results as a fixed width table, one line per
+     * configuration
+     *
+     * @return - the result table
+     */
+    std::string toText() const;
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This method trains every configuration of the search space on views
+     * of the caller's data and ranks them.  The data is neither copied nor
+     * reordered, so it should be shuffled beforehand as for trainTestLoop.
+     *
+     * @param inputs - the sample inputs
+     * @param truths - the expected outputs, one row per input row
+     */
+    void run(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths);
+
+private: // Private Members
+
+    /// Topologies to search
+    std::vector<std::vector<unsigned int>> topologies;
+
+    /// Learn rates to search
+    std::vector<float> learnRates;
+
+    /// Data split ratios to search
+    std::vector<float> dataSplitRatios;
+
+    /// Mini-batch sizes to search
+    std::vector<unsigned int> batchSizes;
+
+    /// Optimizers to search
+    std::vector<NeuralOptimizerType> optimizers;
+
+    /// Log-uniform learn rate range of a random search - default: 0.0, 0.0 (off)
+    float learnRateLow;
+    float learnRateHigh;
+
+    /// How configurations are drawn - default: GRID
+    NeuralSearchType searchType;
+
+    /// Configurations drawn by a random search - default: 0
+    unsigned int searchSamples;
+
+    /// Training cycles of the last rung - default: 1000
+    unsigned int trainingCycles;
+
+    /// Cut / growth factor between rungs - default: 2
+    unsigned int halvingRate;
+
+    /// Configurations trained at once - default: 1
+    unsigned int threadCount;
+
+    /// Held out rows every configuration is ranked on - default: 1000
+    unsigned int blindLossSamples;
+
+    /// Draws random configurations and the trainer seeds - default: seeded from rand()
+    std::mt19937 generator;
+
+    /// One trainer per configuration of the last run
+    std::vector<NeuralNetworkTrainerT<T>> trainers;
+
+    /// The configurations of the last run, ranked once it completes
+    std::vector<NeuralSweepResult> results;
+
+    /// One worker's queue of the configurations left in a rung
+    struct WorkQueue
+    {
+        /// Guards the queue, the owner takes from the front, thieves from the back
+        std::mutex mutex;
+
+        /// Indexes into the trainers
+        std::deque<unsigned int> candidates;
+    };
+
+private: // Private Methods
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This method draws the configurations from the search space, filling
+     * the results (unranked) without building the trainers
+     *
+     * @param outputCount - the truth columns the last layer must match
+     */
+    void drawConfigurations(unsigned int outputCount);
+
+    /**
+     * This method builds and configures the trainer of every configuration
+     *
+     * @param inputCount - the input columns of the data
+     */
+    void buildTrainers(unsigned int inputCount);
+
+    /**
+     * This method trains the configurations up to a cumulative cycle count,
+     * spread over the pool with work stealing, and records their scores
+     *
+     * @param inputs - the sample inputs
+     * @param truths - the expected outputs, one row per input row
+     * @param heldOutInputs - the held out rows the configurations are ranked on (may be empty)
+     * @param heldOutTruths - the expected outputs of the held out rows
+     * @param alive - the configurations still in the sweep
+     * @param rung - the rung being trained
+     * @param cycles - the cycles each configuration should have trained after the rung
+     * @param pool - the workers to train on
+     */
+    void trainRung(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths,
+                   const NeuralDataViewT<T> &heldOutInputs, const NeuralDataViewT<T> &heldOutTruths,
+                   const std::vector<unsigned int> &alive, unsigned int rung, unsigned int cycles,
+                   NeuralWorkerPool *pool);
+
+    /**
+     * This method takes the next configuration for a worker: from the front
+     * of its own queue, else from the back of another worker's
+     *
+     * @param queues - one queue per worker
+     * @param workerIdx - the worker asking
+     * @param candidate - receives the configuration
+     * @return - false once every queue is empty
+     */
+    static bool takeCandidate(std::vector<WorkQueue> *queues, unsigned int workerIdx, unsigned int *candidate);
+
+    /**
+     * This method orders configurations best first by loss
+     *
+     * @param candidates - the configurations to order
+     */
+    void rankByLoss(std::vector<unsigned int> *candidates) const;
+
+    /**
+     * This method orders two losses, lower first, with an unscored (negative)
+     * loss after any scored one
+     *
+     * @param a - the first loss
+     * @param b - the second loss
+     * @return - true - if a ranks ahead of b
+     */
+    static bool ranksBefore(double a, double b);
+
+};
+
+/// Double precision hyperparameter sweep (reference)
+typedef NeuralSweepT<double> NeuralSweep;
+
+/// Single precision hyperparameter sweep
+typedef NeuralSweepT<float> NeuralSweepF;
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef NEURALWORKERPOOL_H
+#define NEURALWORKERPOOL_H
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+/**
+ * This class is a small fork-join pool of persistent threads.  A task is
+ * run once on every worker (the calling thread acting as worker 0) and the
+ * call returns when all of them have finished, so the pool behaves as a
+ * reusable barrier around each parallel step (EX: one mini-batch).
+ *
+ * Threads are created once on construction and parked between tasks, which
+ * keeps the per-step cost to a notify and a wait.  A pool of size 1 runs the
+ * task inline and creates no threads.
+ */
+class NeuralWorkerPool
+{
+public: // Public Members
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /**
+     * Constructor with a worker count
+     *
+     * @param threadCount - the number of workers, including the caller (min 1)
+     */
+    NeuralWorkerPool(unsigned int threadCount);
+
+    /*********************** DESTRUCTORS *******************************/
+
+    /// Stops and joins the workers
+    ~NeuralWorkerPool();
+
+    /*********************** GETTERS ***********************************/
+
+    /**
+     * This returns the number of workers, including the calling thread
+     *
+     * @return - the worker count
+     */
+    unsigned int size() const;
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This method runs the task once on every worker, passing the worker
+     * index [0, size()), and blocks until every worker has returned.
+     *
+     * @param task - the work to perform, given the worker index
+     */
+    void run(const std::function<void(unsigned int)> &task);
+
+private: // Private Members
+
+    /// The parked worker threads (worker 0 is the caller)
+    std::vector<std::thread> threads;
+
+    /// Guards the members below
+    std::mutex poolMutex;
+
+    /// Signals the workers that a new task (or stop) is posted
+    std::condition_variable taskPosted;
+
+    /// Signals the caller that the last worker has finished
+    std::condition_variable taskFinished;
+
+    /// The current task
+    const std::function<void(unsigned int)> *task;
+
+    /// Incremented for every posted task
+    unsigned long generation;
+
+    /// Workers yet to finish the current task
+    unsigned int pending;
+
+    /// Tells the workers to exit
+    bool stopping;
+
+private: // Private Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Copying a pool of threads is not meaningful
+    NeuralWorkerPool(const NeuralWorkerPool &) = delete;
+
+    /// Copying a pool of threads is not meaningful
+    NeuralWorkerPool & operator=(const NeuralWorkerPool &) = delete;
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * This is the loop run by every parked worker thread
+     *
+     * @param workerIdx - the index of the worker [1, size())
+     */
+    void workerLoop(unsigned int workerIdx);
+
+};
+
+#endif
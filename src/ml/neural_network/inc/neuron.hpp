@@ -5,17 +5,30 @@
 #include "neuralTypes.hpp"
 #endif
 
+#ifndef NEURALKERNELS_H
+#include "neuralKernels.hpp"
+#endif
+
 #include <time.h>
 #include <math.h>
 #include <vector>
 #include <iostream>
 
+/// The layer owning bound neurons
+template<typename T> class NeuralLayerT;
+
 /**
  * This class contains the necessary components for a functional neuron,
  * the inputs coupled with weights and activation method create a neuron.
  * This class also contains the recall function and calculates the activation
  * method.  In order to keep this class lightweight, this is decoupled from the 
  * training mechanics.
+ *
+ * A neuron is either standalone (it owns its weights, memory and activation
+ * type) or bound to a layer.  A bound neuron is a lightweight view onto one
+ * row of the layer's contiguous weight matrix and one slot of the layer's
+ * activation buffer, so getters and setters read / write the layer storage
+ * directly.  Neurons handed out by NeuralLayer::getNeuron are always bound.
  * 
  * The number of weights (n + 1) is determined by the number of inputs (n).  The
  * additional weight is to form a bias in the case of the zero solution in the
@@ -32,8 +45,13 @@
  *      Note: This is not an activation, but an evaluation
  * RAW - Returns the weighted sum, this likely best served as an output layer neuron
  *      Note: This is not an activation, but an evaluation
+ *
+ * The neuron (like the layer, network and trainer) is a template on the
+ * scalar type T of its weights, inputs and memory.  Only float and double
+ * are instantiated; use the Neuron (double) and NeuronF (float) aliases.
  */
-class Neuron
+template<typename T>
+class NeuronT
 {
 public: // Public Members
     
@@ -46,15 +64,21 @@ public: // Public Methods
      * weights for neurons.  Be sure to call SRAND external to the network
      * and neuron generation process (EX: in main.cpp)
      */ 
-    Neuron(unsigned int inputCount);
+    NeuronT(unsigned int inputCount);
 
     /// Constructor with pre-defined weights
-    Neuron(std::vector<double> *weights);
+    NeuronT(std::vector<T> *weights);
+
+    /// Copy constructor - a bound neuron copies as a view of the same layer row
+    NeuronT(const NeuronT &other);
+
+    /// Copy assignment - a bound neuron copies as a view of the same layer row
+    NeuronT & operator=(const NeuronT &other);
 
     /*********************** DESTRUCTORS *******************************/
 
     /// Default
-    ~Neuron();
+    ~NeuronT();
     
     /*********************** SETTERS ***********************************/
     
@@ -66,7 +90,7 @@ public: // Public Methods
      * 
      * @param weights - a vector of weights for inputs and bias
      */
-    void setWeights(std::vector<double> *weights);
+    void setWeights(std::vector<T> *weights);
 
     /**
      * Set the Activation Type.  This is for the congiuration for how the 
@@ -103,7 +127,15 @@ public: // Public Methods
      * 
      * @return - a copy of the weights
      */
-    std::vector<double> getWeights();
+    std::vector<T> getWeights();
+
+    /**
+     * Get a pointer to the contiguous weights (bias first).  For a bound
+     * neuron this points into the owning layer's weight matrix.
+     * 
+     * @return - pointer to (n + 1) weights
+     */
+    const T * getWeightData();
 
     /**
      * Get the Input Count based off of initialization
@@ -128,7 +160,7 @@ public: // Public Methods
      * @return - The neural activation value 
      * @return - (-12345678.9) if neuron hasn't activated yet
      */
-    double getNeuronMemory();
+    T getNeuronMemory();
 
     /*********************** FUNCTIONAL ********************************/
 
@@ -140,7 +172,7 @@ public: // Public Methods
      * @param inputs - input values to evaluate the neuron against
      * @return - activate return value
      */
-    double recall(std::vector<double> *inputs);
+    T recall(std::vector<T> *inputs);
 
     /**
      * This method simply sets the 'activated' field to false.  This is to
@@ -150,6 +182,27 @@ public: // Public Methods
      */
     void clearNeruon();
 
+    /**
+     * This method applies the activation function to a weighted sum.  It is
+     * shared by the neuron and the layer forward passes.
+     * 
+     * @param sum - the weighted sum (bias included)
+     * @param type - the activation function to apply
+     * @return - the activation value
+     */
+    static T activate(T sum, NeuralActivationType type);
+
+    /**
+     * This method returns the slope of the activation function at a weighted
+     * sum, from its activation alone.  SWITCH and CATEGORICAL are steps, and
+     * so have no slope to train through.
+     * 
+     * @param activation - activate(sum, type)
+     * @param type - the activation function applied
+     * @return - the derivative of the activation with respect to the sum
+     */
+    static T derivative(T activation, NeuralActivationType type);
+
 private: // Private Members
 
     /// Valuation of if neuron is initialized - default: false
@@ -162,14 +215,15 @@ private: // Private Members
     unsigned int inputCount;
     
     /// Retrains the last neural stimulus - default (dummy): -12345678.9
-    double neuronMemory;
+    T neuronMemory;
 
     /**
      * Contains the weights for all n inputs including the additional bias 
      * input weight, and so the total size of this vector is (n + 1)
+     * Only used by a standalone neuron, a bound neuron uses the layer matrix
      * default: empty vector
      */
-    std::vector<double> weights;
+    std::vector<T> weights;
     
     /// The total size of the weight vector: (inputSize + 1)
     unsigned int weightSize;
@@ -177,15 +231,54 @@ private: // Private Members
     /// Used to define the activation function (output) - default: SIGMOID
     NeuralActivationType activationType;
 
+    /// If true the views below point into a layer, otherwise into this object
+    bool bound;
+
+    /// View of the (n + 1) weights
+    T *weightView;
+
+    /// View of the neural memory
+    T *memoryView;
+
+    /// View of the activation flag
+    bool *activatedView;
+
+    /// View of the activation type
+    NeuralActivationType *activationTypeView;
+
+    /// The layer binds its neurons as views onto its own storage
+    friend class NeuralLayerT<T>;
+
 private: // Private Methods
 
     /*********************** CONSTRUCTORS ******************************/
 
     /// Default contructer is privatized due to initilization requirements
-    Neuron();
+    NeuronT();
 
-    /*********************** FUNCTIONAL ********************************/    
+    /**
+     * Constructor of a bound neuron (view) onto layer owned storage
+     * 
+     * @param inputCount - the number of inputs (row holds inputCount + 1)
+     * @param weights - the weight row for this neuron (bias first)
+     * @param memory - the activation slot for this neuron
+     * @param activated - the activation flag of the layer
+     * @param activationType - the activation type slot for this neuron
+     */
+    NeuronT(unsigned int inputCount, T *weights, T *memory,
+           bool *activated, NeuralActivationType *activationType);
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /// Points the views at this object's own members (standalone neuron)
+    void bindLocal();
 
 };
 
+/// Double precision neuron (reference)
+typedef NeuronT<double> Neuron;
+
+/// Single precision neuron
+typedef NeuronT<float> NeuronF;
+
 #endif
\ No newline at end of file
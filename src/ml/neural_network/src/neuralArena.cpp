@@ -0,0 +1,99 @@
+#ifndef NEURALARENA_H
+#include "neuralArena.hpp"
+#endif
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Default
+template<typename T>
+NeuralArenaT<T>::NeuralArenaT()
+{
+    this->slots = 0;
+}
+
+// Constructor shaped to a network
+template<typename T>
+NeuralArenaT<T>::NeuralArenaT(std::vector<NeuralLayerT<T>> *network, unsigned int slots): NeuralArenaT()
+{
+    this->shape(network, slots);
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+template<typename T>
+NeuralArenaT<T>::~NeuralArenaT()
+{
+    // This object maintains ownership of data, no pointers to clean up
+}
+
+/*********************** SETTERS ***********************************/
+
+// Shape Arena
+template<typename T>
+void NeuralArenaT<T>::shape(std::vector<NeuralLayerT<T>> *network, unsigned int slots)
+{
+    // Check that the vector is null
+    if (!network)
+    {
+        std::cout << "Error: network pointer null" << std::endl;
+        return;
+    }
+
+    this->slots = slots;
+    this->offsets.clear();
+    this->widths.clear();
+
+    // Every buffer is padded out to whole cache lines
+    const size_t perLine = ADAM_ALIGNMENT / sizeof(T);
+    size_t total = 0;
+    for (NeuralLayerT<T> &layer : *network)
+    {
+        const unsigned int width = layer.neuronCount();
+        const size_t padded = (width + perLine - 1) / perLine * perLine;
+        for (unsigned int slot = 0; slot < slots; slot++)
+        {
+            this->offsets.push_back(total);
+            total += padded;
+        }
+        this->widths.push_back(width);
+    }
+
+    // A smaller or equal topology reuses the existing storage
+    this->storage.resize(total);
+    std::fill(this->storage.begin(), this->storage.end(), 0.0);
+}
+
+/*********************** GETTERS ***********************************/
+
+// Layer Count
+template<typename T>
+unsigned int NeuralArenaT<T>::layerCount() const
+{
+    return (unsigned int)this->widths.size();
+}
+
+// Slot Count
+template<typename T>
+unsigned int NeuralArenaT<T>::slotCount() const
+{
+    return this->slots;
+}
+
+// Get Width
+template<typename T>
+unsigned int NeuralArenaT<T>::getWidth(unsigned int layerIdx) const
+{
+    return this->widths[layerIdx];
+}
+
+// Size
+template<typename T>
+size_t NeuralArenaT<T>::size() const
+{
+    return this->storage.size();
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralArenaT<float>;
+template class NeuralArenaT<double>;
@@ -0,0 +1,330 @@
+#ifndef NEURALCHECKPOINT_H
+#include "neuralCheckpoint.hpp"
+#endif
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    /// Checkpoint file header (128 bytes), followed by the sections in the order listed
+    struct CheckpointHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t scalarSize;
+        uint32_t endianMarker;
+        uint32_t cycle;
+        uint32_t rowCount;
+        uint32_t convergenceCount;
+        uint32_t optimizerType;
+        uint32_t layerCount;
+        uint32_t indexCount;
+        uint32_t blindCount;
+        uint32_t generatorSize;
+        uint32_t reserved;
+        uint64_t optimizerSteps;
+        uint64_t weightCount;
+        uint64_t stateCount;
+        double bestLoss;
+        double epochLoss;
+        double blindLoss;
+        uint8_t padding[24];
+    };
+
+    const char CHECKPOINT_MAGIC[8] = {'A', 'D', 'A', 'M', 'C', 'K', 'P', 'T'};
+    const uint32_t CHECKPOINT_ENDIAN_MARKER = 0x01020304;
+
+    static_assert(sizeof(CheckpointHeader) == 128, "checkpoint header must be 128 bytes");
+    static_assert(sizeof(int) == sizeof(uint32_t), "row indexes are written as 32 bit values");
+}
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Constructor with checkpoint file
+template<typename T>
+NeuralCheckpointT<T>::NeuralCheckpointT(const std::string &path)
+{
+    this->path = path;
+    this->filling = -1;
+    this->pending = -1;
+    this->writing = -1;
+    this->written = 0;
+    this->stopping = false;
+
+    // Only a checkpoint with somewhere to go needs a writer
+    if (!this->path.empty())
+    {
+        this->writer = std::thread(&NeuralCheckpointT<T>::writerLoop, this);
+    }
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+template<typename T>
+NeuralCheckpointT<T>::~NeuralCheckpointT()
+{
+    if (!this->writer.joinable())
+    {
+        return;
+    }
+
+    // The writer drains the waiting snapshot before it exits
+    {
+        std::lock_guard<std::mutex> lock(this->checkpointMutex);
+        this->stopping = true;
+    }
+    this->snapshotPosted.notify_all();
+    this->writer.join();
+}
+
+/*********************** GETTERS ***********************************/
+
+// Is Enabled?
+template<typename T>
+bool NeuralCheckpointT<T>::isEnabled() const
+{
+    return !this->path.empty();
+}
+
+// Get Written Count
+template<typename T>
+unsigned long NeuralCheckpointT<T>::getWrittenCount()
+{
+    std::lock_guard<std::mutex> lock(this->checkpointMutex);
+    return this->written;
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Acquire Buffer
+template<typename T>
+NeuralSnapshotT<T> * NeuralCheckpointT<T>::acquire()
+{
+    if (!this->isEnabled())
+    {
+        return nullptr;
+    }
+
+    // A snapshot the writer has not picked up yet is stale, fill over it
+    std::lock_guard<std::mutex> lock(this->checkpointMutex);
+    if (this->pending >= 0)
+    {
+        this->filling = this->pending;
+        this->pending = -1;
+    }
+    else
+    {
+        this->filling = (this->writing == 0) ? 1 : 0;
+    }
+    return &this->buffers[this->filling];
+}
+
+// Publish Buffer
+template<typename T>
+void NeuralCheckpointT<T>::publish()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->checkpointMutex);
+        if (this->filling < 0)
+        {
+            return;
+        }
+        this->pending = this->filling;
+        this->filling = -1;
+    }
+    this->snapshotPosted.notify_one();
+}
+
+// Flush
+template<typename T>
+void NeuralCheckpointT<T>::flush()
+{
+    if (!this->isEnabled())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(this->checkpointMutex);
+    this->snapshotWritten.wait(lock, [this] { return this->pending < 0 && this->writing < 0; });
+}
+
+// Read Checkpoint
+template<typename T>
+bool NeuralCheckpointT<T>::read(const std::string &path, NeuralSnapshotT<T> *snapshot)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cout << "Error: unable to open " << path << " for reading" << std::endl;
+        return false;
+    }
+
+    // Check the header describes a checkpoint this build can read
+    CheckpointHeader header;
+    if (!file.read((char *)&header, sizeof(header)) ||
+        std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CHECKPOINT_VERSION || header.endianMarker != CHECKPOINT_ENDIAN_MARKER)
+    {
+        std::cout << "Error: " << path << " is not a checkpoint of this version" << std::endl;
+        return false;
+    }
+    if (header.scalarSize != sizeof(T))
+    {
+        std::cout << "Error: " << path << " was written at a different precision" << std::endl;
+        return false;
+    }
+
+    // Every section must fit in what is left of the file, so a corrupt count
+    // is caught before it is allocated
+    const std::streampos sectionsStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    uint64_t remaining = (uint64_t)(file.tellg() - sectionsStart);
+    file.seekg(sectionsStart);
+    const auto fits = [&remaining](uint64_t count, uint64_t size)
+    {
+        if (count > remaining / size)
+        {
+            return false;
+        }
+        remaining -= count * size;
+        return true;
+    };
+    if (!fits((uint64_t)header.layerCount * 3, sizeof(unsigned int)) || !fits(header.weightCount, sizeof(T)) ||
+        !fits(header.stateCount, sizeof(T)) || !fits(header.indexCount, sizeof(int)) ||
+        !fits(header.blindCount, sizeof(unsigned int)) || !fits(header.generatorSize, 1))
+    {
+        std::cout << "Error: " << path << " is truncated or its section counts are corrupt" << std::endl;
+        return false;
+    }
+
+    snapshot->cycle = header.cycle;
+    snapshot->rowCount = header.rowCount;
+    snapshot->convergenceCount = header.convergenceCount;
+    snapshot->bestLoss = header.bestLoss;
+    snapshot->epochLoss = header.epochLoss;
+    snapshot->blindLoss = header.blindLoss;
+    snapshot->optimizerType = header.optimizerType;
+    snapshot->optimizerSteps = header.optimizerSteps;
+    snapshot->shape.resize((size_t)header.layerCount * 3);
+    snapshot->weights.resize(header.weightCount);
+    snapshot->optimizerState.resize(header.stateCount);
+    snapshot->indexes.resize(header.indexCount);
+    snapshot->blindIndexes.resize(header.blindCount);
+    snapshot->generatorState.resize(header.generatorSize);
+
+    file.read((char *)snapshot->shape.data(), snapshot->shape.size() * sizeof(unsigned int));
+    file.read((char *)snapshot->weights.data(), snapshot->weights.size() * sizeof(T));
+    file.read((char *)snapshot->optimizerState.data(), snapshot->optimizerState.size() * sizeof(T));
+    file.read((char *)snapshot->indexes.data(), snapshot->indexes.size() * sizeof(int));
+    file.read((char *)snapshot->blindIndexes.data(), snapshot->blindIndexes.size() * sizeof(unsigned int));
+    file.read(&snapshot->generatorState[0], snapshot->generatorState.size());
+    if (!file.good())
+    {
+        std::cout << "Error: " << path << " is truncated" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*********************** PRIVATE FUNCTIONS *************************/
+
+// Writer Loop
+template<typename T>
+void NeuralCheckpointT<T>::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(this->checkpointMutex);
+    while (true)
+    {
+        // Park until a snapshot is waiting, exit once stopped with none left
+        this->snapshotPosted.wait(lock, [this] { return this->stopping || this->pending >= 0; });
+        if (this->pending < 0)
+        {
+            return;
+        }
+        this->writing = this->pending;
+        this->pending = -1;
+
+        // Do the I/O outside the lock, the trainer fills the other buffer meanwhile
+        lock.unlock();
+        const bool success = this->write(this->buffers[this->writing]);
+        lock.lock();
+
+        this->written += success ? 1 : 0;
+        this->writing = -1;
+        this->snapshotWritten.notify_all();
+    }
+}
+
+// Write Checkpoint
+template<typename T>
+bool NeuralCheckpointT<T>::write(const NeuralSnapshotT<T> &snapshot)
+{
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.scalarSize = sizeof(T);
+    header.endianMarker = CHECKPOINT_ENDIAN_MARKER;
+    header.cycle = snapshot.cycle;
+    header.rowCount = snapshot.rowCount;
+    header.convergenceCount = snapshot.convergenceCount;
+    header.optimizerType = snapshot.optimizerType;
+    header.layerCount = (uint32_t)(snapshot.shape.size() / 3);
+    header.indexCount = (uint32_t)snapshot.indexes.size();
+    header.blindCount = (uint32_t)snapshot.blindIndexes.size();
+    header.generatorSize = (uint32_t)snapshot.generatorState.size();
+    header.optimizerSteps = snapshot.optimizerSteps;
+    header.weightCount = snapshot.weights.size();
+    header.stateCount = snapshot.optimizerState.size();
+    header.bestLoss = snapshot.bestLoss;
+    header.epochLoss = snapshot.epochLoss;
+    header.blindLoss = snapshot.blindLoss;
+
+    // Written beside the target, then renamed over it
+    const std::string temporary = this->path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            std::cout << "Error: unable to open " << temporary << " for writing" << std::endl;
+            return false;
+        }
+        file.write((const char *)&header, sizeof(header));
+        file.write((const char *)snapshot.shape.data(), snapshot.shape.size() * sizeof(unsigned int));
+        file.write((const char *)snapshot.weights.data(), snapshot.weights.size() * sizeof(T));
+        file.write((const char *)snapshot.optimizerState.data(), snapshot.optimizerState.size() * sizeof(T));
+        file.write((const char *)snapshot.indexes.data(), snapshot.indexes.size() * sizeof(int));
+        file.write((const char *)snapshot.blindIndexes.data(), snapshot.blindIndexes.size() * sizeof(unsigned int));
+        file.write(snapshot.generatorState.data(), snapshot.generatorState.size());
+        if (!file.good())
+        {
+            std::cout << "Error: failed writing " << temporary << std::endl;
+            return false;
+        }
+    }
+
+    // Make sure the data is on disk before the rename makes it the checkpoint
+    const int descriptor = open(temporary.c_str(), O_RDONLY);
+    if (descriptor >= 0)
+    {
+        fsync(descriptor);
+        close(descriptor);
+    }
+    if (std::rename(temporary.c_str(), this->path.c_str()) != 0)
+    {
+        std::cout << "Error: unable to replace " << this->path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralCheckpointT<float>;
+template class NeuralCheckpointT<double>;
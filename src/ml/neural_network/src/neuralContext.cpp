@@ -0,0 +1,77 @@
+#ifndef NEURALCONTEXT_H
+#include "neuralContext.hpp"
+#endif
+
+#include <utility>
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Default
+template<typename T>
+NeuralContextT<T>::NeuralContextT()
+{
+    this->width = 0;
+}
+
+// Constructor with reserved width
+template<typename T>
+NeuralContextT<T>::NeuralContextT(unsigned int width): NeuralContextT()
+{
+    this->reserve(width);
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+template<typename T>
+NeuralContextT<T>::~NeuralContextT()
+{
+    // This object maintains ownership of data, no pointers to clean up
+}
+
+/*********************** GETTERS ***********************************/
+
+// Get Width
+template<typename T>
+unsigned int NeuralContextT<T>::getWidth() const
+{
+    return this->width;
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Reserve
+template<typename T>
+void NeuralContextT<T>::reserve(unsigned int width)
+{
+    if (width > this->width)
+    {
+        this->front.assign(width, 0);
+        this->back.assign(width, 0);
+        this->width = width;
+    }
+}
+
+// Next Layer Buffer
+template<typename T>
+T * NeuralContextT<T>::next()
+{
+    // The buffer handed out last is still being read as the layer input
+    std::swap(this->front, this->back);
+    return this->back.data();
+}
+
+// Stage Rows
+template<typename T>
+T * NeuralContextT<T>::stage(size_t count)
+{
+    if (count > this->staging.size())
+    {
+        this->staging.resize(count);
+    }
+    return this->staging.data();
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralContextT<float>;
+template class NeuralContextT<double>;
@@ -0,0 +1,359 @@
+#ifndef NEURALDATASTREAM_H
+#include "neuralDataStream.hpp"
+#endif
+
+#include <climits>
+#include <cstring>
+#include <charconv>
+#include <iostream>
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Constructor with file and column mapping
+template<typename T>
+NeuralDataStreamT<T>::NeuralDataStreamT(const std::string &path, const std::vector<unsigned int> &inputColumns,
+                                        const std::vector<unsigned int> &truthColumns, char delimiter, bool header)
+{
+    this->path = path;
+    this->inputCount = (unsigned int)inputColumns.size();
+    this->truthCount = (unsigned int)truthColumns.size();
+    this->delimiter = delimiter;
+    this->header = header;
+    this->passDone = true;
+    this->stopping = false;
+    this->rowCount = 0;
+    this->skippedRows = 0;
+    this->mappingValid = true;
+
+    // Map each column straight to its slot, so a row is parsed in one sweep
+    for (unsigned int i = 0; i < this->inputCount; i++)
+    {
+        if (inputColumns[i] >= this->columnSlots.size())
+        {
+            this->columnSlots.resize(inputColumns[i] + 1, INT_MIN);
+        }
+        if (this->columnSlots[inputColumns[i]] != INT_MIN)
+        {
+            // One of the two input slots would never be filled
+            std::cout << "Error: input column " << inputColumns[i] << " listed twice, the stream will not read" << std::endl;
+            this->mappingValid = false;
+        }
+        this->columnSlots[inputColumns[i]] = (int)i;
+    }
+    for (unsigned int i = 0; i < this->truthCount; i++)
+    {
+        if (truthColumns[i] >= this->columnSlots.size())
+        {
+            this->columnSlots.resize(truthColumns[i] + 1, INT_MIN);
+        }
+        if (this->columnSlots[truthColumns[i]] != INT_MIN)
+        {
+            std::cout << "Warning: column " << truthColumns[i] << " mapped twice, using it as a truth" << std::endl;
+        }
+        this->columnSlots[truthColumns[i]] = -1 - (int)i;
+    }
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+template<typename T>
+NeuralDataStreamT<T>::~NeuralDataStreamT()
+{
+    this->stop();
+}
+
+/*********************** GETTERS ***********************************/
+
+// Get Input Count
+template<typename T>
+unsigned int NeuralDataStreamT<T>::getInputCount() const
+{
+    return this->inputCount;
+}
+
+// Get Truth Count
+template<typename T>
+unsigned int NeuralDataStreamT<T>::getTruthCount() const
+{
+    return this->truthCount;
+}
+
+// Get Row Count
+template<typename T>
+unsigned long NeuralDataStreamT<T>::getRowCount()
+{
+    std::lock_guard<std::mutex> lock(this->streamMutex);
+    return this->rowCount;
+}
+
+// Get Skipped Rows
+template<typename T>
+unsigned long NeuralDataStreamT<T>::getSkippedRows()
+{
+    std::lock_guard<std::mutex> lock(this->streamMutex);
+    return this->skippedRows;
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Rewind
+template<typename T>
+bool NeuralDataStreamT<T>::rewind()
+{
+    this->stop();
+    if (!this->mappingValid)
+    {
+        std::cout << "Error: " << this->path << " has a column mapped twice, not reading" << std::endl;
+        return false;
+    }
+
+    this->file.close();
+    this->file.clear();
+    this->file.open(this->path, std::ios::binary);
+    if (!this->file.is_open())
+    {
+        std::cout << "Error: could not open " << this->path << std::endl;
+        return false;
+    }
+
+    this->passDone = false;
+    this->stopping = false;
+    this->rowCount = 0;
+    this->skippedRows = 0;
+    this->reader = std::thread(&NeuralDataStreamT<T>::readPass, this);
+    return true;
+}
+
+// Next Block
+template<typename T>
+bool NeuralDataStreamT<T>::nextBlock(NeuralDataBlockT<T> *block)
+{
+    std::unique_lock<std::mutex> lock(this->streamMutex);
+    this->blockQueued.wait(lock, [this] { return !this->queued.empty() || this->passDone; });
+    if (this->queued.empty())
+    {
+        return false;
+    }
+
+    // Hand the block out, and the caller's old block back to the reader
+    std::swap(*block, this->queued.front());
+    if (!this->queued.front().inputs.empty())
+    {
+        this->spares.push_back(std::move(this->queued.front()));
+    }
+    this->queued.pop_front();
+    lock.unlock();
+    this->blockTaken.notify_one();
+    return true;
+}
+
+// Stop
+template<typename T>
+void NeuralDataStreamT<T>::stop()
+{
+    if (this->reader.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->streamMutex);
+            this->stopping = true;
+        }
+        this->blockTaken.notify_all();
+        this->reader.join();
+    }
+
+    // Recycle whatever the consumer never took
+    while (!this->queued.empty())
+    {
+        this->spares.push_back(std::move(this->queued.front()));
+        this->queued.pop_front();
+    }
+    this->passDone = true;
+}
+
+// Read Pass (reader thread)
+template<typename T>
+void NeuralDataStreamT<T>::readPass()
+{
+    NeuralDataBlockT<T> block;
+    block.rows = 0;
+    if (!this->queueBlock(&block, 0))
+    {
+        return;
+    }
+
+    // One spare byte holds a terminator after the data
+    std::vector<char> buffer(READ_CHUNK + 1);
+    size_t carry = 0;
+    unsigned long skipped = 0;
+    bool skipHeader = this->header;
+    bool endOfFile = false;
+
+    while (!endOfFile)
+    {
+        this->file.read(buffer.data() + carry, buffer.size() - 1 - carry);
+        const size_t end = carry + (size_t)this->file.gcount();
+        endOfFile = this->file.gcount() == 0 || this->file.eof();
+        buffer[end] = '\0';
+
+        // Every complete line, and the unterminated last line at the end of the file
+        const char *lineStart = buffer.data();
+        const char *bufferEnd = buffer.data() + end;
+        while (lineStart < bufferEnd)
+        {
+            const char *lineEnd = (const char *)std::memchr(lineStart, '\n', bufferEnd - lineStart);
+            if (!lineEnd)
+            {
+                if (!endOfFile)
+                {
+                    break;
+                }
+                lineEnd = bufferEnd;
+            }
+
+            const char *contentEnd = (lineEnd > lineStart && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+            if (skipHeader)
+            {
+                skipHeader = false;
+            }
+            else if (contentEnd > lineStart)
+            {
+                if (!this->parseLine(lineStart, contentEnd, &block))
+                {
+                    skipped++;
+                }
+                else if (block.rows == BLOCK_ROWS)
+                {
+                    if (!this->queueBlock(&block, skipped))
+                    {
+                        return;
+                    }
+                    skipped = 0;
+                }
+            }
+            lineStart = lineEnd + 1;
+        }
+
+        // Carry the partial line over, growing the buffer for a line longer than it
+        carry = (lineStart < bufferEnd) ? bufferEnd - lineStart : 0;
+        std::memmove(buffer.data(), lineStart, carry);
+        if (carry == buffer.size() - 1)
+        {
+            buffer.resize(buffer.size() * 2);
+        }
+    }
+
+    // The final, partial block
+    if (block.rows > 0 || skipped > 0)
+    {
+        this->queueBlock(&block, skipped);
+    }
+
+    std::lock_guard<std::mutex> lock(this->streamMutex);
+    this->passDone = true;
+    this->blockQueued.notify_all();
+}
+
+// Parse Line
+template<typename T>
+bool NeuralDataStreamT<T>::parseLine(const char *begin, const char *end, NeuralDataBlockT<T> *block)
+{
+    T *inputs = block->inputs.data() + (size_t)block->rows * this->inputCount;
+    T *truths = block->truths.data() + (size_t)block->rows * this->truthCount;
+    const unsigned int columns = (unsigned int)this->columnSlots.size();
+
+    const char *field = begin;
+    for (unsigned int column = 0; column < columns; column++)
+    {
+        if (field > end)
+        {
+            return false;
+        }
+        const char *fieldEnd = (const char *)std::memchr(field, this->delimiter, end - field);
+        fieldEnd = fieldEnd ? fieldEnd : end;
+
+        const int slot = this->columnSlots[column];
+        if (slot != INT_MIN)
+        {
+            // Leading / trailing spaces and a leading plus sign are accepted
+            const char *start = field;
+            while (start < fieldEnd && *start == ' ')
+            {
+                start++;
+            }
+            if (start < fieldEnd && *start == '+')
+            {
+                start++;
+            }
+
+            T value;
+            std::from_chars_result result = std::from_chars(start, fieldEnd, value);
+            if (result.ec != std::errc())
+            {
+                return false;
+            }
+            for (const char *rest = result.ptr; rest < fieldEnd; rest++)
+            {
+                if (*rest != ' ')
+                {
+                    return false;
+                }
+            }
+
+            if (slot >= 0)
+            {
+                inputs[slot] = value;
+            }
+            else
+            {
+                truths[-1 - slot] = value;
+            }
+        }
+        field = fieldEnd + 1;
+    }
+
+    block->rows++;
+    return true;
+}
+
+// Queue Block
+template<typename T>
+bool NeuralDataStreamT<T>::queueBlock(NeuralDataBlockT<T> *block, unsigned long skipped)
+{
+    std::unique_lock<std::mutex> lock(this->streamMutex);
+    this->skippedRows += skipped;
+
+    // An empty block (the very first call) is only swapped for a fresh one
+    if (block->rows > 0)
+    {
+        this->blockTaken.wait(lock, [this] { return this->queued.size() < QUEUE_DEPTH || this->stopping; });
+        if (this->stopping)
+        {
+            return false;
+        }
+        this->rowCount += block->rows;
+        this->queued.push_back(std::move(*block));
+        this->blockQueued.notify_all();
+    }
+    if (this->stopping)
+    {
+        return false;
+    }
+
+    // Reuse a consumed block if there is one
+    if (!this->spares.empty())
+    {
+        *block = std::move(this->spares.back());
+        this->spares.pop_back();
+    }
+    lock.unlock();
+
+    block->inputs.resize((size_t)BLOCK_ROWS * this->inputCount);
+    block->truths.resize((size_t)BLOCK_ROWS * this->truthCount);
+    block->rows = 0;
+    return true;
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralDataStreamT<float>;
+template class NeuralDataStreamT<double>;
@@ -0,0 +1,120 @@
+#ifndef NEURALGRADIENT_H
+#include "neuralGradient.hpp"
+#endif
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Default
+template<typename T>
+NeuralGradientT<T>::NeuralGradientT()
+{
+}
+
+// Constructor shaped from a network
+template<typename T>
+NeuralGradientT<T>::NeuralGradientT(std::vector<NeuralLayerT<T>> *network): NeuralGradientT()
+{
+    this->shape(network);
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+template<typename T>
+NeuralGradientT<T>::~NeuralGradientT()
+{
+    // This object maintains ownership of data, no pointers to clean up
+}
+
+/*********************** SETTERS ***********************************/
+
+// Shape Gradient
+template<typename T>
+void NeuralGradientT<T>::shape(std::vector<NeuralLayerT<T>> *network)
+{
+    // Check that the vector is null
+    if (!network)
+    {
+        std::cout << "Error: network pointer null" << std::endl;
+        return;
+    }
+
+    this->offsets.clear();
+    this->strides.clear();
+    this->neuronCounts.clear();
+
+    // Lay the layers out back to back
+    size_t total = 0;
+    for (NeuralLayerT<T> &layer : *network)
+    {
+        this->offsets.push_back(total);
+        this->strides.push_back(layer.getWeightStride());
+        this->neuronCounts.push_back(layer.neuronCount());
+        total += (size_t)layer.neuronCount() * layer.getWeightStride();
+    }
+
+    this->gradients.resize(total);
+    this->reset();
+}
+
+/*********************** GETTERS ***********************************/
+
+// Layer Count
+template<typename T>
+unsigned int NeuralGradientT<T>::layerCount() const
+{
+    return (unsigned int)this->offsets.size();
+}
+
+// Get Layer Gradient
+template<typename T>
+T * NeuralGradientT<T>::getLayerGradient(unsigned int layerIdx)
+{
+    return this->gradients.data() + this->offsets[layerIdx];
+}
+
+// Get Stride
+template<typename T>
+unsigned int NeuralGradientT<T>::getStride(unsigned int layerIdx) const
+{
+    return this->strides[layerIdx];
+}
+
+// Get Layer Size
+template<typename T>
+size_t NeuralGradientT<T>::getLayerSize(unsigned int layerIdx) const
+{
+    return (size_t)this->neuronCounts[layerIdx] * this->strides[layerIdx];
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Reset Gradient
+template<typename T>
+void NeuralGradientT<T>::reset()
+{
+    std::fill(this->gradients.begin(), this->gradients.end(), 0.0);
+}
+
+// Accumulate Gradient
+template<typename T>
+void NeuralGradientT<T>::accumulate(const NeuralGradientT<T> &other)
+{
+    // Check that the shapes match
+    if (other.gradients.size() != this->gradients.size())
+    {
+        std::cout << "Error: gradient shapes do not match, skipping accumulate" << std::endl;
+        return;
+    }
+
+    T *target = this->gradients.data();
+    const T *source = other.gradients.data();
+    for (size_t i = 0; i < this->gradients.size(); i++)
+    {
+        target[i] += source[i];
+    }
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralGradientT<float>;
+template class NeuralGradientT<double>;
@@ -0,0 +1,167 @@
+#ifndef NEURALINSTRUMENTATION_H
+#include "neuralInstrumentation.hpp"
+#endif
+
+#include <cstdio>
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Default
+NeuralInstrumentation::NeuralInstrumentation()
+{
+    this->layers = 0;
+}
+
+// Copy
+NeuralInstrumentation::NeuralInstrumentation(const NeuralInstrumentation &other): NeuralInstrumentation()
+{
+    *this = other;
+}
+
+// Copy Assignment
+NeuralInstrumentation & NeuralInstrumentation::operator=(const NeuralInstrumentation &other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    this->shape(other.layers);
+    std::vector<NeuralLayerTiming> totals = other.snapshot();
+    for (unsigned int layerIdx = 0; layerIdx < this->layers; layerIdx++)
+    {
+        LayerCounters &layer = this->counters[layerIdx];
+        layer.forwardNs.store(totals[layerIdx].forwardNs, std::memory_order_relaxed);
+        layer.forwardSamples.store(totals[layerIdx].forwardSamples, std::memory_order_relaxed);
+        layer.backwardNs.store(totals[layerIdx].backwardNs, std::memory_order_relaxed);
+        layer.backwardSamples.store(totals[layerIdx].backwardSamples, std::memory_order_relaxed);
+        layer.updateNs.store(totals[layerIdx].updateNs, std::memory_order_relaxed);
+        layer.updates.store(totals[layerIdx].updates, std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+NeuralInstrumentation::~NeuralInstrumentation()
+{
+    // This object maintains ownership of data, no pointers to clean up
+}
+
+/*********************** SETTERS ***********************************/
+
+// Shape
+void NeuralInstrumentation::shape(unsigned int layerCount)
+{
+    if (layerCount != this->layers)
+    {
+        this->counters.reset(layerCount > 0 ? new LayerCounters[layerCount] : nullptr);
+        this->layers = layerCount;
+    }
+    this->reset();
+}
+
+/*********************** GETTERS ***********************************/
+
+// Is Enabled
+bool NeuralInstrumentation::isEnabled()
+{
+#ifdef ADAM_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Layer Count
+unsigned int NeuralInstrumentation::layerCount() const
+{
+    return this->layers;
+}
+
+// Snapshot
+std::vector<NeuralLayerTiming> NeuralInstrumentation::snapshot() const
+{
+    std::vector<NeuralLayerTiming> totals(this->layers);
+    for (unsigned int layerIdx = 0; layerIdx < this->layers; layerIdx++)
+    {
+        const LayerCounters &layer = this->counters[layerIdx];
+        totals[layerIdx].forwardNs = layer.forwardNs.load(std::memory_order_relaxed);
+        totals[layerIdx].forwardSamples = layer.forwardSamples.load(std::memory_order_relaxed);
+        totals[layerIdx].backwardNs = layer.backwardNs.load(std::memory_order_relaxed);
+        totals[layerIdx].backwardSamples = layer.backwardSamples.load(std::memory_order_relaxed);
+        totals[layerIdx].updateNs = layer.updateNs.load(std::memory_order_relaxed);
+        totals[layerIdx].updates = layer.updates.load(std::memory_order_relaxed);
+    }
+    return totals;
+}
+
+// To Text
+std::string NeuralInstrumentation::toText() const
+{
+    if (!NeuralInstrumentation::isEnabled())
+    {
+        return "Instrumentation disabled (build with -DADAM_INSTRUMENTATION)\n";
+    }
+
+    // Mean time per sample (per update) alongside the totals
+    char line[256];
+    std::string text;
+    std::snprintf(line, sizeof(line), "%5s %12s %12s %10s %12s %12s %10s %12s %10s %10s\n", "layer",
+                  "forward_ms", "fwd_samples", "fwd_ns", "backward_ms", "bwd_samples", "bwd_ns",
+                  "update_ms", "updates", "upd_ns");
+    text += line;
+
+    std::vector<NeuralLayerTiming> totals = this->snapshot();
+    for (unsigned int layerIdx = 0; layerIdx < totals.size(); layerIdx++)
+    {
+        const NeuralLayerTiming &timing = totals[layerIdx];
+        std::snprintf(line, sizeof(line), "%5u %12.3f %12llu %10.1f %12.3f %12llu %10.1f %12.3f %10llu %10.1f\n",
+                      layerIdx,
+                      timing.forwardNs / 1e6, (unsigned long long)timing.forwardSamples,
+                      timing.forwardSamples ? (double)timing.forwardNs / timing.forwardSamples : 0.0,
+                      timing.backwardNs / 1e6, (unsigned long long)timing.backwardSamples,
+                      timing.backwardSamples ? (double)timing.backwardNs / timing.backwardSamples : 0.0,
+                      timing.updateNs / 1e6, (unsigned long long)timing.updates,
+                      timing.updates ? (double)timing.updateNs / timing.updates : 0.0);
+        text += line;
+    }
+    return text;
+}
+
+// To Json
+std::string NeuralInstrumentation::toJson() const
+{
+    std::string json = std::string("{\"enabled\": ") + (NeuralInstrumentation::isEnabled() ? "true" : "false")
+                     + ", \"layers\": [";
+    std::vector<NeuralLayerTiming> totals = this->snapshot();
+    for (unsigned int layerIdx = 0; layerIdx < totals.size(); layerIdx++)
+    {
+        char entry[256];
+        std::snprintf(entry, sizeof(entry), "%s{\"layer\": %u, \"forward_ns\": %llu, \"forward_samples\": %llu, "
+                      "\"backward_ns\": %llu, \"backward_samples\": %llu, \"update_ns\": %llu, \"updates\": %llu}",
+                      (layerIdx > 0) ? ", " : "", layerIdx,
+                      (unsigned long long)totals[layerIdx].forwardNs, (unsigned long long)totals[layerIdx].forwardSamples,
+                      (unsigned long long)totals[layerIdx].backwardNs, (unsigned long long)totals[layerIdx].backwardSamples,
+                      (unsigned long long)totals[layerIdx].updateNs, (unsigned long long)totals[layerIdx].updates);
+        json += entry;
+    }
+    return json + "]}";
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Reset
+void NeuralInstrumentation::reset()
+{
+    for (unsigned int layerIdx = 0; layerIdx < this->layers; layerIdx++)
+    {
+        LayerCounters &layer = this->counters[layerIdx];
+        layer.forwardNs.store(0, std::memory_order_relaxed);
+        layer.forwardSamples.store(0, std::memory_order_relaxed);
+        layer.backwardNs.store(0, std::memory_order_relaxed);
+        layer.backwardSamples.store(0, std::memory_order_relaxed);
+        layer.updateNs.store(0, std::memory_order_relaxed);
+        layer.updates.store(0, std::memory_order_relaxed);
+    }
+}
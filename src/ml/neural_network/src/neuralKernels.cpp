@@ -0,0 +1,2002 @@
+#ifndef NEURALKERNELS_H
+#include "neuralKernels.hpp"
+#endif
+
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NEURALKERNELS_X86
+#include <immintrin.h>
+#endif
+
+/*********************** SCALAR KERNELS ****************************/
+
+// Dot Product - four accumulators
+template<typename T>
+static T dotScalar(const T *a, const T *b, unsigned int n)
+{
+    T sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        sum0 += a[i] * b[i];
+        sum1 += a[i + 1] * b[i + 1];
+        sum2 += a[i + 2] * b[i + 2];
+        sum3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++)
+    {
+        sum0 += a[i] * b[i];
+    }
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
+// Dot Product (one against four)
+template<typename T>
+static void dot4Scalar(const T *w, const T *x0, const T *x1,
+                       const T *x2, const T *x3, unsigned int n, T *sums)
+{
+    T sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+    for (unsigned int i = 0; i < n; i++)
+    {
+        sum0 += w[i] * x0[i];
+        sum1 += w[i] * x1[i];
+        sum2 += w[i] * x2[i];
+        sum3 += w[i] * x3[i];
+    }
+    sums[0] = sum0;
+    sums[1] = sum1;
+    sums[2] = sum2;
+    sums[3] = sum3;
+}
+
+// Axpy
+template<typename T>
+static void axpyScalar(T alpha, const T *x, T *y, unsigned int n)
+{
+    for (unsigned int i = 0; i < n; i++)
+    {
+        y[i] += alpha * x[i];
+    }
+}
+
+// Momentum Step, one weight
+template<typename T>
+__attribute__((always_inline)) static inline void momentumLane(T &w, T &velocity, T g, T scale, T momentum,
+                                                               T gradientShare, T velocityShare)
+{
+    const T gi = scale * g;
+    velocity = momentum * velocity + gi;
+    w -= gradientShare * gi + velocityShare * velocity;
+}
+
+// RMSProp Step, one weight
+template<typename T>
+__attribute__((always_inline)) static inline void rmspropLane(T &w, T &meanSquare, T g, T scale, T rate,
+                                                              T decay, T epsilon)
+{
+    const T gi = scale * g;
+    meanSquare = decay * meanSquare + (1 - decay) * (gi * gi);
+    w -= (rate * gi) / (std::sqrt(meanSquare) + epsilon);
+}
+
+// Adam Step, one weight
+template<typename T>
+__attribute__((always_inline)) static inline void adamLane(T &w, T &m, T &v, T g, T scale, T rate,
+                                                           T beta1, T beta2, T epsilon)
+{
+    const T gi = scale * g;
+    m = beta1 * m + (1 - beta1) * gi;
+    v = beta2 * v + (1 - beta2) * (gi * gi);
+    w -= (rate * m) / (std::sqrt(v) + epsilon);
+}
+
+// Momentum Step (heavy ball, or Nesterov look ahead)
+template<typename T>
+static void momentumScalar(T *w, T *velocity, const T *g, unsigned int n,
+                           T scale, T rate, T momentum, bool nesterov)
+{
+    const T gradientShare = nesterov ? rate : 0;
+    const T velocityShare = nesterov ? rate * momentum : rate;
+    for (unsigned int i = 0; i < n; i++)
+    {
+        momentumLane(w[i], velocity[i], g[i], scale, momentum, gradientShare, velocityShare);
+    }
+}
+
+// RMSProp Step
+template<typename T>
+static void rmspropScalar(T *w, T *meanSquare, const T *g, unsigned int n,
+                          T scale, T rate, T decay, T epsilon)
+{
+    for (unsigned int i = 0; i < n; i++)
+    {
+        rmspropLane(w[i], meanSquare[i], g[i], scale, rate, decay, epsilon);
+    }
+}
+
+// Adam Step
+template<typename T>
+static void adamScalar(T *w, T *m, T *v, const T *g, unsigned int n,
+                       T scale, T rate, T beta1, T beta2, T epsilon)
+{
+    for (unsigned int i = 0; i < n; i++)
+    {
+        adamLane(w[i], m[i], v[i], g[i], scale, rate, beta1, beta2, epsilon);
+    }
+}
+
+// The constants of the activation kernels, per precision.  exp(t) is range
+// reduced to 2^k * exp(r), |r| <= ln2 / 2, with ln2 split so k * LN2_HI is exact.
+template<typename T>
+struct ActivationConstants;
+
+template<>
+struct ActivationConstants<double>
+{
+    static constexpr double LOG2E = 1.4426950408889634;
+    static constexpr double LN2_HI = 6.93147180369123816490e-01;
+    static constexpr double LN2_LO = 1.90821492927058770002e-10;
+    static constexpr double EXP_MIN = -708.0;       // exp(t) stays normal
+    static constexpr double EXP_MAX = 710.0;        // exp(t) overflows past here
+    static constexpr double TANH_MAX = 40.0;        // tanh(t / 2) rounds to 1 past here
+    static constexpr double ROUNDER = 6755399441055744.0; // 1.5 * 2^52, adding it rounds to an integer
+    static constexpr int MANTISSA_BITS = 52;
+    static constexpr int EXPONENT_BIAS = 1023;
+    static constexpr unsigned int EXACT_DEGREE = 13;
+    static constexpr unsigned int FAST_DEGREE = 5;
+};
+
+template<>
+struct ActivationConstants<float>
+{
+    static constexpr float LOG2E = 1.44269504f;
+    static constexpr float LN2_HI = 0.693359375f;
+    static constexpr float LN2_LO = -2.12194440e-4f;
+    static constexpr float EXP_MIN = -80.0f;
+    static constexpr float EXP_MAX = 89.0f;
+    static constexpr float TANH_MAX = 20.0f;
+    static constexpr float ROUNDER = 12582912.0f;
+    static constexpr int MANTISSA_BITS = 23;
+    static constexpr int EXPONENT_BIAS = 127;
+    static constexpr unsigned int EXACT_DEGREE = 7;
+    static constexpr unsigned int FAST_DEGREE = 5;
+};
+
+// Taylor coefficients of exp, 1 / d!
+static const double EXP_TAYLOR[] = {1.0, 1.0, 0.5, 0.16666666666666666, 0.041666666666666664,
+                                    0.008333333333333333, 0.001388888888888889, 0.0001984126984126984,
+                                    2.48015873015873e-05, 2.7557319223985893e-06, 2.755731922398589e-07,
+                                    2.505210838544172e-08, 2.08767569878681e-09, 1.6059043836821613e-10};
+
+// Exponential Parts - returns expm1(r) and sets half to 2^(k - 1), for t = k * ln2 + r
+template<typename T, unsigned int DEGREE>
+__attribute__((always_inline)) static inline T expm1Parts(T t, T &half)
+{
+    typedef ActivationConstants<T> C;
+
+    // Round to nearest even, as the vector lanes do
+    const T k = (t * C::LOG2E + C::ROUNDER) - C::ROUNDER;
+    T r = t - k * C::LN2_HI;
+    r = r - k * C::LN2_LO;
+
+    T p = (T)EXP_TAYLOR[DEGREE];
+    for (int d = DEGREE - 1; d >= 1; d--)
+    {
+        p = p * r + (T)EXP_TAYLOR[d];
+    }
+    // 2^(k - 1) straight from the exponent bits
+    typedef typename std::conditional<sizeof(T) == 8, uint64_t, uint32_t>::type Bits;
+    const Bits bits = (Bits)((long long)k - 1 + C::EXPONENT_BIAS) << C::MANTISSA_BITS;
+    std::memcpy(&half, &bits, sizeof(T));
+    return p * r;
+}
+
+// Sigmoid, one value: 1 / (1 + exp(-x))
+template<typename T, unsigned int DEGREE>
+__attribute__((always_inline)) static inline T sigmoidLane(T x)
+{
+    typedef ActivationConstants<T> C;
+    if (x != x)
+    {
+        return x;
+    }
+
+    // Clamped so 2^k stays representable, exp(-x) still overflows to infinity past EXP_MAX
+    T t = -x;
+    t = (t < C::EXP_MIN) ? C::EXP_MIN : t;
+    t = (t > C::EXP_MAX) ? C::EXP_MAX : t;
+    T half;
+    const T q = expm1Parts<T, DEGREE>(t, half);
+    const T e = (half * q + half) * 2;
+    return 1 / (1 + e);
+}
+
+// Hyperbolic Tangent, one value: expm1(2|x|) / (expm1(2|x|) + 2), signed
+template<typename T, unsigned int DEGREE>
+__attribute__((always_inline)) static inline T tanhLane(T x)
+{
+    typedef ActivationConstants<T> C;
+    if (x != x)
+    {
+        return x;
+    }
+
+    T t = 2 * std::fabs(x);
+    t = (t > C::TANH_MAX) ? C::TANH_MAX : t;
+    T half;
+    const T q = expm1Parts<T, DEGREE>(t, half);
+    const T em = (half * q + (half - (T)0.5)) * 2;
+    return std::copysign(em / (em + 2), x);
+}
+
+// Sigmoid
+template<typename T>
+static void sigmoidScalar(const T *x, T *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<T> C;
+    if (fast)
+    {
+        for (unsigned int i = 0; i < n; i++)
+        {
+            y[i] = sigmoidLane<T, C::FAST_DEGREE>(x[i]);
+        }
+        return;
+    }
+    for (unsigned int i = 0; i < n; i++)
+    {
+        y[i] = sigmoidLane<T, C::EXACT_DEGREE>(x[i]);
+    }
+}
+
+// Hyperbolic Tangent
+template<typename T>
+static void tanhScalar(const T *x, T *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<T> C;
+    if (fast)
+    {
+        for (unsigned int i = 0; i < n; i++)
+        {
+            y[i] = tanhLane<T, C::FAST_DEGREE>(x[i]);
+        }
+        return;
+    }
+    for (unsigned int i = 0; i < n; i++)
+    {
+        y[i] = tanhLane<T, C::EXACT_DEGREE>(x[i]);
+    }
+}
+
+// Dot Product (int8, int32 accumulation)
+static int32_t dotScalarI8(const int8_t *a, const int8_t *b, unsigned int n)
+{
+    int32_t sum = 0;
+    for (unsigned int i = 0; i < n; i++)
+    {
+        sum += (int32_t)a[i] * b[i];
+    }
+    return sum;
+}
+
+#ifdef NEURALKERNELS_X86
+
+/*********************** SSE2 KERNELS ******************************/
+
+// Dot Product - four accumulators of two lanes
+__attribute__((target("sse2")))
+static double dotSse2(const double *a, const double *b, unsigned int n)
+{
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    __m128d acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+        acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4)));
+        acc3 = _mm_add_pd(acc3, _mm_mul_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6)));
+    }
+    for (; i + 2 <= n; i += 2)
+    {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+    __m128d acc = _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    for (; i < n; i++)
+    {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// Dot Product (one against four)
+__attribute__((target("sse2")))
+static void dot4Sse2(const double *w, const double *x0, const double *x1,
+                     const double *x2, const double *x3, unsigned int n, double *sums)
+{
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    __m128d acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d weight = _mm_loadu_pd(w + i);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(weight, _mm_loadu_pd(x0 + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(weight, _mm_loadu_pd(x1 + i)));
+        acc2 = _mm_add_pd(acc2, _mm_mul_pd(weight, _mm_loadu_pd(x2 + i)));
+        acc3 = _mm_add_pd(acc3, _mm_mul_pd(weight, _mm_loadu_pd(x3 + i)));
+    }
+
+    // Reduce pairwise: {acc0, acc1} and {acc2, acc3}
+    __m128d sum01 = _mm_add_pd(_mm_unpacklo_pd(acc0, acc1), _mm_unpackhi_pd(acc0, acc1));
+    __m128d sum23 = _mm_add_pd(_mm_unpacklo_pd(acc2, acc3), _mm_unpackhi_pd(acc2, acc3));
+    _mm_storeu_pd(sums, sum01);
+    _mm_storeu_pd(sums + 2, sum23);
+    for (; i < n; i++)
+    {
+        sums[0] += w[i] * x0[i];
+        sums[1] += w[i] * x1[i];
+        sums[2] += w[i] * x2[i];
+        sums[3] += w[i] * x3[i];
+    }
+}
+
+// Axpy
+__attribute__((target("sse2")))
+static void axpySse2(double alpha, const double *x, double *y, unsigned int n)
+{
+    __m128d scale = _mm_set1_pd(alpha);
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(scale, _mm_loadu_pd(x + i))));
+    }
+    for (; i < n; i++)
+    {
+        y[i] += alpha * x[i];
+    }
+}
+
+// Horizontal sum of four lanes
+__attribute__((target("sse2")))
+static inline float hsumSse2(__m128 value)
+{
+    value = _mm_add_ps(value, _mm_movehl_ps(value, value));
+    return _mm_cvtss_f32(_mm_add_ss(value, _mm_shuffle_ps(value, value, 0x55)));
+}
+
+// Sum each of four vectors into one vector of four sums
+__attribute__((target("sse2")))
+static inline __m128 transposeSumSse2(__m128 acc0, __m128 acc1, __m128 acc2, __m128 acc3)
+{
+    _MM_TRANSPOSE4_PS(acc0, acc1, acc2, acc3);
+    return _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3));
+}
+
+// Dot Product - four accumulators of four lanes (single precision)
+__attribute__((target("sse2")))
+static float dotSse2F(const float *a, const float *b, unsigned int n)
+{
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    unsigned int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+    }
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    float sum = hsumSse2(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+    for (; i < n; i++)
+    {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// Dot Product (one against four, single precision)
+__attribute__((target("sse2")))
+static void dot4Sse2F(const float *w, const float *x0, const float *x1,
+                      const float *x2, const float *x3, unsigned int n, float *sums)
+{
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 weight = _mm_loadu_ps(w + i);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(weight, _mm_loadu_ps(x0 + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(weight, _mm_loadu_ps(x1 + i)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(weight, _mm_loadu_ps(x2 + i)));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(weight, _mm_loadu_ps(x3 + i)));
+    }
+    _mm_storeu_ps(sums, transposeSumSse2(acc0, acc1, acc2, acc3));
+    for (; i < n; i++)
+    {
+        sums[0] += w[i] * x0[i];
+        sums[1] += w[i] * x1[i];
+        sums[2] += w[i] * x2[i];
+        sums[3] += w[i] * x3[i];
+    }
+}
+
+// Axpy (single precision)
+__attribute__((target("sse2")))
+static void axpySse2F(float alpha, const float *x, float *y, unsigned int n)
+{
+    __m128 scale = _mm_set1_ps(alpha);
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(scale, _mm_loadu_ps(x + i))));
+    }
+    for (; i < n; i++)
+    {
+        y[i] += alpha * x[i];
+    }
+}
+
+// Horizontal sum of four int32 lanes
+__attribute__((target("sse2")))
+static inline int32_t hsumSse2I32(__m128i value)
+{
+    value = _mm_add_epi32(value, _mm_shuffle_epi32(value, 0x4E));
+    value = _mm_add_epi32(value, _mm_shuffle_epi32(value, 0xB1));
+    return _mm_cvtsi128_si32(value);
+}
+
+// Dot Product (int8) - sign extend to 16 bits, multiply-add pairs into int32
+__attribute__((target("sse2")))
+static int32_t dotSse2I8(const int8_t *a, const int8_t *b, unsigned int n)
+{
+    __m128i acc = _mm_setzero_si128();
+    unsigned int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+
+        // Unpacking a byte against itself then shifting right sign extends it
+        __m128i aLow = _mm_srai_epi16(_mm_unpacklo_epi8(va, va), 8);
+        __m128i aHigh = _mm_srai_epi16(_mm_unpackhi_epi8(va, va), 8);
+        __m128i bLow = _mm_srai_epi16(_mm_unpacklo_epi8(vb, vb), 8);
+        __m128i bHigh = _mm_srai_epi16(_mm_unpackhi_epi8(vb, vb), 8);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(aLow, bLow));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(aHigh, bHigh));
+    }
+    int32_t sum = hsumSse2I32(acc);
+    for (; i < n; i++)
+    {
+        sum += (int32_t)a[i] * b[i];
+    }
+    return sum;
+}
+
+// Momentum Step
+__attribute__((target("sse2")))
+static void momentumSse2(double *w, double *velocity, const double *g, unsigned int n,
+                         double scale, double rate, double momentum, bool nesterov)
+{
+    const double gradientShare = nesterov ? rate : 0.0;
+    const double velocityShare = nesterov ? rate * momentum : rate;
+    const __m128d s = _mm_set1_pd(scale), mu = _mm_set1_pd(momentum);
+    const __m128d gs = _mm_set1_pd(gradientShare), vs = _mm_set1_pd(velocityShare);
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d gi = _mm_mul_pd(s, _mm_loadu_pd(g + i));
+        __m128d vel = _mm_add_pd(_mm_mul_pd(mu, _mm_loadu_pd(velocity + i)), gi);
+        _mm_storeu_pd(velocity + i, vel);
+        __m128d step = _mm_add_pd(_mm_mul_pd(gs, gi), _mm_mul_pd(vs, vel));
+        _mm_storeu_pd(w + i, _mm_sub_pd(_mm_loadu_pd(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        momentumLane(w[i], velocity[i], g[i], scale, momentum, gradientShare, velocityShare);
+    }
+}
+
+// RMSProp Step
+__attribute__((target("sse2")))
+static void rmspropSse2(double *w, double *meanSquare, const double *g, unsigned int n,
+                        double scale, double rate, double decay, double epsilon)
+{
+    const __m128d s = _mm_set1_pd(scale), r = _mm_set1_pd(rate), eps = _mm_set1_pd(epsilon);
+    const __m128d keep = _mm_set1_pd(decay), blend = _mm_set1_pd(1.0 - decay);
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d gi = _mm_mul_pd(s, _mm_loadu_pd(g + i));
+        __m128d ms = _mm_add_pd(_mm_mul_pd(keep, _mm_loadu_pd(meanSquare + i)), _mm_mul_pd(blend, _mm_mul_pd(gi, gi)));
+        _mm_storeu_pd(meanSquare + i, ms);
+        __m128d step = _mm_div_pd(_mm_mul_pd(r, gi), _mm_add_pd(_mm_sqrt_pd(ms), eps));
+        _mm_storeu_pd(w + i, _mm_sub_pd(_mm_loadu_pd(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        rmspropLane(w[i], meanSquare[i], g[i], scale, rate, decay, epsilon);
+    }
+}
+
+// Adam Step
+__attribute__((target("sse2")))
+static void adamSse2(double *w, double *m, double *v, const double *g, unsigned int n,
+                     double scale, double rate, double beta1, double beta2, double epsilon)
+{
+    const __m128d s = _mm_set1_pd(scale), r = _mm_set1_pd(rate), eps = _mm_set1_pd(epsilon);
+    const __m128d b1 = _mm_set1_pd(beta1), k1 = _mm_set1_pd(1.0 - beta1);
+    const __m128d b2 = _mm_set1_pd(beta2), k2 = _mm_set1_pd(1.0 - beta2);
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d gi = _mm_mul_pd(s, _mm_loadu_pd(g + i));
+        __m128d mi = _mm_add_pd(_mm_mul_pd(b1, _mm_loadu_pd(m + i)), _mm_mul_pd(k1, gi));
+        __m128d vi = _mm_add_pd(_mm_mul_pd(b2, _mm_loadu_pd(v + i)), _mm_mul_pd(k2, _mm_mul_pd(gi, gi)));
+        _mm_storeu_pd(m + i, mi);
+        _mm_storeu_pd(v + i, vi);
+        __m128d step = _mm_div_pd(_mm_mul_pd(r, mi), _mm_add_pd(_mm_sqrt_pd(vi), eps));
+        _mm_storeu_pd(w + i, _mm_sub_pd(_mm_loadu_pd(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        adamLane(w[i], m[i], v[i], g[i], scale, rate, beta1, beta2, epsilon);
+    }
+}
+
+// Momentum Step (single precision)
+__attribute__((target("sse2")))
+static void momentumSse2F(float *w, float *velocity, const float *g, unsigned int n,
+                          float scale, float rate, float momentum, bool nesterov)
+{
+    const float gradientShare = nesterov ? rate : 0.0f;
+    const float velocityShare = nesterov ? rate * momentum : rate;
+    const __m128 s = _mm_set1_ps(scale), mu = _mm_set1_ps(momentum);
+    const __m128 gs = _mm_set1_ps(gradientShare), vs = _mm_set1_ps(velocityShare);
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 gi = _mm_mul_ps(s, _mm_loadu_ps(g + i));
+        __m128 vel = _mm_add_ps(_mm_mul_ps(mu, _mm_loadu_ps(velocity + i)), gi);
+        _mm_storeu_ps(velocity + i, vel);
+        __m128 step = _mm_add_ps(_mm_mul_ps(gs, gi), _mm_mul_ps(vs, vel));
+        _mm_storeu_ps(w + i, _mm_sub_ps(_mm_loadu_ps(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        momentumLane(w[i], velocity[i], g[i], scale, momentum, gradientShare, velocityShare);
+    }
+}
+
+// RMSProp Step (single precision)
+__attribute__((target("sse2")))
+static void rmspropSse2F(float *w, float *meanSquare, const float *g, unsigned int n,
+                         float scale, float rate, float decay, float epsilon)
+{
+    const __m128 s = _mm_set1_ps(scale), r = _mm_set1_ps(rate), eps = _mm_set1_ps(epsilon);
+    const __m128 keep = _mm_set1_ps(decay), blend = _mm_set1_ps(1.0f - decay);
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 gi = _mm_mul_ps(s, _mm_loadu_ps(g + i));
+        __m128 ms = _mm_add_ps(_mm_mul_ps(keep, _mm_loadu_ps(meanSquare + i)), _mm_mul_ps(blend, _mm_mul_ps(gi, gi)));
+        _mm_storeu_ps(meanSquare + i, ms);
+        __m128 step = _mm_div_ps(_mm_mul_ps(r, gi), _mm_add_ps(_mm_sqrt_ps(ms), eps));
+        _mm_storeu_ps(w + i, _mm_sub_ps(_mm_loadu_ps(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        rmspropLane(w[i], meanSquare[i], g[i], scale, rate, decay, epsilon);
+    }
+}
+
+// Adam Step (single precision)
+__attribute__((target("sse2")))
+static void adamSse2F(float *w, float *m, float *v, const float *g, unsigned int n,
+                      float scale, float rate, float beta1, float beta2, float epsilon)
+{
+    const __m128 s = _mm_set1_ps(scale), r = _mm_set1_ps(rate), eps = _mm_set1_ps(epsilon);
+    const __m128 b1 = _mm_set1_ps(beta1), k1 = _mm_set1_ps(1.0f - beta1);
+    const __m128 b2 = _mm_set1_ps(beta2), k2 = _mm_set1_ps(1.0f - beta2);
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 gi = _mm_mul_ps(s, _mm_loadu_ps(g + i));
+        __m128 mi = _mm_add_ps(_mm_mul_ps(b1, _mm_loadu_ps(m + i)), _mm_mul_ps(k1, gi));
+        __m128 vi = _mm_add_ps(_mm_mul_ps(b2, _mm_loadu_ps(v + i)), _mm_mul_ps(k2, _mm_mul_ps(gi, gi)));
+        _mm_storeu_ps(m + i, mi);
+        _mm_storeu_ps(v + i, vi);
+        __m128 step = _mm_div_ps(_mm_mul_ps(r, mi), _mm_add_ps(_mm_sqrt_ps(vi), eps));
+        _mm_storeu_ps(w + i, _mm_sub_ps(_mm_loadu_ps(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        adamLane(w[i], m[i], v[i], g[i], scale, rate, beta1, beta2, epsilon);
+    }
+}
+
+// Exponential Parts - returns expm1(r) and sets half to 2^(k - 1), for t = k * ln2 + r
+template<unsigned int DEGREE>
+__attribute__((target("sse2"), always_inline))
+static inline __m128d expm1PartsSse2(__m128d t, __m128d &half)
+{
+    typedef ActivationConstants<double> C;
+
+    // Rounded to nearest by the integer conversion, SSE2 has no round
+    const __m128i ki = _mm_cvtpd_epi32(_mm_mul_pd(t, _mm_set1_pd(C::LOG2E)));
+    const __m128d k = _mm_cvtepi32_pd(ki);
+    __m128d r = _mm_sub_pd(t, _mm_mul_pd(k, _mm_set1_pd(C::LN2_HI)));
+    r = _mm_sub_pd(r, _mm_mul_pd(k, _mm_set1_pd(C::LN2_LO)));
+
+    __m128d p = _mm_set1_pd(EXP_TAYLOR[DEGREE]);
+#pragma GCC unroll 16
+    for (int d = DEGREE - 1; d >= 1; d--)
+    {
+        p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(EXP_TAYLOR[d]));
+    }
+
+    // 2^(k - 1) straight from the exponent bits
+    const __m128i bits = _mm_shuffle_epi32(_mm_add_epi32(ki, _mm_set1_epi32(1022)), _MM_SHUFFLE(1, 1, 0, 0));
+    half = _mm_castsi128_pd(_mm_slli_epi64(bits, 52));
+    return _mm_mul_pd(p, r);
+}
+
+// Sigmoid, two lanes
+template<unsigned int DEGREE>
+__attribute__((target("sse2"), always_inline))
+static inline __m128d sigmoidLanesSse2(__m128d x)
+{
+    typedef ActivationConstants<double> C;
+    const __m128d one = _mm_set1_pd(1.0);
+
+    // Clamped so 2^k stays representable (max / min pass a NaN in the second operand through)
+    __m128d t = _mm_xor_pd(x, _mm_set1_pd(-0.0));
+    t = _mm_min_pd(_mm_set1_pd(C::EXP_MAX), _mm_max_pd(_mm_set1_pd(C::EXP_MIN), t));
+    __m128d half;
+    const __m128d q = expm1PartsSse2<DEGREE>(t, half);
+    const __m128d e = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(half, q), half), _mm_set1_pd(2.0));
+    return _mm_div_pd(one, _mm_add_pd(one, e));
+}
+
+// Hyperbolic Tangent, two lanes
+template<unsigned int DEGREE>
+__attribute__((target("sse2"), always_inline))
+static inline __m128d tanhLanesSse2(__m128d x)
+{
+    typedef ActivationConstants<double> C;
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d two = _mm_set1_pd(2.0);
+
+    const __m128d a = _mm_andnot_pd(sign, x);
+    const __m128d t = _mm_min_pd(_mm_set1_pd(C::TANH_MAX), _mm_add_pd(a, a));
+    __m128d half;
+    const __m128d q = expm1PartsSse2<DEGREE>(t, half);
+    const __m128d em = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(half, q), _mm_sub_pd(half, _mm_set1_pd(0.5))), two);
+    return _mm_or_pd(_mm_div_pd(em, _mm_add_pd(em, two)), _mm_and_pd(x, sign));
+}
+
+// Map Lanes - the tail is padded out to a full register, so every value is rounded alike
+template<__m128d (*LANES)(__m128d)>
+__attribute__((target("sse2"), always_inline))
+static inline void mapSse2(const double *x, double *y, unsigned int n)
+{
+    unsigned int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        _mm_storeu_pd(y + i, LANES(_mm_loadu_pd(x + i)));
+    }
+    if (i < n)
+    {
+        double lanes[2] = {0.0, 0.0};
+        std::copy(x + i, x + n, lanes);
+        _mm_storeu_pd(lanes, LANES(_mm_loadu_pd(lanes)));
+        std::copy(lanes, lanes + (n - i), y + i);
+    }
+}
+
+// Sigmoid
+__attribute__((target("sse2")))
+static void sigmoidSse2(const double *x, double *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<double> C;
+    if (fast)
+    {
+        mapSse2<sigmoidLanesSse2<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapSse2<sigmoidLanesSse2<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+// Hyperbolic Tangent
+__attribute__((target("sse2")))
+static void tanhSse2(const double *x, double *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<double> C;
+    if (fast)
+    {
+        mapSse2<tanhLanesSse2<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapSse2<tanhLanesSse2<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+// Exponential Parts (single precision)
+template<unsigned int DEGREE>
+__attribute__((target("sse2"), always_inline))
+static inline __m128 expm1PartsSse2F(__m128 t, __m128 &half)
+{
+    typedef ActivationConstants<float> C;
+
+    const __m128i ki = _mm_cvtps_epi32(_mm_mul_ps(t, _mm_set1_ps(C::LOG2E)));
+    const __m128 k = _mm_cvtepi32_ps(ki);
+    __m128 r = _mm_sub_ps(t, _mm_mul_ps(k, _mm_set1_ps(C::LN2_HI)));
+    r = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(C::LN2_LO)));
+
+    __m128 p = _mm_set1_ps((float)EXP_TAYLOR[DEGREE]);
+#pragma GCC unroll 16
+    for (int d = DEGREE - 1; d >= 1; d--)
+    {
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps((float)EXP_TAYLOR[d]));
+    }
+
+    half = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(ki, _mm_set1_epi32(126)), 23));
+    return _mm_mul_ps(p, r);
+}
+
+// Sigmoid, four lanes (single precision)
+template<unsigned int DEGREE>
+__attribute__((target("sse2"), always_inline))
+static inline __m128 sigmoidLanesSse2F(__m128 x)
+{
+    typedef ActivationConstants<float> C;
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    __m128 t = _mm_xor_ps(x, _mm_set1_ps(-0.0f));
+    t = _mm_min_ps(_mm_set1_ps(C::EXP_MAX), _mm_max_ps(_mm_set1_ps(C::EXP_MIN), t));
+    __m128 half;
+    const __m128 q = expm1PartsSse2F<DEGREE>(t, half);
+    const __m128 e = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(half, q), half), _mm_set1_ps(2.0f));
+    return _mm_div_ps(one, _mm_add_ps(one, e));
+}
+
+// Hyperbolic Tangent, four lanes (single precision)
+template<unsigned int DEGREE>
+__attribute__((target("sse2"), always_inline))
+static inline __m128 tanhLanesSse2F(__m128 x)
+{
+    typedef ActivationConstants<float> C;
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    const __m128 a = _mm_andnot_ps(sign, x);
+    const __m128 t = _mm_min_ps(_mm_set1_ps(C::TANH_MAX), _mm_add_ps(a, a));
+    __m128 half;
+    const __m128 q = expm1PartsSse2F<DEGREE>(t, half);
+    const __m128 em = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(half, q), _mm_sub_ps(half, _mm_set1_ps(0.5f))), two);
+    return _mm_or_ps(_mm_div_ps(em, _mm_add_ps(em, two)), _mm_and_ps(x, sign));
+}
+
+// Map Lanes (single precision)
+template<__m128 (*LANES)(__m128)>
+__attribute__((target("sse2"), always_inline))
+static inline void mapSse2F(const float *x, float *y, unsigned int n)
+{
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(y + i, LANES(_mm_loadu_ps(x + i)));
+    }
+    if (i < n)
+    {
+        float lanes[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        std::copy(x + i, x + n, lanes);
+        _mm_storeu_ps(lanes, LANES(_mm_loadu_ps(lanes)));
+        std::copy(lanes, lanes + (n - i), y + i);
+    }
+}
+
+// Sigmoid (single precision)
+__attribute__((target("sse2")))
+static void sigmoidSse2F(const float *x, float *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<float> C;
+    if (fast)
+    {
+        mapSse2F<sigmoidLanesSse2F<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapSse2F<sigmoidLanesSse2F<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+// Hyperbolic Tangent (single precision)
+__attribute__((target("sse2")))
+static void tanhSse2F(const float *x, float *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<float> C;
+    if (fast)
+    {
+        mapSse2F<tanhLanesSse2F<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapSse2F<tanhLanesSse2F<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+/*********************** AVX2 / FMA KERNELS ************************/
+
+// Horizontal sum of four lanes
+__attribute__((target("avx2,fma")))
+static inline double hsumAvx2(__m256d value)
+{
+    __m128d low = _mm256_castpd256_pd128(value);
+    __m128d high = _mm256_extractf128_pd(value, 1);
+    low = _mm_add_pd(low, high);
+    return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+}
+
+// Dot Product - four accumulators of four lanes
+__attribute__((target("avx2,fma")))
+static double dotAvx2(const double *a, const double *b, unsigned int n)
+{
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+        acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), acc2);
+        acc3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), acc3);
+    }
+    for (; i + 4 <= n; i += 4)
+    {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+    }
+    double sum = hsumAvx2(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+    for (; i < n; i++)
+    {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// Dot Product (one against four)
+__attribute__((target("avx2,fma")))
+static void dot4Avx2(const double *w, const double *x0, const double *x1,
+                     const double *x2, const double *x3, unsigned int n, double *sums)
+{
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d weight = _mm256_loadu_pd(w + i);
+        acc0 = _mm256_fmadd_pd(weight, _mm256_loadu_pd(x0 + i), acc0);
+        acc1 = _mm256_fmadd_pd(weight, _mm256_loadu_pd(x1 + i), acc1);
+        acc2 = _mm256_fmadd_pd(weight, _mm256_loadu_pd(x2 + i), acc2);
+        acc3 = _mm256_fmadd_pd(weight, _mm256_loadu_pd(x3 + i), acc3);
+    }
+
+    // Transpose-reduce the four accumulators into one vector of four sums
+    __m256d sum01 = _mm256_hadd_pd(acc0, acc1);
+    __m256d sum23 = _mm256_hadd_pd(acc2, acc3);
+    __m256d swapped = _mm256_permute2f128_pd(sum01, sum23, 0x21);
+    __m256d blended = _mm256_blend_pd(sum01, sum23, 0xC);
+    _mm256_storeu_pd(sums, _mm256_add_pd(swapped, blended));
+    for (; i < n; i++)
+    {
+        sums[0] += w[i] * x0[i];
+        sums[1] += w[i] * x1[i];
+        sums[2] += w[i] * x2[i];
+        sums[3] += w[i] * x3[i];
+    }
+}
+
+// Axpy
+__attribute__((target("avx2,fma")))
+static void axpyAvx2(double alpha, const double *x, double *y, unsigned int n)
+{
+    __m256d scale = _mm256_set1_pd(alpha);
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(scale, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    }
+    for (; i < n; i++)
+    {
+        y[i] += alpha * x[i];
+    }
+}
+
+// Fold eight lanes to four
+__attribute__((target("avx2,fma")))
+static inline __m128 foldAvx2(__m256 value)
+{
+    return _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+}
+
+// Dot Product - four accumulators of eight lanes (single precision)
+__attribute__((target("avx2,fma")))
+static float dotAvx2F(const float *a, const float *b, unsigned int n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    unsigned int i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+        acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), acc2);
+        acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), acc3);
+    }
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    float sum = hsumSse2(foldAvx2(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3))));
+    for (; i < n; i++)
+    {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// Dot Product (one against four, single precision)
+__attribute__((target("avx2,fma")))
+static void dot4Avx2F(const float *w, const float *x0, const float *x1,
+                      const float *x2, const float *x3, unsigned int n, float *sums)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 weight = _mm256_loadu_ps(w + i);
+        acc0 = _mm256_fmadd_ps(weight, _mm256_loadu_ps(x0 + i), acc0);
+        acc1 = _mm256_fmadd_ps(weight, _mm256_loadu_ps(x1 + i), acc1);
+        acc2 = _mm256_fmadd_ps(weight, _mm256_loadu_ps(x2 + i), acc2);
+        acc3 = _mm256_fmadd_ps(weight, _mm256_loadu_ps(x3 + i), acc3);
+    }
+    _mm_storeu_ps(sums, transposeSumSse2(foldAvx2(acc0), foldAvx2(acc1), foldAvx2(acc2), foldAvx2(acc3)));
+    for (; i < n; i++)
+    {
+        sums[0] += w[i] * x0[i];
+        sums[1] += w[i] * x1[i];
+        sums[2] += w[i] * x2[i];
+        sums[3] += w[i] * x3[i];
+    }
+}
+
+// Axpy (single precision)
+__attribute__((target("avx2,fma")))
+static void axpyAvx2F(float alpha, const float *x, float *y, unsigned int n)
+{
+    __m256 scale = _mm256_set1_ps(alpha);
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(scale, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+    for (; i < n; i++)
+    {
+        y[i] += alpha * x[i];
+    }
+}
+
+// Dot Product (int8) - sign extend to 16 bits, multiply-add pairs into int32
+__attribute__((target("avx2,fma")))
+static int32_t dotAvx2I8(const int8_t *a, const int8_t *b, unsigned int n)
+{
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    unsigned int i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i a0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(a + i)));
+        __m256i b0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(b + i)));
+        __m256i a1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(a + i + 16)));
+        __m256i b1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(b + i + 16)));
+        acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(a0, b0));
+        acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(a1, b1));
+    }
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i a0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(a + i)));
+        __m256i b0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(b + i)));
+        acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(a0, b0));
+    }
+    __m256i acc = _mm256_add_epi32(acc0, acc1);
+    int32_t sum = hsumSse2I32(_mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+    for (; i < n; i++)
+    {
+        sum += (int32_t)a[i] * b[i];
+    }
+    return sum;
+}
+
+// Momentum Step
+__attribute__((target("avx2,fma")))
+static void momentumAvx2(double *w, double *velocity, const double *g, unsigned int n,
+                         double scale, double rate, double momentum, bool nesterov)
+{
+    const double gradientShare = nesterov ? rate : 0.0;
+    const double velocityShare = nesterov ? rate * momentum : rate;
+    const __m256d s = _mm256_set1_pd(scale), mu = _mm256_set1_pd(momentum);
+    const __m256d gs = _mm256_set1_pd(gradientShare), vs = _mm256_set1_pd(velocityShare);
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d gi = _mm256_mul_pd(s, _mm256_loadu_pd(g + i));
+        __m256d vel = _mm256_fmadd_pd(mu, _mm256_loadu_pd(velocity + i), gi);
+        _mm256_storeu_pd(velocity + i, vel);
+        __m256d step = _mm256_fmadd_pd(gs, gi, _mm256_mul_pd(vs, vel));
+        _mm256_storeu_pd(w + i, _mm256_sub_pd(_mm256_loadu_pd(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        momentumLane(w[i], velocity[i], g[i], scale, momentum, gradientShare, velocityShare);
+    }
+}
+
+// RMSProp Step
+__attribute__((target("avx2,fma")))
+static void rmspropAvx2(double *w, double *meanSquare, const double *g, unsigned int n,
+                        double scale, double rate, double decay, double epsilon)
+{
+    const __m256d s = _mm256_set1_pd(scale), r = _mm256_set1_pd(rate), eps = _mm256_set1_pd(epsilon);
+    const __m256d keep = _mm256_set1_pd(decay), blend = _mm256_set1_pd(1.0 - decay);
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d gi = _mm256_mul_pd(s, _mm256_loadu_pd(g + i));
+        __m256d ms = _mm256_fmadd_pd(keep, _mm256_loadu_pd(meanSquare + i), _mm256_mul_pd(blend, _mm256_mul_pd(gi, gi)));
+        _mm256_storeu_pd(meanSquare + i, ms);
+        __m256d step = _mm256_div_pd(_mm256_mul_pd(r, gi), _mm256_add_pd(_mm256_sqrt_pd(ms), eps));
+        _mm256_storeu_pd(w + i, _mm256_sub_pd(_mm256_loadu_pd(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        rmspropLane(w[i], meanSquare[i], g[i], scale, rate, decay, epsilon);
+    }
+}
+
+// Adam Step
+__attribute__((target("avx2,fma")))
+static void adamAvx2(double *w, double *m, double *v, const double *g, unsigned int n,
+                     double scale, double rate, double beta1, double beta2, double epsilon)
+{
+    const __m256d s = _mm256_set1_pd(scale), r = _mm256_set1_pd(rate), eps = _mm256_set1_pd(epsilon);
+    const __m256d b1 = _mm256_set1_pd(beta1), k1 = _mm256_set1_pd(1.0 - beta1);
+    const __m256d b2 = _mm256_set1_pd(beta2), k2 = _mm256_set1_pd(1.0 - beta2);
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d gi = _mm256_mul_pd(s, _mm256_loadu_pd(g + i));
+        __m256d mi = _mm256_fmadd_pd(b1, _mm256_loadu_pd(m + i), _mm256_mul_pd(k1, gi));
+        __m256d vi = _mm256_fmadd_pd(b2, _mm256_loadu_pd(v + i), _mm256_mul_pd(k2, _mm256_mul_pd(gi, gi)));
+        _mm256_storeu_pd(m + i, mi);
+        _mm256_storeu_pd(v + i, vi);
+        __m256d step = _mm256_div_pd(_mm256_mul_pd(r, mi), _mm256_add_pd(_mm256_sqrt_pd(vi), eps));
+        _mm256_storeu_pd(w + i, _mm256_sub_pd(_mm256_loadu_pd(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        adamLane(w[i], m[i], v[i], g[i], scale, rate, beta1, beta2, epsilon);
+    }
+}
+
+// Momentum Step (single precision)
+__attribute__((target("avx2,fma")))
+static void momentumAvx2F(float *w, float *velocity, const float *g, unsigned int n,
+                          float scale, float rate, float momentum, bool nesterov)
+{
+    const float gradientShare = nesterov ? rate : 0.0f;
+    const float velocityShare = nesterov ? rate * momentum : rate;
+    const __m256 s = _mm256_set1_ps(scale), mu = _mm256_set1_ps(momentum);
+    const __m256 gs = _mm256_set1_ps(gradientShare), vs = _mm256_set1_ps(velocityShare);
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 gi = _mm256_mul_ps(s, _mm256_loadu_ps(g + i));
+        __m256 vel = _mm256_fmadd_ps(mu, _mm256_loadu_ps(velocity + i), gi);
+        _mm256_storeu_ps(velocity + i, vel);
+        __m256 step = _mm256_fmadd_ps(gs, gi, _mm256_mul_ps(vs, vel));
+        _mm256_storeu_ps(w + i, _mm256_sub_ps(_mm256_loadu_ps(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        momentumLane(w[i], velocity[i], g[i], scale, momentum, gradientShare, velocityShare);
+    }
+}
+
+// RMSProp Step (single precision)
+__attribute__((target("avx2,fma")))
+static void rmspropAvx2F(float *w, float *meanSquare, const float *g, unsigned int n,
+                         float scale, float rate, float decay, float epsilon)
+{
+    const __m256 s = _mm256_set1_ps(scale), r = _mm256_set1_ps(rate), eps = _mm256_set1_ps(epsilon);
+    const __m256 keep = _mm256_set1_ps(decay), blend = _mm256_set1_ps(1.0f - decay);
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 gi = _mm256_mul_ps(s, _mm256_loadu_ps(g + i));
+        __m256 ms = _mm256_fmadd_ps(keep, _mm256_loadu_ps(meanSquare + i), _mm256_mul_ps(blend, _mm256_mul_ps(gi, gi)));
+        _mm256_storeu_ps(meanSquare + i, ms);
+        __m256 step = _mm256_div_ps(_mm256_mul_ps(r, gi), _mm256_add_ps(_mm256_sqrt_ps(ms), eps));
+        _mm256_storeu_ps(w + i, _mm256_sub_ps(_mm256_loadu_ps(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        rmspropLane(w[i], meanSquare[i], g[i], scale, rate, decay, epsilon);
+    }
+}
+
+// Adam Step (single precision)
+__attribute__((target("avx2,fma")))
+static void adamAvx2F(float *w, float *m, float *v, const float *g, unsigned int n,
+                      float scale, float rate, float beta1, float beta2, float epsilon)
+{
+    const __m256 s = _mm256_set1_ps(scale), r = _mm256_set1_ps(rate), eps = _mm256_set1_ps(epsilon);
+    const __m256 b1 = _mm256_set1_ps(beta1), k1 = _mm256_set1_ps(1.0f - beta1);
+    const __m256 b2 = _mm256_set1_ps(beta2), k2 = _mm256_set1_ps(1.0f - beta2);
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 gi = _mm256_mul_ps(s, _mm256_loadu_ps(g + i));
+        __m256 mi = _mm256_fmadd_ps(b1, _mm256_loadu_ps(m + i), _mm256_mul_ps(k1, gi));
+        __m256 vi = _mm256_fmadd_ps(b2, _mm256_loadu_ps(v + i), _mm256_mul_ps(k2, _mm256_mul_ps(gi, gi)));
+        _mm256_storeu_ps(m + i, mi);
+        _mm256_storeu_ps(v + i, vi);
+        __m256 step = _mm256_div_ps(_mm256_mul_ps(r, mi), _mm256_add_ps(_mm256_sqrt_ps(vi), eps));
+        _mm256_storeu_ps(w + i, _mm256_sub_ps(_mm256_loadu_ps(w + i), step));
+    }
+    for (; i < n; i++)
+    {
+        adamLane(w[i], m[i], v[i], g[i], scale, rate, beta1, beta2, epsilon);
+    }
+}
+
+// Exponential Parts - returns expm1(r) and sets half to 2^(k - 1), for t = k * ln2 + r
+template<unsigned int DEGREE>
+__attribute__((target("avx2,fma"), always_inline))
+static inline __m256d expm1PartsAvx2(__m256d t, __m256d &half)
+{
+    typedef ActivationConstants<double> C;
+
+    const __m256d k = _mm256_round_pd(_mm256_mul_pd(t, _mm256_set1_pd(C::LOG2E)),
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_fnmadd_pd(k, _mm256_set1_pd(C::LN2_HI), t);
+    r = _mm256_fnmadd_pd(k, _mm256_set1_pd(C::LN2_LO), r);
+
+    __m256d p = _mm256_set1_pd(EXP_TAYLOR[DEGREE]);
+#pragma GCC unroll 16
+    for (int d = DEGREE - 1; d >= 1; d--)
+    {
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(EXP_TAYLOR[d]));
+    }
+
+    // 2^(k - 1) straight from the exponent bits
+    const __m256i ki = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k));
+    half = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(ki, _mm256_set1_epi64x(1022)), 52));
+    return _mm256_mul_pd(p, r);
+}
+
+// Sigmoid, four lanes
+template<unsigned int DEGREE>
+__attribute__((target("avx2,fma"), always_inline))
+static inline __m256d sigmoidLanesAvx2(__m256d x)
+{
+    typedef ActivationConstants<double> C;
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    // Clamped so 2^k stays representable (max / min pass a NaN in the second operand through)
+    __m256d t = _mm256_xor_pd(x, _mm256_set1_pd(-0.0));
+    t = _mm256_min_pd(_mm256_set1_pd(C::EXP_MAX), _mm256_max_pd(_mm256_set1_pd(C::EXP_MIN), t));
+    __m256d half;
+    const __m256d q = expm1PartsAvx2<DEGREE>(t, half);
+    const __m256d e = _mm256_mul_pd(_mm256_fmadd_pd(half, q, half), _mm256_set1_pd(2.0));
+    return _mm256_div_pd(one, _mm256_add_pd(one, e));
+}
+
+// Hyperbolic Tangent, four lanes
+template<unsigned int DEGREE>
+__attribute__((target("avx2,fma"), always_inline))
+static inline __m256d tanhLanesAvx2(__m256d x)
+{
+    typedef ActivationConstants<double> C;
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+
+    const __m256d a = _mm256_andnot_pd(sign, x);
+    const __m256d t = _mm256_min_pd(_mm256_set1_pd(C::TANH_MAX), _mm256_add_pd(a, a));
+    __m256d half;
+    const __m256d q = expm1PartsAvx2<DEGREE>(t, half);
+    const __m256d em = _mm256_mul_pd(_mm256_fmadd_pd(half, q, _mm256_sub_pd(half, _mm256_set1_pd(0.5))), two);
+    return _mm256_or_pd(_mm256_div_pd(em, _mm256_add_pd(em, two)), _mm256_and_pd(x, sign));
+}
+
+// Map Lanes - the tail is padded out to a full register, so every value is rounded alike
+template<__m256d (*LANES)(__m256d)>
+__attribute__((target("avx2,fma"), always_inline))
+static inline void mapAvx2(const double *x, double *y, unsigned int n)
+{
+    unsigned int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm256_storeu_pd(y + i, LANES(_mm256_loadu_pd(x + i)));
+    }
+    if (i < n)
+    {
+        double lanes[4] = {};
+        std::copy(x + i, x + n, lanes);
+        _mm256_storeu_pd(lanes, LANES(_mm256_loadu_pd(lanes)));
+        std::copy(lanes, lanes + (n - i), y + i);
+    }
+}
+
+// Sigmoid
+__attribute__((target("avx2,fma")))
+static void sigmoidAvx2(const double *x, double *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<double> C;
+    if (fast)
+    {
+        mapAvx2<sigmoidLanesAvx2<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapAvx2<sigmoidLanesAvx2<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+// Hyperbolic Tangent
+__attribute__((target("avx2,fma")))
+static void tanhAvx2(const double *x, double *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<double> C;
+    if (fast)
+    {
+        mapAvx2<tanhLanesAvx2<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapAvx2<tanhLanesAvx2<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+// Exponential Parts (single precision)
+template<unsigned int DEGREE>
+__attribute__((target("avx2,fma"), always_inline))
+static inline __m256 expm1PartsAvx2F(__m256 t, __m256 &half)
+{
+    typedef ActivationConstants<float> C;
+
+    const __m256 k = _mm256_round_ps(_mm256_mul_ps(t, _mm256_set1_ps(C::LOG2E)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(k, _mm256_set1_ps(C::LN2_HI), t);
+    r = _mm256_fnmadd_ps(k, _mm256_set1_ps(C::LN2_LO), r);
+
+    __m256 p = _mm256_set1_ps((float)EXP_TAYLOR[DEGREE]);
+#pragma GCC unroll 16
+    for (int d = DEGREE - 1; d >= 1; d--)
+    {
+        p = _mm256_fmadd_ps(p, r, _mm256_set1_ps((float)EXP_TAYLOR[d]));
+    }
+
+    const __m256i ki = _mm256_cvtps_epi32(k);
+    half = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(ki, _mm256_set1_epi32(126)), 23));
+    return _mm256_mul_ps(p, r);
+}
+
+// Sigmoid, eight lanes (single precision)
+template<unsigned int DEGREE>
+__attribute__((target("avx2,fma"), always_inline))
+static inline __m256 sigmoidLanesAvx2F(__m256 x)
+{
+    typedef ActivationConstants<float> C;
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    __m256 t = _mm256_xor_ps(x, _mm256_set1_ps(-0.0f));
+    t = _mm256_min_ps(_mm256_set1_ps(C::EXP_MAX), _mm256_max_ps(_mm256_set1_ps(C::EXP_MIN), t));
+    __m256 half;
+    const __m256 q = expm1PartsAvx2F<DEGREE>(t, half);
+    const __m256 e = _mm256_mul_ps(_mm256_fmadd_ps(half, q, half), _mm256_set1_ps(2.0f));
+    return _mm256_div_ps(one, _mm256_add_ps(one, e));
+}
+
+// Hyperbolic Tangent, eight lanes (single precision)
+template<unsigned int DEGREE>
+__attribute__((target("avx2,fma"), always_inline))
+static inline __m256 tanhLanesAvx2F(__m256 x)
+{
+    typedef ActivationConstants<float> C;
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+
+    const __m256 a = _mm256_andnot_ps(sign, x);
+    const __m256 t = _mm256_min_ps(_mm256_set1_ps(C::TANH_MAX), _mm256_add_ps(a, a));
+    __m256 half;
+    const __m256 q = expm1PartsAvx2F<DEGREE>(t, half);
+    const __m256 em = _mm256_mul_ps(_mm256_fmadd_ps(half, q, _mm256_sub_ps(half, _mm256_set1_ps(0.5f))), two);
+    return _mm256_or_ps(_mm256_div_ps(em, _mm256_add_ps(em, two)), _mm256_and_ps(x, sign));
+}
+
+// Map Lanes (single precision)
+template<__m256 (*LANES)(__m256)>
+__attribute__((target("avx2,fma"), always_inline))
+static inline void mapAvx2F(const float *x, float *y, unsigned int n)
+{
+    unsigned int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_ps(y + i, LANES(_mm256_loadu_ps(x + i)));
+    }
+    if (i < n)
+    {
+        float lanes[8] = {};
+        std::copy(x + i, x + n, lanes);
+        _mm256_storeu_ps(lanes, LANES(_mm256_loadu_ps(lanes)));
+        std::copy(lanes, lanes + (n - i), y + i);
+    }
+}
+
+// Sigmoid (single precision)
+__attribute__((target("avx2,fma")))
+static void sigmoidAvx2F(const float *x, float *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<float> C;
+    if (fast)
+    {
+        mapAvx2F<sigmoidLanesAvx2F<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapAvx2F<sigmoidLanesAvx2F<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+// Hyperbolic Tangent (single precision)
+__attribute__((target("avx2,fma")))
+static void tanhAvx2F(const float *x, float *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<float> C;
+    if (fast)
+    {
+        mapAvx2F<tanhLanesAvx2F<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapAvx2F<tanhLanesAvx2F<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+/*********************** AVX-512 KERNELS ***************************/
+
+// GCC 12 flags the intrinsics' own placeholder operands as uninitialized (GCC PR 105593)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+// Horizontal sum of eight lanes
+__attribute__((target("avx512f")))
+static inline double hsumAvx512(__m512d value)
+{
+    // Fold the 256 bit halves together, then the 128 bit halves
+    value = _mm512_add_pd(value, _mm512_shuffle_f64x2(value, value, 0x4E));
+    __m256d half = _mm512_castpd512_pd256(value);
+    __m128d low = _mm_add_pd(_mm256_castpd256_pd128(half), _mm256_extractf128_pd(half, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+}
+
+// Dot Product - four accumulators of eight lanes, masked tail
+__attribute__((target("avx512f")))
+static double dotAvx512(const double *a, const double *b, unsigned int n)
+{
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+        acc2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), acc2);
+        acc3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), acc3);
+    }
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+    }
+    if (i < n)
+    {
+        __mmask8 mask = (__mmask8)((1u << (n - i)) - 1);
+        acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i), acc1);
+    }
+    return hsumAvx512(_mm512_add_pd(_mm512_add_pd(acc0, acc1), _mm512_add_pd(acc2, acc3)));
+}
+
+// Dot Product (one against four), masked tail
+__attribute__((target("avx512f")))
+static void dot4Avx512(const double *w, const double *x0, const double *x1,
+                       const double *x2, const double *x3, unsigned int n, double *sums)
+{
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    __m512d acc2 = _mm512_setzero_pd(), acc3 = _mm512_setzero_pd();
+    for (unsigned int i = 0; i < n; i += 8)
+    {
+        __mmask8 mask = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        __m512d weight = _mm512_maskz_loadu_pd(mask, w + i);
+        acc0 = _mm512_fmadd_pd(weight, _mm512_maskz_loadu_pd(mask, x0 + i), acc0);
+        acc1 = _mm512_fmadd_pd(weight, _mm512_maskz_loadu_pd(mask, x1 + i), acc1);
+        acc2 = _mm512_fmadd_pd(weight, _mm512_maskz_loadu_pd(mask, x2 + i), acc2);
+        acc3 = _mm512_fmadd_pd(weight, _mm512_maskz_loadu_pd(mask, x3 + i), acc3);
+    }
+    sums[0] = hsumAvx512(acc0);
+    sums[1] = hsumAvx512(acc1);
+    sums[2] = hsumAvx512(acc2);
+    sums[3] = hsumAvx512(acc3);
+}
+
+// Axpy, masked tail
+__attribute__((target("avx512f")))
+static void axpyAvx512(double alpha, const double *x, double *y, unsigned int n)
+{
+    __m512d scale = _mm512_set1_pd(alpha);
+    for (unsigned int i = 0; i < n; i += 8)
+    {
+        __mmask8 mask = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        __m512d result = _mm512_fmadd_pd(scale, _mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+        _mm512_mask_storeu_pd(y + i, mask, result);
+    }
+}
+
+// Horizontal sum of sixteen lanes
+__attribute__((target("avx512f")))
+static inline float hsumAvx512F(__m512 value)
+{
+    // Fold the 256 bit halves together, then the 128 bit halves
+    value = _mm512_add_ps(value, _mm512_shuffle_f32x4(value, value, 0x4E));
+    __m256 half = _mm512_castps512_ps256(value);
+    __m128 low = _mm_add_ps(_mm256_castps256_ps128(half), _mm256_extractf128_ps(half, 1));
+    low = _mm_add_ps(low, _mm_movehl_ps(low, low));
+    return _mm_cvtss_f32(_mm_add_ss(low, _mm_shuffle_ps(low, low, 0x55)));
+}
+
+// Dot Product - four accumulators of sixteen lanes, masked tail (single precision)
+__attribute__((target("avx512f")))
+static float dotAvx512F(const float *a, const float *b, unsigned int n)
+{
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    unsigned int i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+        acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32), acc2);
+        acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48), acc3);
+    }
+    for (; i + 16 <= n; i += 16)
+    {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    }
+    if (i < n)
+    {
+        __mmask16 mask = (__mmask16)((1u << (n - i)) - 1);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), acc1);
+    }
+    return hsumAvx512F(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+// Dot Product (one against four), masked tail (single precision)
+__attribute__((target("avx512f")))
+static void dot4Avx512F(const float *w, const float *x0, const float *x1,
+                        const float *x2, const float *x3, unsigned int n, float *sums)
+{
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    for (unsigned int i = 0; i < n; i += 16)
+    {
+        __mmask16 mask = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        __m512 weight = _mm512_maskz_loadu_ps(mask, w + i);
+        acc0 = _mm512_fmadd_ps(weight, _mm512_maskz_loadu_ps(mask, x0 + i), acc0);
+        acc1 = _mm512_fmadd_ps(weight, _mm512_maskz_loadu_ps(mask, x1 + i), acc1);
+        acc2 = _mm512_fmadd_ps(weight, _mm512_maskz_loadu_ps(mask, x2 + i), acc2);
+        acc3 = _mm512_fmadd_ps(weight, _mm512_maskz_loadu_ps(mask, x3 + i), acc3);
+    }
+    sums[0] = hsumAvx512F(acc0);
+    sums[1] = hsumAvx512F(acc1);
+    sums[2] = hsumAvx512F(acc2);
+    sums[3] = hsumAvx512F(acc3);
+}
+
+// Axpy, masked tail (single precision)
+__attribute__((target("avx512f")))
+static void axpyAvx512F(float alpha, const float *x, float *y, unsigned int n)
+{
+    __m512 scale = _mm512_set1_ps(alpha);
+    for (unsigned int i = 0; i < n; i += 16)
+    {
+        __mmask16 mask = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        __m512 result = _mm512_fmadd_ps(scale, _mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+        _mm512_mask_storeu_ps(y + i, mask, result);
+    }
+}
+
+// Momentum Step, masked tail
+__attribute__((target("avx512f")))
+static void momentumAvx512(double *w, double *velocity, const double *g, unsigned int n,
+                           double scale, double rate, double momentum, bool nesterov)
+{
+    const double gradientShare = nesterov ? rate : 0.0;
+    const double velocityShare = nesterov ? rate * momentum : rate;
+    const __m512d s = _mm512_set1_pd(scale), mu = _mm512_set1_pd(momentum);
+    const __m512d gs = _mm512_set1_pd(gradientShare), vs = _mm512_set1_pd(velocityShare);
+    for (unsigned int i = 0; i < n; i += 8)
+    {
+        __mmask8 mask = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        __m512d gi = _mm512_mul_pd(s, _mm512_maskz_loadu_pd(mask, g + i));
+        __m512d vel = _mm512_fmadd_pd(mu, _mm512_maskz_loadu_pd(mask, velocity + i), gi);
+        _mm512_mask_storeu_pd(velocity + i, mask, vel);
+        __m512d step = _mm512_fmadd_pd(gs, gi, _mm512_mul_pd(vs, vel));
+        _mm512_mask_storeu_pd(w + i, mask, _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, w + i), step));
+    }
+}
+
+// RMSProp Step, masked tail
+__attribute__((target("avx512f")))
+static void rmspropAvx512(double *w, double *meanSquare, const double *g, unsigned int n,
+                          double scale, double rate, double decay, double epsilon)
+{
+    const __m512d s = _mm512_set1_pd(scale), r = _mm512_set1_pd(rate), eps = _mm512_set1_pd(epsilon);
+    const __m512d keep = _mm512_set1_pd(decay), blend = _mm512_set1_pd(1.0 - decay);
+    for (unsigned int i = 0; i < n; i += 8)
+    {
+        __mmask8 mask = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        __m512d gi = _mm512_mul_pd(s, _mm512_maskz_loadu_pd(mask, g + i));
+        __m512d ms = _mm512_fmadd_pd(keep, _mm512_maskz_loadu_pd(mask, meanSquare + i), _mm512_mul_pd(blend, _mm512_mul_pd(gi, gi)));
+        _mm512_mask_storeu_pd(meanSquare + i, mask, ms);
+        __m512d step = _mm512_div_pd(_mm512_mul_pd(r, gi), _mm512_add_pd(_mm512_sqrt_pd(ms), eps));
+        _mm512_mask_storeu_pd(w + i, mask, _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, w + i), step));
+    }
+}
+
+// Adam Step, masked tail
+__attribute__((target("avx512f")))
+static void adamAvx512(double *w, double *m, double *v, const double *g, unsigned int n,
+                       double scale, double rate, double beta1, double beta2, double epsilon)
+{
+    const __m512d s = _mm512_set1_pd(scale), r = _mm512_set1_pd(rate), eps = _mm512_set1_pd(epsilon);
+    const __m512d b1 = _mm512_set1_pd(beta1), k1 = _mm512_set1_pd(1.0 - beta1);
+    const __m512d b2 = _mm512_set1_pd(beta2), k2 = _mm512_set1_pd(1.0 - beta2);
+    for (unsigned int i = 0; i < n; i += 8)
+    {
+        __mmask8 mask = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        __m512d gi = _mm512_mul_pd(s, _mm512_maskz_loadu_pd(mask, g + i));
+        __m512d mi = _mm512_fmadd_pd(b1, _mm512_maskz_loadu_pd(mask, m + i), _mm512_mul_pd(k1, gi));
+        __m512d vi = _mm512_fmadd_pd(b2, _mm512_maskz_loadu_pd(mask, v + i), _mm512_mul_pd(k2, _mm512_mul_pd(gi, gi)));
+        _mm512_mask_storeu_pd(m + i, mask, mi);
+        _mm512_mask_storeu_pd(v + i, mask, vi);
+        __m512d step = _mm512_div_pd(_mm512_mul_pd(r, mi), _mm512_add_pd(_mm512_sqrt_pd(vi), eps));
+        _mm512_mask_storeu_pd(w + i, mask, _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, w + i), step));
+    }
+}
+
+// Momentum Step, masked tail (single precision)
+__attribute__((target("avx512f")))
+static void momentumAvx512F(float *w, float *velocity, const float *g, unsigned int n,
+                            float scale, float rate, float momentum, bool nesterov)
+{
+    const float gradientShare = nesterov ? rate : 0.0f;
+    const float velocityShare = nesterov ? rate * momentum : rate;
+    const __m512 s = _mm512_set1_ps(scale), mu = _mm512_set1_ps(momentum);
+    const __m512 gs = _mm512_set1_ps(gradientShare), vs = _mm512_set1_ps(velocityShare);
+    for (unsigned int i = 0; i < n; i += 16)
+    {
+        __mmask16 mask = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        __m512 gi = _mm512_mul_ps(s, _mm512_maskz_loadu_ps(mask, g + i));
+        __m512 vel = _mm512_fmadd_ps(mu, _mm512_maskz_loadu_ps(mask, velocity + i), gi);
+        _mm512_mask_storeu_ps(velocity + i, mask, vel);
+        __m512 step = _mm512_fmadd_ps(gs, gi, _mm512_mul_ps(vs, vel));
+        _mm512_mask_storeu_ps(w + i, mask, _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, w + i), step));
+    }
+}
+
+// RMSProp Step, masked tail (single precision)
+__attribute__((target("avx512f")))
+static void rmspropAvx512F(float *w, float *meanSquare, const float *g, unsigned int n,
+                           float scale, float rate, float decay, float epsilon)
+{
+    const __m512 s = _mm512_set1_ps(scale), r = _mm512_set1_ps(rate), eps = _mm512_set1_ps(epsilon);
+    const __m512 keep = _mm512_set1_ps(decay), blend = _mm512_set1_ps(1.0f - decay);
+    for (unsigned int i = 0; i < n; i += 16)
+    {
+        __mmask16 mask = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        __m512 gi = _mm512_mul_ps(s, _mm512_maskz_loadu_ps(mask, g + i));
+        __m512 ms = _mm512_fmadd_ps(keep, _mm512_maskz_loadu_ps(mask, meanSquare + i), _mm512_mul_ps(blend, _mm512_mul_ps(gi, gi)));
+        _mm512_mask_storeu_ps(meanSquare + i, mask, ms);
+        __m512 step = _mm512_div_ps(_mm512_mul_ps(r, gi), _mm512_add_ps(_mm512_sqrt_ps(ms), eps));
+        _mm512_mask_storeu_ps(w + i, mask, _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, w + i), step));
+    }
+}
+
+// Adam Step, masked tail (single precision)
+__attribute__((target("avx512f")))
+static void adamAvx512F(float *w, float *m, float *v, const float *g, unsigned int n,
+                        float scale, float rate, float beta1, float beta2, float epsilon)
+{
+    const __m512 s = _mm512_set1_ps(scale), r = _mm512_set1_ps(rate), eps = _mm512_set1_ps(epsilon);
+    const __m512 b1 = _mm512_set1_ps(beta1), k1 = _mm512_set1_ps(1.0f - beta1);
+    const __m512 b2 = _mm512_set1_ps(beta2), k2 = _mm512_set1_ps(1.0f - beta2);
+    for (unsigned int i = 0; i < n; i += 16)
+    {
+        __mmask16 mask = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        __m512 gi = _mm512_mul_ps(s, _mm512_maskz_loadu_ps(mask, g + i));
+        __m512 mi = _mm512_fmadd_ps(b1, _mm512_maskz_loadu_ps(mask, m + i), _mm512_mul_ps(k1, gi));
+        __m512 vi = _mm512_fmadd_ps(b2, _mm512_maskz_loadu_ps(mask, v + i), _mm512_mul_ps(k2, _mm512_mul_ps(gi, gi)));
+        _mm512_mask_storeu_ps(m + i, mask, mi);
+        _mm512_mask_storeu_ps(v + i, mask, vi);
+        __m512 step = _mm512_div_ps(_mm512_mul_ps(r, mi), _mm512_add_ps(_mm512_sqrt_ps(vi), eps));
+        _mm512_mask_storeu_ps(w + i, mask, _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, w + i), step));
+    }
+}
+
+// Exponential Parts - returns expm1(r) and sets half to 2^(k - 1), for t = k * ln2 + r
+template<unsigned int DEGREE>
+__attribute__((target("avx512f"), always_inline))
+static inline __m512d expm1PartsAvx512(__m512d t, __m512d &half)
+{
+    typedef ActivationConstants<double> C;
+
+    const __m512d k = _mm512_roundscale_pd(_mm512_mul_pd(t, _mm512_set1_pd(C::LOG2E)),
+                                           _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_fnmadd_pd(k, _mm512_set1_pd(C::LN2_HI), t);
+    r = _mm512_fnmadd_pd(k, _mm512_set1_pd(C::LN2_LO), r);
+
+    __m512d p = _mm512_set1_pd(EXP_TAYLOR[DEGREE]);
+#pragma GCC unroll 16
+    for (int d = DEGREE - 1; d >= 1; d--)
+    {
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(EXP_TAYLOR[d]));
+    }
+
+    // 2^(k - 1) by scaling, no round trip through the integer lanes
+    half = _mm512_scalef_pd(_mm512_set1_pd(0.5), k);
+    return _mm512_mul_pd(p, r);
+}
+
+// Sigmoid, eight lanes
+template<unsigned int DEGREE>
+__attribute__((target("avx512f"), always_inline))
+static inline __m512d sigmoidLanesAvx512(__m512d x)
+{
+    typedef ActivationConstants<double> C;
+    const __m512d one = _mm512_set1_pd(1.0);
+
+    // Clamped so 2^k stays representable (max / min pass a NaN in the second operand through)
+    __m512d t = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(x), _mm512_set1_epi64(INT64_MIN)));
+    t = _mm512_min_pd(_mm512_set1_pd(C::EXP_MAX), _mm512_max_pd(_mm512_set1_pd(C::EXP_MIN), t));
+    __m512d half;
+    const __m512d q = expm1PartsAvx512<DEGREE>(t, half);
+    const __m512d e = _mm512_mul_pd(_mm512_fmadd_pd(half, q, half), _mm512_set1_pd(2.0));
+    return _mm512_div_pd(one, _mm512_add_pd(one, e));
+}
+
+// Hyperbolic Tangent, eight lanes
+template<unsigned int DEGREE>
+__attribute__((target("avx512f"), always_inline))
+static inline __m512d tanhLanesAvx512(__m512d x)
+{
+    typedef ActivationConstants<double> C;
+    const __m512i sign = _mm512_set1_epi64(INT64_MIN);
+    const __m512d two = _mm512_set1_pd(2.0);
+
+    const __m512d a = _mm512_abs_pd(x);
+    const __m512d t = _mm512_min_pd(_mm512_set1_pd(C::TANH_MAX), _mm512_add_pd(a, a));
+    __m512d half;
+    const __m512d q = expm1PartsAvx512<DEGREE>(t, half);
+    const __m512d em = _mm512_mul_pd(_mm512_fmadd_pd(half, q, _mm512_sub_pd(half, _mm512_set1_pd(0.5))), two);
+    const __m512i y = _mm512_castpd_si512(_mm512_div_pd(em, _mm512_add_pd(em, two)));
+    return _mm512_castsi512_pd(_mm512_or_si512(y, _mm512_and_si512(_mm512_castpd_si512(x), sign)));
+}
+
+// Map Lanes, masked tail (zeroed lanes are computed and discarded)
+template<__m512d (*LANES)(__m512d)>
+__attribute__((target("avx512f"), always_inline))
+static inline void mapAvx512(const double *x, double *y, unsigned int n)
+{
+    for (unsigned int i = 0; i < n; i += 8)
+    {
+        __mmask8 mask = (n - i >= 8) ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1);
+        _mm512_mask_storeu_pd(y + i, mask, LANES(_mm512_maskz_loadu_pd(mask, x + i)));
+    }
+}
+
+// Sigmoid
+__attribute__((target("avx512f")))
+static void sigmoidAvx512(const double *x, double *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<double> C;
+    if (fast)
+    {
+        mapAvx512<sigmoidLanesAvx512<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapAvx512<sigmoidLanesAvx512<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+// Hyperbolic Tangent
+__attribute__((target("avx512f")))
+static void tanhAvx512(const double *x, double *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<double> C;
+    if (fast)
+    {
+        mapAvx512<tanhLanesAvx512<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapAvx512<tanhLanesAvx512<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+// Exponential Parts (single precision)
+template<unsigned int DEGREE>
+__attribute__((target("avx512f"), always_inline))
+static inline __m512 expm1PartsAvx512F(__m512 t, __m512 &half)
+{
+    typedef ActivationConstants<float> C;
+
+    const __m512 k = _mm512_roundscale_ps(_mm512_mul_ps(t, _mm512_set1_ps(C::LOG2E)),
+                                          _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 r = _mm512_fnmadd_ps(k, _mm512_set1_ps(C::LN2_HI), t);
+    r = _mm512_fnmadd_ps(k, _mm512_set1_ps(C::LN2_LO), r);
+
+    __m512 p = _mm512_set1_ps((float)EXP_TAYLOR[DEGREE]);
+#pragma GCC unroll 16
+    for (int d = DEGREE - 1; d >= 1; d--)
+    {
+        p = _mm512_fmadd_ps(p, r, _mm512_set1_ps((float)EXP_TAYLOR[d]));
+    }
+
+    half = _mm512_scalef_ps(_mm512_set1_ps(0.5f), k);
+    return _mm512_mul_ps(p, r);
+}
+
+// Sigmoid, sixteen lanes (single precision)
+template<unsigned int DEGREE>
+__attribute__((target("avx512f"), always_inline))
+static inline __m512 sigmoidLanesAvx512F(__m512 x)
+{
+    typedef ActivationConstants<float> C;
+    const __m512 one = _mm512_set1_ps(1.0f);
+
+    __m512 t = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(x), _mm512_set1_epi32(INT32_MIN)));
+    t = _mm512_min_ps(_mm512_set1_ps(C::EXP_MAX), _mm512_max_ps(_mm512_set1_ps(C::EXP_MIN), t));
+    __m512 half;
+    const __m512 q = expm1PartsAvx512F<DEGREE>(t, half);
+    const __m512 e = _mm512_mul_ps(_mm512_fmadd_ps(half, q, half), _mm512_set1_ps(2.0f));
+    return _mm512_div_ps(one, _mm512_add_ps(one, e));
+}
+
+// Hyperbolic Tangent, sixteen lanes (single precision)
+template<unsigned int DEGREE>
+__attribute__((target("avx512f"), always_inline))
+static inline __m512 tanhLanesAvx512F(__m512 x)
+{
+    typedef ActivationConstants<float> C;
+    const __m512i sign = _mm512_set1_epi32(INT32_MIN);
+    const __m512 two = _mm512_set1_ps(2.0f);
+
+    const __m512 a = _mm512_abs_ps(x);
+    const __m512 t = _mm512_min_ps(_mm512_set1_ps(C::TANH_MAX), _mm512_add_ps(a, a));
+    __m512 half;
+    const __m512 q = expm1PartsAvx512F<DEGREE>(t, half);
+    const __m512 em = _mm512_mul_ps(_mm512_fmadd_ps(half, q, _mm512_sub_ps(half, _mm512_set1_ps(0.5f))), two);
+    const __m512i y = _mm512_castps_si512(_mm512_div_ps(em, _mm512_add_ps(em, two)));
+    return _mm512_castsi512_ps(_mm512_or_si512(y, _mm512_and_si512(_mm512_castps_si512(x), sign)));
+}
+
+// Map Lanes, masked tail (single precision)
+template<__m512 (*LANES)(__m512)>
+__attribute__((target("avx512f"), always_inline))
+static inline void mapAvx512F(const float *x, float *y, unsigned int n)
+{
+    for (unsigned int i = 0; i < n; i += 16)
+    {
+        __mmask16 mask = (n - i >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(y + i, mask, LANES(_mm512_maskz_loadu_ps(mask, x + i)));
+    }
+}
+
+// Sigmoid (single precision)
+__attribute__((target("avx512f")))
+static void sigmoidAvx512F(const float *x, float *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<float> C;
+    if (fast)
+    {
+        mapAvx512F<sigmoidLanesAvx512F<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapAvx512F<sigmoidLanesAvx512F<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+// Hyperbolic Tangent (single precision)
+__attribute__((target("avx512f")))
+static void tanhAvx512F(const float *x, float *y, unsigned int n, bool fast)
+{
+    typedef ActivationConstants<float> C;
+    if (fast)
+    {
+        mapAvx512F<tanhLanesAvx512F<C::FAST_DEGREE>>(x, y, n);
+    }
+    else
+    {
+        mapAvx512F<tanhLanesAvx512F<C::EXACT_DEGREE>>(x, y, n);
+    }
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+/*********************** STATIC MEMBERS ****************************/
+
+// Scalar kernels until selection has run
+NeuralKernels::DotKernel NeuralKernels::dotKernel = dotScalar<double>;
+NeuralKernels::Dot4Kernel NeuralKernels::dot4Kernel = dot4Scalar<double>;
+NeuralKernels::AxpyKernel NeuralKernels::axpyKernel = axpyScalar<double>;
+NeuralKernels::DotKernelF NeuralKernels::dotKernelF = dotScalar<float>;
+NeuralKernels::Dot4KernelF NeuralKernels::dot4KernelF = dot4Scalar<float>;
+NeuralKernels::AxpyKernelF NeuralKernels::axpyKernelF = axpyScalar<float>;
+NeuralKernels::DotKernelI8 NeuralKernels::dotKernelI8 = dotScalarI8;
+NeuralKernels::MomentumKernel NeuralKernels::momentumKernel = momentumScalar<double>;
+NeuralKernels::RmspropKernel NeuralKernels::rmspropKernel = rmspropScalar<double>;
+NeuralKernels::AdamKernel NeuralKernels::adamKernel = adamScalar<double>;
+NeuralKernels::MomentumKernelF NeuralKernels::momentumKernelF = momentumScalar<float>;
+NeuralKernels::RmspropKernelF NeuralKernels::rmspropKernelF = rmspropScalar<float>;
+NeuralKernels::AdamKernelF NeuralKernels::adamKernelF = adamScalar<float>;
+NeuralKernels::ActivationKernel NeuralKernels::sigmoidKernel = sigmoidScalar<double>;
+NeuralKernels::ActivationKernel NeuralKernels::tanhKernel = tanhScalar<double>;
+NeuralKernels::ActivationKernelF NeuralKernels::sigmoidKernelF = sigmoidScalar<float>;
+NeuralKernels::ActivationKernelF NeuralKernels::tanhKernelF = tanhScalar<float>;
+const char * NeuralKernels::instructionSet = "SCALAR";
+
+// Select the kernels at startup
+static const bool kernelsSelected = (NeuralKernels::select(), true);
+
+/*********************** GETTERS ***********************************/
+
+// Get Instruction Set
+const char * NeuralKernels::getInstructionSet()
+{
+    return NeuralKernels::instructionSet;
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Select Kernels
+void NeuralKernels::select()
+{
+    // Start from the portable kernels
+    NeuralKernels::dotKernel = dotScalar<double>;
+    NeuralKernels::dot4Kernel = dot4Scalar<double>;
+    NeuralKernels::axpyKernel = axpyScalar<double>;
+    NeuralKernels::dotKernelF = dotScalar<float>;
+    NeuralKernels::dot4KernelF = dot4Scalar<float>;
+    NeuralKernels::axpyKernelF = axpyScalar<float>;
+    NeuralKernels::dotKernelI8 = dotScalarI8;
+    NeuralKernels::momentumKernel = momentumScalar<double>;
+    NeuralKernels::rmspropKernel = rmspropScalar<double>;
+    NeuralKernels::adamKernel = adamScalar<double>;
+    NeuralKernels::momentumKernelF = momentumScalar<float>;
+    NeuralKernels::rmspropKernelF = rmspropScalar<float>;
+    NeuralKernels::adamKernelF = adamScalar<float>;
+    NeuralKernels::sigmoidKernel = sigmoidScalar<double>;
+    NeuralKernels::tanhKernel = tanhScalar<double>;
+    NeuralKernels::sigmoidKernelF = sigmoidScalar<float>;
+    NeuralKernels::tanhKernelF = tanhScalar<float>;
+    NeuralKernels::instructionSet = "SCALAR";
+
+#ifdef NEURALKERNELS_X86
+    // ADAM_KERNELS may cap the instruction set (SCALAR, SSE2, AVX2) for comparisons
+    const char *cap = std::getenv("ADAM_KERNELS");
+    int limit = 3;
+    if (cap && std::strcmp(cap, "SCALAR") == 0)
+    {
+        limit = 0;
+    }
+    else if (cap && std::strcmp(cap, "SSE2") == 0)
+    {
+        limit = 1;
+    }
+    else if (cap && std::strcmp(cap, "AVX2") == 0)
+    {
+        limit = 2;
+    }
+
+    // CPUID feature flags (the builtin also checks the OS saves the wide registers)
+    __builtin_cpu_init();
+    if (limit >= 3 && __builtin_cpu_supports("avx512f"))
+    {
+        NeuralKernels::dotKernel = dotAvx512;
+        NeuralKernels::dot4Kernel = dot4Avx512;
+        NeuralKernels::axpyKernel = axpyAvx512;
+        NeuralKernels::dotKernelF = dotAvx512F;
+        NeuralKernels::dot4KernelF = dot4Avx512F;
+        NeuralKernels::axpyKernelF = axpyAvx512F;
+        NeuralKernels::dotKernelI8 = dotAvx2I8; // 512 bit int8 needs AVX-512BW, AVX2 suffices
+        NeuralKernels::momentumKernel = momentumAvx512;
+        NeuralKernels::rmspropKernel = rmspropAvx512;
+        NeuralKernels::adamKernel = adamAvx512;
+        NeuralKernels::momentumKernelF = momentumAvx512F;
+        NeuralKernels::rmspropKernelF = rmspropAvx512F;
+        NeuralKernels::adamKernelF = adamAvx512F;
+        NeuralKernels::sigmoidKernel = sigmoidAvx512;
+        NeuralKernels::tanhKernel = tanhAvx512;
+        NeuralKernels::sigmoidKernelF = sigmoidAvx512F;
+        NeuralKernels::tanhKernelF = tanhAvx512F;
+        NeuralKernels::instructionSet = "AVX-512";
+    }
+    else if (limit >= 2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        NeuralKernels::dotKernel = dotAvx2;
+        NeuralKernels::dot4Kernel = dot4Avx2;
+        NeuralKernels::axpyKernel = axpyAvx2;
+        NeuralKernels::dotKernelF = dotAvx2F;
+        NeuralKernels::dot4KernelF = dot4Avx2F;
+        NeuralKernels::axpyKernelF = axpyAvx2F;
+        NeuralKernels::dotKernelI8 = dotAvx2I8;
+        NeuralKernels::momentumKernel = momentumAvx2;
+        NeuralKernels::rmspropKernel = rmspropAvx2;
+        NeuralKernels::adamKernel = adamAvx2;
+        NeuralKernels::momentumKernelF = momentumAvx2F;
+        NeuralKernels::rmspropKernelF = rmspropAvx2F;
+        NeuralKernels::adamKernelF = adamAvx2F;
+        NeuralKernels::sigmoidKernel = sigmoidAvx2;
+        NeuralKernels::tanhKernel = tanhAvx2;
+        NeuralKernels::sigmoidKernelF = sigmoidAvx2F;
+        NeuralKernels::tanhKernelF = tanhAvx2F;
+        NeuralKernels::instructionSet = "AVX2";
+    }
+    else if (limit >= 1 && __builtin_cpu_supports("sse2"))
+    {
+        NeuralKernels::dotKernel = dotSse2;
+        NeuralKernels::dot4Kernel = dot4Sse2;
+        NeuralKernels::axpyKernel = axpySse2;
+        NeuralKernels::dotKernelF = dotSse2F;
+        NeuralKernels::dot4KernelF = dot4Sse2F;
+        NeuralKernels::axpyKernelF = axpySse2F;
+        NeuralKernels::dotKernelI8 = dotSse2I8;
+        NeuralKernels::momentumKernel = momentumSse2;
+        NeuralKernels::rmspropKernel = rmspropSse2;
+        NeuralKernels::adamKernel = adamSse2;
+        NeuralKernels::momentumKernelF = momentumSse2F;
+        NeuralKernels::rmspropKernelF = rmspropSse2F;
+        NeuralKernels::adamKernelF = adamSse2F;
+        NeuralKernels::sigmoidKernel = sigmoidSse2;
+        NeuralKernels::tanhKernel = tanhSse2;
+        NeuralKernels::sigmoidKernelF = sigmoidSse2F;
+        NeuralKernels::tanhKernelF = tanhSse2F;
+        NeuralKernels::instructionSet = "SSE2";
+    }
+#endif
+}
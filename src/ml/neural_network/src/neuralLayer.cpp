@@ -2,19 +2,27 @@
 #include "neuralLayer.hpp"
 #endif
 
+#include <algorithm>
+#include <functional>
+
 /*********************** CONSTRUCTORS ******************************/
 
 // Default
-NeuralLayer::NeuralLayer()
+template<typename T>
+NeuralLayerT<T>::NeuralLayerT()
 {
     this->initialized = false;
     this->finalized = false;
     this->activated = false;
     this->inputCount = 0;
+    this->weightStride = 0;
+    this->weightData = nullptr;
+    this->activationMode = NeuralActivationMode::EXACT;
 }
 
 // Constructor with inputCount and neuronCount - unassigned weights
-NeuralLayer::NeuralLayer(unsigned int neuronCount, unsigned int inputCount): NeuralLayer()
+template<typename T>
+NeuralLayerT<T>::NeuralLayerT(unsigned int neuronCount, unsigned int inputCount): NeuralLayerT()
 {
     // Check if an input count was given
     if (inputCount == 0)
@@ -32,23 +40,32 @@ NeuralLayer::NeuralLayer(unsigned int neuronCount, unsigned int inputCount): Neu
     
     // Input count set
     this->inputCount = inputCount;
+    this->weightStride = alignedStride<T>(inputCount + 1);
+    this->weights.reserve((size_t)neuronCount * this->weightStride);
+    this->activationTypes.reserve(neuronCount);
 
     // Create neurons based on size (this can be zero)
-    for (unsigned short i = 0; i < neuronCount; i++)
+    std::vector<T> row(inputCount + 1);
+    for (unsigned int i = 0; i < neuronCount; i++)
     {
-        // This creates a neuron with random weights and default assignment
-        Neuron neuron(inputCount);
+        // This creates random weights with the default assignment
+        for (T &weight : row)
+        {
+            weight = .6*(double)rand() / RAND_MAX - 0.3;
+        }
 
-        // Adds the weight to the vector
-        this->layer.push_back(neuron);
+        // Adds the weights to the matrix
+        this->appendRow(row.data(), NeuralActivationType::SIGMOID);
 
         // At least one neuron was added, it is now officially initialized
         this->initialized = true;
     }
+    this->bindNeurons();
 }
 
 // Constructor with defined neurons
-NeuralLayer::NeuralLayer(std::vector<Neuron> *neurons): NeuralLayer()
+template<typename T>
+NeuralLayerT<T>::NeuralLayerT(std::vector<NeuronT<T>> *neurons): NeuralLayerT()
 {
     // Check that the vector is empty or null
     if (!neurons || neurons->size() == 0)
@@ -59,7 +76,7 @@ NeuralLayer::NeuralLayer(std::vector<Neuron> *neurons): NeuralLayer()
 
     // Check the the supplied layer has the same expected input
     unsigned int inputSizeCheck = 0;
-    for ( Neuron neuron : *neurons)
+    for ( NeuronT<T> neuron : *neurons)
     {
         // Fetch the first input count
         if (inputSizeCheck == 0)
@@ -77,16 +94,107 @@ NeuralLayer::NeuralLayer(std::vector<Neuron> *neurons): NeuralLayer()
         }
     }
 
-    // Clone the vector
-    this->layer = *neurons;
+    // Copy the neurons into the contiguous storage
     this->inputCount = inputSizeCheck;
+    this->weightStride = alignedStride<T>(inputSizeCheck + 1);
+    this->weights.reserve(neurons->size() * this->weightStride);
+    this->activationTypes.reserve(neurons->size());
+    for (NeuronT<T> &neuron : *neurons)
+    {
+        this->appendRow(neuron.getWeightData(), neuron.getActivationType());
+    }
+    this->bindNeurons();
     this->initialized = true;
 }
 
+// Constructor viewing external (EX: memory mapped) weight storage
+template<typename T>
+NeuralLayerT<T>::NeuralLayerT(unsigned int inputCount, unsigned int weightStride,
+                            std::vector<NeuralActivationType> *types,
+                            T *weights, std::shared_ptr<void> storage): NeuralLayerT()
+{
+    this->inputCount = inputCount;
+    this->weightStride = weightStride;
+    this->activationTypes = *types;
+    this->layerMemory.assign(types->size(), -12345678.9);
+    this->weightData = weights;
+    this->mappedStorage = storage;
+    this->bindNeurons();
+    this->initialized = !types->empty();
+}
+
+// Copy Constructor
+template<typename T>
+NeuralLayerT<T>::NeuralLayerT(const NeuralLayerT<T> &other)
+{
+    *this = other;
+}
+
+// Move Constructor
+template<typename T>
+NeuralLayerT<T>::NeuralLayerT(NeuralLayerT<T> &&other)
+{
+    *this = std::move(other);
+}
+
+// Copy Assignment
+template<typename T>
+NeuralLayerT<T> & NeuralLayerT<T>::operator=(const NeuralLayerT<T> &other)
+{
+    // Guard self assignment, the weights are re-read from the source below
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    this->initialized = other.initialized;
+    this->finalized = other.finalized;
+    this->activated = other.activated;
+    this->layerMemory = other.layerMemory;
+    this->inputCount = other.inputCount;
+    this->weightStride = other.weightStride;
+    this->activationTypes = other.activationTypes;
+    this->activationMode = other.activationMode;
+
+    // A copy always owns its weights, even when the source is mapped
+    size_t size = other.activationTypes.size() * (size_t)other.weightStride;
+    this->weights.assign(other.weightData, other.weightData + size);
+    this->weightData = this->weights.data();
+    this->mappedStorage.reset();
+
+    this->bindNeurons();
+    return *this;
+}
+
+// Move Assignment
+template<typename T>
+NeuralLayerT<T> & NeuralLayerT<T>::operator=(NeuralLayerT<T> &&other)
+{
+    this->initialized = other.initialized;
+    this->finalized = other.finalized;
+    this->activated = other.activated;
+    this->layerMemory = std::move(other.layerMemory);
+    this->inputCount = other.inputCount;
+    this->weightStride = other.weightStride;
+    this->activationTypes = std::move(other.activationTypes);
+    this->activationMode = other.activationMode;
+
+    // A move hands over the storage as is, owned or mapped
+    this->weights = std::move(other.weights);
+    this->mappedStorage = std::move(other.mappedStorage);
+    this->weightData = this->mappedStorage ? other.weightData : this->weights.data();
+    other.weightData = nullptr;
+
+    this->bindNeurons();
+    other.layer.clear();
+    return *this;
+}
+
 /*********************** DESTRUCTORS *******************************/
 
 // Default Decontructor
-NeuralLayer::~NeuralLayer()
+template<typename T>
+NeuralLayerT<T>::~NeuralLayerT()
 {
     // This object maintains ownership of data, no pointers to clean up
 } 
@@ -94,45 +202,71 @@ NeuralLayer::~NeuralLayer()
 /*********************** SETTERS ***********************************/
 
 // Finalize Layer
-void NeuralLayer::finalize()
+template<typename T>
+void NeuralLayerT<T>::finalize()
 {
     this->finalized = true;
 }
 
+// Set Activation Mode
+template<typename T>
+void NeuralLayerT<T>::setActivationMode(NeuralActivationMode mode)
+{
+    this->activationMode = mode;
+}
+
 /*********************** GETTERS ***********************************/
 
 // Is Initialized?
-bool NeuralLayer::isInitialized()
+template<typename T>
+bool NeuralLayerT<T>::isInitialized()
 {
     return this->initialized;
 }
 
 // Is Finalized?
-bool NeuralLayer::isFinalized()
+template<typename T>
+bool NeuralLayerT<T>::isFinalized()
 {
     return this->finalized;
 }
 
 // Has activated?
-bool NeuralLayer::hasActivated()
+template<typename T>
+bool NeuralLayerT<T>::hasActivated()
 {
     return this->activated;
 }
 
 // Get Layer Input Count
-unsigned int NeuralLayer::getInputCount()
+template<typename T>
+unsigned int NeuralLayerT<T>::getInputCount() const
 {
     return this->inputCount;
 }
 
 // Get Layer Memory
-std::vector<double> NeuralLayer::getLayerMemory()
+template<typename T>
+std::vector<T> NeuralLayerT<T>::getLayerMemory()
+{
+    // No memory is retained until the layer has fired
+    if (!this->activated)
+    {
+        return std::vector<T>();
+    }
+    return std::vector<T>(this->layerMemory.begin(), this->layerMemory.end());
+}
+
+// Get Layer Memory Data
+template<typename T>
+const T * NeuralLayerT<T>::getLayerMemoryData() const
 {
-    return this->layerMemory;
+    return this->layerMemory.data();
 }
 
 // Get Pointer to Neuron in Layer 
-Neuron * NeuralLayer::getNeuron(unsigned int neuronIdx)
+template<typename T>
+NeuronT<T> * NeuralLayerT<T>::getNeuron(unsigned int neuronIdx)
 {   
     // We only set this if our object is initialized
     if (!this->isInitialized())
@@ -142,23 +276,60 @@ Neuron * NeuralLayer::getNeuron(unsigned int neuronIdx)
     }
     if (neuronIdx < (unsigned int)this->layer.size())
     {
-        Neuron * returnPtr = &this->layer[neuronIdx];
+        NeuronT<T> * returnPtr = &this->layer[neuronIdx];
         return returnPtr;
     }
     return nullptr;
 }
 
+// Get Weight Matrix
+template<typename T>
+T * NeuralLayerT<T>::getWeightMatrix()
+{
+    return this->weightData;
+}
+
+// Is Mapped?
+template<typename T>
+bool NeuralLayerT<T>::isMapped() const
+{
+    return (bool)this->mappedStorage;
+}
+
+// Get Weight Stride
+template<typename T>
+unsigned int NeuralLayerT<T>::getWeightStride() const
+{
+    return this->weightStride;
+}
+
+// Get Activation Types
+template<typename T>
+const NeuralActivationType * NeuralLayerT<T>::getActivationTypes() const
+{
+    return this->activationTypes.data();
+}
+
+// Get Activation Mode
+template<typename T>
+NeuralActivationMode NeuralLayerT<T>::getActivationMode() const
+{
+    return this->activationMode;
+}
+
 /*********************** FUNCTIONAL ********************************/
 
 // Clearn Layer
-void NeuralLayer::clearLayer()
+template<typename T>
+void NeuralLayerT<T>::clearLayer()
 {
     this->activated = false;
-    this->layerMemory = std::vector<double>();
+    std::fill(this->layerMemory.begin(), this->layerMemory.end(), -12345678.9);
 }
 
 // Add a neuron to the layer
-void NeuralLayer::addNeuron(Neuron neuron)
+template<typename T>
+void NeuralLayerT<T>::addNeuron(NeuronT<T> neuron)
 {
     // Check if the layer is locked
     if(this->isFinalized())
@@ -184,31 +355,229 @@ void NeuralLayer::addNeuron(Neuron neuron)
     // Set the initialization, incase constructed with neuronCount = 0
     this->initialized = true;
 
-    // Add the neuron to the layer
-    this->layer.push_back(neuron);
+    // Add the neuron to the layer (storage may move, so re-bind the views)
+    this->appendRow(neuron.getWeightData(), neuron.getActivationType());
+    this->bindNeurons();
 }
 
 // Layer Recall
-std::vector<double> NeuralLayer::recall(std::vector<double> *inputs)
+template<typename T>
+std::vector<T> NeuralLayerT<T>::recall(std::vector<T> *inputs)
 {
-    // This resets the layer memory
-    this->layerMemory = std::vector<double>();
-
-    // Loop through each neuron and recall
-    for(Neuron &neuron : this->layer)
+    // Check that the vector is empty or null
+    if (!inputs || inputs->size() < this->inputCount)
     {
-        // Add the neurons memory into a vector for easy access
-        this->layerMemory.push_back(neuron.recall(inputs));
+        std::cout << "Error: invalid input size, expected " << this->inputCount << std::endl;
+        return std::vector<T>();
     }
+
+    // Fire every neuron straight into the layer memory
+    this->forward(inputs->data(), this->layerMemory.data());
     this->activated = true;
 
     // Return the results
-    return this->layerMemory;
+    return std::vector<T>(this->layerMemory.begin(), this->layerMemory.end());
+}
+
+// Layer Forward Pass
+template<typename T>
+void NeuralLayerT<T>::forward(const T *inputs, T *outputs) const
+{
+    const unsigned int count = (unsigned int)this->activationTypes.size();
+    for (unsigned int neuronIdx = 0; neuronIdx < count; neuronIdx++)
+    {
+        // Calculate sum with the bias first multiplied by one, then the input*weight vectors
+        const T *row = this->weightData + (size_t)neuronIdx * this->weightStride;
+        outputs[neuronIdx] = row[0] + NeuralKernels::dot(row + 1, inputs, this->inputCount);
+    }
+
+    // Then activate the whole layer at once
+    this->activateRow(outputs, outputs);
+}
+
+// Layer Batch Forward Pass
+template<typename T>
+void NeuralLayerT<T>::forwardBatch(const T *inputs, unsigned int sampleCount, T *outputs) const
+{
+    const unsigned int count = (unsigned int)this->activationTypes.size();
+
+    // A layer of one activation type is activated a block of samples at a time
+    const bool uniform = std::adjacent_find(this->activationTypes.begin(), this->activationTypes.end(),
+                                            std::not_equal_to<NeuralActivationType>()) == this->activationTypes.end();
+
+    // Work through the batch one block of samples at a time
+    for (unsigned int sampleStart = 0; sampleStart < sampleCount; sampleStart += SAMPLE_BLOCK)
+    {
+        const unsigned int sampleEnd = std::min(sampleStart + SAMPLE_BLOCK, sampleCount);
+
+        // Every sum starts with the bias of its neuron
+        for (unsigned int sampleIdx = sampleStart; sampleIdx < sampleEnd; sampleIdx++)
+        {
+            T *sums = outputs + (size_t)sampleIdx * count;
+            for (unsigned int neuronIdx = 0; neuronIdx < count; neuronIdx++)
+            {
+                sums[neuronIdx] = this->weightData[(size_t)neuronIdx * this->weightStride];
+            }
+        }
+
+        // Each slice of a weight row is reused across the block of samples
+        for (unsigned int inputStart = 0; inputStart < this->inputCount; inputStart += INPUT_BLOCK)
+        {
+            const unsigned int inputSpan = std::min(inputStart + INPUT_BLOCK, this->inputCount) - inputStart;
+            for (unsigned int neuronIdx = 0; neuronIdx < count; neuronIdx++)
+            {
+                const T *row = this->weightData + (size_t)neuronIdx * this->weightStride + 1 + inputStart;
+
+                // Four samples at a time share each weight load
+                unsigned int sampleIdx = sampleStart;
+                for (; sampleIdx + 4 <= sampleEnd; sampleIdx += 4)
+                {
+                    const T *x0 = inputs + (size_t)sampleIdx * this->inputCount + inputStart;
+                    const T *x1 = x0 + this->inputCount;
+                    const T *x2 = x1 + this->inputCount;
+                    const T *x3 = x2 + this->inputCount;
+                    T sums[4];
+                    NeuralKernels::dot4(row, x0, x1, x2, x3, inputSpan, sums);
+                    outputs[(size_t)sampleIdx * count + neuronIdx] += sums[0];
+                    outputs[(size_t)(sampleIdx + 1) * count + neuronIdx] += sums[1];
+                    outputs[(size_t)(sampleIdx + 2) * count + neuronIdx] += sums[2];
+                    outputs[(size_t)(sampleIdx + 3) * count + neuronIdx] += sums[3];
+                }
+
+                // Remaining samples of the block
+                for (; sampleIdx < sampleEnd; sampleIdx++)
+                {
+                    const T *x = inputs + (size_t)sampleIdx * this->inputCount + inputStart;
+                    outputs[(size_t)sampleIdx * count + neuronIdx] += NeuralKernels::dot(row, x, inputSpan);
+                }
+            }
+        }
+
+        // Activate the block while it is still in cache
+        T *blockSums = outputs + (size_t)sampleStart * count;
+        if (uniform && count > 0)
+        {
+            this->activateValues(this->activationTypes[0], blockSums, blockSums,
+                                 (size_t)(sampleEnd - sampleStart) * count);
+            continue;
+        }
+        for (unsigned int sampleIdx = sampleStart; sampleIdx < sampleEnd; sampleIdx++)
+        {
+            T *sums = outputs + (size_t)sampleIdx * count;
+            this->activateRow(sums, sums);
+        }
+    }
 }
 
 
 // Neuron Count in Layer
-unsigned int NeuralLayer::neuronCount()
+template<typename T>
+unsigned int NeuralLayerT<T>::neuronCount() const
 {
     return (unsigned int)this->layer.size();
-}
\ No newline at end of file
+}
+
+// Append Weight Row
+template<typename T>
+void NeuralLayerT<T>::appendRow(const T *weights, NeuralActivationType type)
+{
+    // Mapped storage cannot grow, so take a private copy first
+    if (this->mappedStorage)
+    {
+        size_t size = this->activationTypes.size() * (size_t)this->weightStride;
+        this->weights.assign(this->weightData, this->weightData + size);
+        this->mappedStorage.reset();
+    }
+
+    // New rows are zero padded out to the stride
+    size_t offset = this->weights.size();
+    this->weights.resize(offset + this->weightStride, 0.0);
+    std::copy(weights, weights + this->inputCount + 1, this->weights.begin() + offset);
+    this->weightData = this->weights.data();
+
+    this->activationTypes.push_back(type);
+    this->layerMemory.push_back(-12345678.9);
+}
+
+// Bind Neuron Views
+template<typename T>
+void NeuralLayerT<T>::bindNeurons()
+{
+    this->layer.clear();
+    this->layer.reserve(this->activationTypes.size());
+    for (unsigned int i = 0; i < (unsigned int)this->activationTypes.size(); i++)
+    {
+        this->layer.push_back(NeuronT<T>(this->inputCount,
+                                     this->weightData + (size_t)i * this->weightStride,
+                                     this->layerMemory.data() + i,
+                                     &this->activated,
+                                     this->activationTypes.data() + i));
+    }
+}
+
+// Forward Train
+template<typename T>
+void NeuralLayerT<T>::forwardTrain(const T *inputs, T *outputs, T *derivatives) const
+{
+    // The weighted sums are activated in place
+    const unsigned int count = (unsigned int)this->activationTypes.size();
+    for (unsigned int neuronIdx = 0; neuronIdx < count; neuronIdx++)
+    {
+        const T *row = this->weightData + (size_t)neuronIdx * this->weightStride;
+        outputs[neuronIdx] = row[0] + NeuralKernels::dot(row + 1, inputs, this->inputCount);
+    }
+    this->activateRow(outputs, outputs);
+
+    // The slopes come from the activations just computed
+    for (unsigned int neuronIdx = 0; neuronIdx < count; neuronIdx++)
+    {
+        derivatives[neuronIdx] = NeuronT<T>::derivative(outputs[neuronIdx], this->activationTypes[neuronIdx]);
+    }
+}
+
+// Activate Row
+template<typename T>
+void NeuralLayerT<T>::activateRow(const T *sums, T *outputs) const
+{
+    // Hand each run of one activation type to the kernels together
+    const size_t count = this->activationTypes.size();
+    size_t start = 0;
+    while (start < count)
+    {
+        const NeuralActivationType type = this->activationTypes[start];
+        size_t end = start + 1;
+        while (end < count && this->activationTypes[end] == type)
+        {
+            end++;
+        }
+        this->activateValues(type, sums + start, outputs + start, end - start);
+        start = end;
+    }
+}
+
+// Activate Values
+template<typename T>
+void NeuralLayerT<T>::activateValues(NeuralActivationType type, const T *sums, T *outputs, size_t count) const
+{
+    const bool fast = this->activationMode == NeuralActivationMode::FAST;
+    switch(type)
+    {
+        case NeuralActivationType::SIGMOID:
+            NeuralKernels::sigmoid(sums, outputs, (unsigned int)count, fast);
+            break;
+        case NeuralActivationType::HYPERBOLIC_TANGENT:
+            NeuralKernels::hyperbolicTangent(sums, outputs, (unsigned int)count, fast);
+            break;
+        default:
+            for (size_t i = 0; i < count; i++)
+            {
+                outputs[i] = NeuronT<T>::activate(sums[i], type);
+            }
+            break;
+    }
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralLayerT<float>;
+template class NeuralLayerT<double>;
@@ -2,14 +2,66 @@
 #include "neuralNetwork.hpp"
 #endif
 
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+    /// Model file header (64 bytes)
+    struct ModelHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t scalarSize;
+        uint32_t endianMarker;
+        uint32_t layerCount;
+        uint32_t inputCount;
+        uint32_t reserved;
+        double trainedAccuracy;
+        double trueAccuracy;
+        uint8_t padding[16];
+    };
+
+    /// Model file layer table entry (32 bytes)
+    struct ModelLayerEntry
+    {
+        uint32_t neuronCount;
+        uint32_t inputCount;
+        uint32_t weightStride;
+        uint32_t reserved;
+        uint64_t activationOffset;
+        uint64_t weightOffset;
+    };
+
+    const char MODEL_MAGIC[8] = {'A', 'D', 'A', 'M', 'N', 'N', 'E', 'T'};
+    const uint32_t MODEL_ENDIAN_MARKER = 0x01020304;
+
+    static_assert(sizeof(ModelHeader) == 64, "model header must be 64 bytes");
+    static_assert(sizeof(ModelLayerEntry) == 32, "model layer entry must be 32 bytes");
+
+    // Round an offset up to the model block alignment
+    uint64_t alignOffset(uint64_t offset)
+    {
+        return (offset + ADAM_ALIGNMENT - 1) / ADAM_ALIGNMENT * ADAM_ALIGNMENT;
+    }
+}
+
 /*********************** CONSTRUCTORS ******************************/
 
 // Default
-NeuralNetwork::NeuralNetwork()
+template<typename T>
+NeuralNetworkT<T>::NeuralNetworkT()
 {
     this->initialized = false;
     this->finalized = false;
     this->inputCount = 0;
+    this->activationMode = NeuralActivationMode::EXACT;
 
     // Initialize the network ratings to null values, these are otherwise only set by a trainer
     this->trainedAccuracy = -1.0;
@@ -17,7 +69,8 @@ NeuralNetwork::NeuralNetwork()
 }
 
 // Constructor with defined layers
-NeuralNetwork::NeuralNetwork(std::vector<NeuralLayer> *network): NeuralNetwork()
+template<typename T>
+NeuralNetworkT<T>::NeuralNetworkT(std::vector<NeuralLayerT<T>> *network): NeuralNetworkT()
 {
     // Check that the vector is empty or null
     if (!network || network->size() == 0)
@@ -29,6 +82,8 @@ NeuralNetwork::NeuralNetwork(std::vector<NeuralLayer> *network): NeuralNetwork()
     // Clone the vector
     this->network = *network;
     this->inputCount = this->network.at(0).getInputCount();
+    this->setActivationMode(this->activationMode);
+    ADAM_INSTRUMENT(this->instrumentation.shape(this->layerCount()));
 
     // If we made it here, should be good
     this->initialized = true;
@@ -36,7 +91,8 @@ NeuralNetwork::NeuralNetwork(std::vector<NeuralLayer> *network): NeuralNetwork()
 
 /*********************** DESTRUCTORS *******************************/
 
-NeuralNetwork::~NeuralNetwork()
+template<typename T>
+NeuralNetworkT<T>::~NeuralNetworkT()
 {
     // This object maintains ownership of data, no pointers to clean up
 } 
@@ -44,46 +100,101 @@ NeuralNetwork::~NeuralNetwork()
 /*********************** SETTERS ***********************************/
 
 // Finalize Network
-void NeuralNetwork::finalize()
+template<typename T>
+void NeuralNetworkT<T>::finalize()
 {
     this->finalized = true;
 }
 
+// Set Activation Mode
+template<typename T>
+void NeuralNetworkT<T>::setActivationMode(NeuralActivationMode mode)
+{
+    this->activationMode = mode;
+    for (NeuralLayerT<T> &layer : this->network)
+    {
+        layer.setActivationMode(mode);
+    }
+}
+
 /*********************** GETTERS ***********************************/
 
 // Is Initialized?
-bool NeuralNetwork::isInitialized()
+template<typename T>
+bool NeuralNetworkT<T>::isInitialized()
 {
     return this->initialized;
 }
 
 // Is Finalized?
-bool NeuralNetwork::isFinalized()
+template<typename T>
+bool NeuralNetworkT<T>::isFinalized()
 {
     return this->finalized;
 }
 
 // Get Training Accuracy
-double NeuralNetwork::getTrainedAccuracy()
+template<typename T>
+double NeuralNetworkT<T>::getTrainedAccuracy()
 {
     return this->trainedAccuracy;
 }
 
 // Get True Accuracy
-double NeuralNetwork::getTrueAccuracy()
+template<typename T>
+double NeuralNetworkT<T>::getTrueAccuracy()
 {
     return this->trueAccuracy;
 }
 
+// Get Classifier Count
+template<typename T>
+unsigned long NeuralNetworkT<T>::getClassifierCount(DatasetType dataset, BinaryClassifierType classifier)
+{
+    // Datasets that were never evaluated have no counts
+    if (this->classifierCounts.count(dataset) == 0 || this->classifierCounts[dataset].count(classifier) == 0)
+    {
+        return 0;
+    }
+    return this->classifierCounts[dataset][classifier];
+}
+
 
 // Returns Network Expected Input
-unsigned int NeuralNetwork::getInputCount()
+template<typename T>
+unsigned int NeuralNetworkT<T>::getInputCount()
 {
     return this->inputCount;
 }
 
+// Returns Network Output Count
+template<typename T>
+unsigned int NeuralNetworkT<T>::getOutputCount()
+{
+    if (this->network.empty())
+    {
+        return 0;
+    }
+    return this->network.back().neuronCount();
+}
+
+// Get Instrumentation
+template<typename T>
+const NeuralInstrumentation & NeuralNetworkT<T>::getInstrumentation() const
+{
+    return this->instrumentation;
+}
+
+// Get Activation Mode
+template<typename T>
+NeuralActivationMode NeuralNetworkT<T>::getActivationMode() const
+{
+    return this->activationMode;
+}
+
 // Get Network Memory
-std::vector<double> NeuralNetwork::getNetworkMemory()
+template<typename T>
+std::vector<T> NeuralNetworkT<T>::getNetworkMemory()
 {
     return this->networkMemory;
 }
@@ -91,7 +202,8 @@ std::vector<double> NeuralNetwork::getNetworkMemory()
 /*********************** FUNCTIONAL ********************************/
 
 // Add Defaul Layer to Network
-void NeuralNetwork::addLayer(unsigned int neuronCount, unsigned int inputCount)
+template<typename T>
+void NeuralNetworkT<T>::addLayer(unsigned int neuronCount, unsigned int inputCount)
 {
     // Check that the first layer has a defined input count
     if (this->layerCount() == 0 && inputCount == 0)
@@ -113,12 +225,15 @@ void NeuralNetwork::addLayer(unsigned int neuronCount, unsigned int inputCount)
     // Finalize the previous layer
 
     // Add a new layer to the network
-    NeuralLayer layer(neuronCount, inputCount);
+    NeuralLayerT<T> layer(neuronCount, inputCount);
+    layer.setActivationMode(this->activationMode);
     this->network.push_back(layer);
+    ADAM_INSTRUMENT(this->instrumentation.shape(this->layerCount()));
 }
 
 // Add Layer to Network
-void NeuralNetwork::addLayer(NeuralLayer layer)
+template<typename T>
+void NeuralNetworkT<T>::addLayer(NeuralLayerT<T> layer)
 {
     // Check if the network is locked
     if(this->isFinalized())
@@ -152,31 +267,440 @@ void NeuralNetwork::addLayer(NeuralLayer layer)
     }
     
     // Add the layer
+    layer.setActivationMode(this->activationMode);
     this->network.push_back(layer);
+    ADAM_INSTRUMENT(this->instrumentation.shape(this->layerCount()));
 }
 
 // Get Layer Count
-unsigned int NeuralNetwork::layerCount()
+template<typename T>
+unsigned int NeuralNetworkT<T>::layerCount()
 {
     return (unsigned int)this->network.size();
 }
 
+// Get Pointer to Layer in Network
+template<typename T>
+NeuralLayerT<T> * NeuralNetworkT<T>::getLayer(unsigned int layerIdx)
+{
+    if (layerIdx < (unsigned int)this->network.size())
+    {
+        return &this->network[layerIdx];
+    }
+    return nullptr;
+}
+
 // Network Recall
-std::vector<double> NeuralNetwork::recall(std::vector<double> *input)
+template<typename T>
+std::vector<T> NeuralNetworkT<T>::recall(std::vector<T> *input)
 {
-    std::vector<double> * layerInput = input;
-    std::vector<double> layerOutput;
+    // Check that the network has something to fire
+    if (this->network.empty())
+    {
+        std::cout << "Error: network has no layers" << std::endl;
+        return std::vector<T>();
+    }
 
-    // We look through the layers, and forward feed the inputs
-    for (NeuralLayer &layer : this->network)
+    // Check the input size once, the layers are fed by pointer
+    if (!input || input->size() < this->inputCount)
     {
-        // Loop through and recall each layer.
-        layerOutput = layer.recall(layerInput);
+        std::cout << "Error: invalid input size, expected " << this->inputCount << std::endl;
+        return std::vector<T>();
+    }
 
-        layerInput = &layerOutput;
+    // We look through the layers, and forward feed each layer memory into the next
+    const T *layerInput = input->data();
+    for (unsigned int layerIdx = 0; layerIdx < this->layerCount(); layerIdx++)
+    {
+        NeuralLayerT<T> &layer = this->network[layerIdx];
+        ADAM_INSTRUMENT(const uint64_t start = NeuralInstrumentation::now());
+        layer.forward(layerInput, layer.layerMemory.data());
+        ADAM_INSTRUMENT(this->instrumentation.recordForward(layerIdx, NeuralInstrumentation::now() - start, 1));
+        layer.activated = true;
+
+        layerInput = layer.layerMemory.data();
     }
     
     // Network output is the output of the last layer
-    this->networkMemory = layerOutput;
+    const AlignedVector<T> &layerOutput = this->network.back().layerMemory;
+    this->networkMemory.assign(layerOutput.begin(), layerOutput.end());
     return this->networkMemory;
-}
\ No newline at end of file
+}
+
+// Network Recall (const, caller context)
+template<typename T>
+std::vector<T> NeuralNetworkT<T>::recall(const std::vector<T> &inputs, NeuralContextT<T> *context) const
+{
+    // Check that the network has something to fire
+    if (this->network.empty() || !context)
+    {
+        std::cout << "Error: network has no layers or context pointer null" << std::endl;
+        return std::vector<T>();
+    }
+
+    // Check the input size
+    if (inputs.size() != this->inputCount)
+    {
+        std::cout << "Error: invalid input size, expected " << this->inputCount << std::endl;
+        return std::vector<T>();
+    }
+
+    const T *outputs = this->recall(inputs.data(), context);
+    return std::vector<T>(outputs, outputs + this->network.back().neuronCount());
+}
+
+// Network Recall (const, caller context, raw)
+template<typename T>
+const T * NeuralNetworkT<T>::recall(const T *inputs, NeuralContextT<T> *context) const
+{
+    // Make room for the widest layer (a no-op once the context has served this network)
+    unsigned int widest = 0;
+    for (const NeuralLayerT<T> &layer : this->network)
+    {
+        widest = std::max(widest, layer.neuronCount());
+    }
+    context->reserve(widest);
+
+    // Each layer reads the activations of the last and writes the other buffer
+    const T *layerInput = inputs;
+    for (unsigned int layerIdx = 0; layerIdx < (unsigned int)this->network.size(); layerIdx++)
+    {
+        T *layerOutput = context->next();
+        ADAM_INSTRUMENT(const uint64_t start = NeuralInstrumentation::now());
+        this->network[layerIdx].forward(layerInput, layerOutput);
+        ADAM_INSTRUMENT(this->instrumentation.recordForward(layerIdx, NeuralInstrumentation::now() - start, 1));
+        layerInput = layerOutput;
+    }
+    return layerInput;
+}
+
+// Network Batch Recall
+template<typename T>
+std::vector<T> NeuralNetworkT<T>::recallBatch(std::vector<T> *inputs, unsigned int sampleCount)
+{
+    // Check that the network has something to fire
+    if (this->network.empty())
+    {
+        std::cout << "Error: network has no layers" << std::endl;
+        return std::vector<T>();
+    }
+
+    // Check that the buffer holds the given number of samples
+    if (!inputs || inputs->size() != (size_t)sampleCount * this->inputCount)
+    {
+        std::cout << "Error: inputs must hold sampleCount * " << this->inputCount << " values" << std::endl;
+        return std::vector<T>();
+    }
+
+    std::vector<T> outputs((size_t)sampleCount * this->getOutputCount());
+    this->recallBatch(inputs->data(), sampleCount, outputs.data());
+    return outputs;
+}
+
+// Network Batch Recall (raw)
+template<typename T>
+void NeuralNetworkT<T>::recallBatch(const T *inputs, unsigned int sampleCount, T *outputs)
+{
+    this->recallBatch(inputs, sampleCount, outputs, &this->batchContext);
+}
+
+// Network Batch Recall (data view)
+template<typename T>
+void NeuralNetworkT<T>::recallBatch(const NeuralDataViewT<T> &inputs, T *outputs)
+{
+    this->recallBatch(inputs, outputs, &this->batchContext);
+}
+
+// Network Batch Recall (raw, caller context)
+template<typename T>
+void NeuralNetworkT<T>::recallBatch(const T *inputs, unsigned int sampleCount, T *outputs,
+                                    NeuralContextT<T> *context) const
+{
+    const unsigned int lastLayer = (unsigned int)this->network.size() - 1;
+    const unsigned int outputCount = this->network[lastLayer].neuronCount();
+
+    // Size the ping-pong buffers to a chunk of the widest layer
+    unsigned int widest = 0;
+    for (const NeuralLayerT<T> &layer : this->network)
+    {
+        widest = std::max(widest, layer.neuronCount());
+    }
+    context->reserve(BATCH_CHUNK * widest);
+
+    // Carry each chunk of samples through every layer while it is in cache
+    for (unsigned int chunkStart = 0; chunkStart < sampleCount; chunkStart += BATCH_CHUNK)
+    {
+        const unsigned int chunkSize = std::min(chunkStart + BATCH_CHUNK, sampleCount) - chunkStart;
+        const T *layerInput = inputs + (size_t)chunkStart * this->inputCount;
+
+        for (unsigned int layerIdx = 0; layerIdx <= lastLayer; layerIdx++)
+        {
+            // The last layer writes straight into the caller's buffer
+            T *layerOutput = (layerIdx == lastLayer) ? outputs + (size_t)chunkStart * outputCount
+                                                          : context->next();
+            ADAM_INSTRUMENT(const uint64_t start = NeuralInstrumentation::now());
+            this->network[layerIdx].forwardBatch(layerInput, chunkSize, layerOutput);
+            ADAM_INSTRUMENT(this->instrumentation.recordForward(layerIdx, NeuralInstrumentation::now() - start, chunkSize));
+
+            layerInput = layerOutput;
+        }
+    }
+}
+
+// Network Batch Recall (data view, caller context)
+template<typename T>
+void NeuralNetworkT<T>::recallBatch(const NeuralDataViewT<T> &inputs, T *outputs, NeuralContextT<T> *context) const
+{
+    // Check that the view can feed the network
+    if (this->network.empty() || inputs.getColumnCount() != this->inputCount)
+    {
+        std::cout << "Error: network has no layers or view does not have " << this->inputCount << " columns" << std::endl;
+        return;
+    }
+
+    const unsigned int rows = inputs.getRowCount();
+    if (rows == 0)
+    {
+        return;
+    }
+
+    // Packed rows need no copy
+    if (inputs.isContiguous())
+    {
+        this->recallBatch(inputs.row(0), rows, outputs, context);
+        return;
+    }
+
+    const unsigned int outputCount = this->network.back().neuronCount();
+    T *packed = context->stage((size_t)std::min(rows, (unsigned int)VIEW_CHUNK) * this->inputCount);
+    for (unsigned int chunkStart = 0; chunkStart < rows; chunkStart += VIEW_CHUNK)
+    {
+        const unsigned int chunkSize = std::min(chunkStart + VIEW_CHUNK, rows) - chunkStart;
+        for (unsigned int rowIdx = 0; rowIdx < chunkSize; rowIdx++)
+        {
+            const T *row = inputs.row(chunkStart + rowIdx);
+            std::copy(row, row + this->inputCount, packed + (size_t)rowIdx * this->inputCount);
+        }
+        this->recallBatch(packed, chunkSize, outputs + (size_t)chunkStart * outputCount, context);
+    }
+}
+
+// Export Network
+template<typename T>
+bool NeuralNetworkT<T>::exportNetwork(const std::string &path)
+{
+    // Check that there is something to export
+    if (this->network.empty())
+    {
+        std::cout << "Error: network has no layers, skipping export" << std::endl;
+        return false;
+    }
+
+    ModelHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MODEL_MAGIC, sizeof(header.magic));
+    header.version = MODEL_VERSION;
+    header.scalarSize = sizeof(T);
+    header.endianMarker = MODEL_ENDIAN_MARKER;
+    header.layerCount = (uint32_t)this->network.size();
+    header.inputCount = this->inputCount;
+    header.trainedAccuracy = this->trainedAccuracy;
+    header.trueAccuracy = this->trueAccuracy;
+
+    // Lay out the activation types, then the aligned weight blocks
+    std::vector<ModelLayerEntry> table(this->network.size());
+    uint64_t offset = sizeof(ModelHeader) + table.size() * sizeof(ModelLayerEntry);
+    for (size_t layerIdx = 0; layerIdx < this->network.size(); layerIdx++)
+    {
+        std::memset(&table[layerIdx], 0, sizeof(ModelLayerEntry));
+        table[layerIdx].neuronCount = this->network[layerIdx].neuronCount();
+        table[layerIdx].inputCount = this->network[layerIdx].getInputCount();
+        table[layerIdx].weightStride = this->network[layerIdx].getWeightStride();
+        table[layerIdx].activationOffset = offset;
+        offset += table[layerIdx].neuronCount;
+    }
+    for (ModelLayerEntry &entry : table)
+    {
+        offset = alignOffset(offset);
+        entry.weightOffset = offset;
+        offset += (uint64_t)entry.neuronCount * entry.weightStride * sizeof(T);
+    }
+
+    // Written beside the target, then renamed over it: an imported network may
+    // still be mapped from the target, which must not be truncated under it
+    const std::string temporary = path + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cout << "Error: unable to open " << temporary << " for writing" << std::endl;
+        return false;
+    }
+
+    file.write((const char *)&header, sizeof(header));
+    file.write((const char *)table.data(), table.size() * sizeof(ModelLayerEntry));
+    for (NeuralLayerT<T> &layer : this->network)
+    {
+        std::vector<uint8_t> types(layer.neuronCount());
+        for (unsigned int neuronIdx = 0; neuronIdx < layer.neuronCount(); neuronIdx++)
+        {
+            types[neuronIdx] = (uint8_t)layer.getActivationTypes()[neuronIdx];
+        }
+        file.write((const char *)types.data(), types.size());
+    }
+
+    // Pad up to each block, then write the matrix as is
+    const char padding[ADAM_ALIGNMENT] = {};
+    for (size_t layerIdx = 0; layerIdx < this->network.size(); layerIdx++)
+    {
+        file.write(padding, table[layerIdx].weightOffset - (uint64_t)file.tellp());
+        file.write((const char *)this->network[layerIdx].getWeightMatrix(),
+                   (std::streamsize)((uint64_t)table[layerIdx].neuronCount * table[layerIdx].weightStride * sizeof(T)));
+    }
+
+    file.close();
+    if (!file.good())
+    {
+        std::cout << "Error: failed writing " << temporary << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    // Make sure the data is on disk before the rename makes it the model
+    const int descriptor = open(temporary.c_str(), O_RDONLY);
+    if (descriptor >= 0)
+    {
+        fsync(descriptor);
+        close(descriptor);
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        std::cout << "Error: unable to replace " << path << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Import Network
+template<typename T>
+bool NeuralNetworkT<T>::importNetwork(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cout << "Error: unable to open " << path << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (uint64_t)info.st_size < sizeof(ModelHeader))
+    {
+        std::cout << "Error: " << path << " is too small to be a model" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    // Private mapping - pages stay shared with the page cache until written
+    const uint64_t fileSize = (uint64_t)info.st_size;
+    void *base = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        std::cout << "Error: unable to map " << path << std::endl;
+        return false;
+    }
+    std::shared_ptr<void> storage(base, [fileSize](void *mapped) { munmap(mapped, fileSize); });
+    madvise(base, fileSize, MADV_WILLNEED);
+
+    const char *bytes = (const char *)base;
+    const ModelHeader *header = (const ModelHeader *)bytes;
+
+    // Check the header
+    if (std::memcmp(header->magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0 ||
+        header->endianMarker != MODEL_ENDIAN_MARKER)
+    {
+        std::cout << "Error: " << path << " is not a model file (or has foreign byte order)" << std::endl;
+        return false;
+    }
+    if (header->version != MODEL_VERSION)
+    {
+        std::cout << "Error: " << path << " has unsupported model version " << header->version << std::endl;
+        return false;
+    }
+    if (header->scalarSize != sizeof(T))
+    {
+        std::cout << "Error: " << path << " holds " << header->scalarSize * 8
+                  << " bit weights, network expects " << sizeof(T) * 8 << " bit" << std::endl;
+        return false;
+    }
+    if (header->layerCount == 0 ||
+        fileSize < sizeof(ModelHeader) + (uint64_t)header->layerCount * sizeof(ModelLayerEntry))
+    {
+        std::cout << "Error: " << path << " has a malformed layer table" << std::endl;
+        return false;
+    }
+
+    // Check each layer, then view it in place
+    const ModelLayerEntry *table = (const ModelLayerEntry *)(bytes + sizeof(ModelHeader));
+    std::vector<NeuralLayerT<T>> layers;
+    layers.reserve(header->layerCount);
+    unsigned int expectedInputs = header->inputCount;
+    for (uint32_t layerIdx = 0; layerIdx < header->layerCount; layerIdx++)
+    {
+        const ModelLayerEntry &entry = table[layerIdx];
+        const uint64_t weightBytes = (uint64_t)entry.neuronCount * entry.weightStride * sizeof(T);
+        if (entry.neuronCount == 0 || entry.inputCount == 0 || entry.inputCount != expectedInputs ||
+            entry.weightStride < (uint64_t)entry.inputCount + 1 ||
+            entry.activationOffset > fileSize || fileSize - entry.activationOffset < entry.neuronCount ||
+            entry.weightOffset % ADAM_ALIGNMENT != 0 ||
+            entry.weightOffset > fileSize || fileSize - entry.weightOffset < weightBytes)
+        {
+            std::cout << "Error: " << path << " layer " << layerIdx << " is malformed" << std::endl;
+            return false;
+        }
+
+        std::vector<NeuralActivationType> types(entry.neuronCount);
+        for (uint32_t neuronIdx = 0; neuronIdx < entry.neuronCount; neuronIdx++)
+        {
+            uint8_t type = (uint8_t)bytes[entry.activationOffset + neuronIdx];
+            if (type > (uint8_t)NeuralActivationType::HYPERBOLIC_TANGENT)
+            {
+                std::cout << "Error: " << path << " layer " << layerIdx << " has an unknown activation type" << std::endl;
+                return false;
+            }
+            types[neuronIdx] = (NeuralActivationType)type;
+        }
+
+        layers.push_back(NeuralLayerT<T>(entry.inputCount, entry.weightStride, &types,
+                                         (T *)(bytes + entry.weightOffset), storage));
+        if (layerIdx + 1 < header->layerCount)
+        {
+            layers.back().finalize();
+        }
+        expectedInputs = entry.neuronCount;
+    }
+
+    // If we made it here, swap the loaded network in
+    this->network = std::move(layers);
+    this->inputCount = header->inputCount;
+    this->setActivationMode(this->activationMode);
+    this->trainedAccuracy = header->trainedAccuracy;
+    this->trueAccuracy = header->trueAccuracy;
+    this->classifierCounts.clear();
+    this->networkMemory.clear();
+    ADAM_INSTRUMENT(this->instrumentation.shape(this->layerCount()));
+    this->initialized = true;
+    return true;
+}
+
+// Reset Instrumentation
+template<typename T>
+void NeuralNetworkT<T>::resetInstrumentation()
+{
+    this->instrumentation.reset();
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralNetworkT<float>;
+template class NeuralNetworkT<double>;
@@ -2,10 +2,13 @@
 #include "neuralNetworkTrainer.hpp"
 #endif
 
+#include <sstream>
+
 /*********************** CONSTRUCTORS ******************************/
 
 // Constructor with unassigned weights
-NeuralNetworkTrainer::NeuralNetworkTrainer(): NeuralNetwork()
+template<typename T>
+NeuralNetworkTrainerT<T>::NeuralNetworkTrainerT(): NeuralNetworkT<T>()
 {
     // Configure defaults
     this->trainingCycles = this->MAX_TRAINING_CYCLES;
@@ -15,10 +18,22 @@ NeuralNetworkTrainer::NeuralNetworkTrainer(): NeuralNetwork()
     this->learnRate = 0.5f;
     this->currentCycle = 0;
     this->currentConvergenceCount = 0;
+    this->threadCount = 1;
+    this->batchSize = 100;
+    this->trainingMode = NeuralTrainingMode::SYNCHRONOUS;
+    this->samplesPerSecond = 0.0;
+    this->classificationThreshold = 0.5;
+    this->blindLossSamples = 0;
+    this->epochLoss = -1.0;
+    this->blindLoss = -1.0;
+    this->bestLoss = -1.0;
+    this->generator.seed(rand());
+    this->checkpointInterval = 0;
 }
 
 // Constructor with assigned weights
-NeuralNetworkTrainer::NeuralNetworkTrainer(std::vector<NeuralLayer> *network): NeuralNetwork(network)
+template<typename T>
+NeuralNetworkTrainerT<T>::NeuralNetworkTrainerT(std::vector<NeuralLayerT<T>> *network): NeuralNetworkT<T>(network)
 {
     // Configure defaults
     this->trainingCycles = this->MAX_TRAINING_CYCLES;
@@ -28,11 +43,23 @@ NeuralNetworkTrainer::NeuralNetworkTrainer(std::vector<NeuralLayer> *network): N
     this->learnRate = 0.5f;
     this->currentCycle = 0;
     this->currentConvergenceCount = 0;
+    this->threadCount = 1;
+    this->batchSize = 100;
+    this->trainingMode = NeuralTrainingMode::SYNCHRONOUS;
+    this->samplesPerSecond = 0.0;
+    this->classificationThreshold = 0.5;
+    this->blindLossSamples = 0;
+    this->epochLoss = -1.0;
+    this->blindLoss = -1.0;
+    this->bestLoss = -1.0;
+    this->generator.seed(rand());
+    this->checkpointInterval = 0;
 }
 
 /*********************** DESTRUCTORS *******************************/
 
-NeuralNetworkTrainer::~NeuralNetworkTrainer()
+template<typename T>
+NeuralNetworkTrainerT<T>::~NeuralNetworkTrainerT()
 {
     // This object maintains ownership of data, no pointers to clean up
 } 
@@ -40,7 +67,8 @@ NeuralNetworkTrainer::~NeuralNetworkTrainer()
 /*********************** SETTERS ***********************************/
 
 // Set Training Cycles
-void NeuralNetworkTrainer::setTrainingCycles(unsigned int cycles)
+template<typename T>
+void NeuralNetworkTrainerT<T>::setTrainingCycles(unsigned int cycles)
 {
     // If the given cycles exceeds the max -- cap them
     if (cycles > this->MAX_TRAINING_CYCLES)
@@ -55,7 +83,8 @@ void NeuralNetworkTrainer::setTrainingCycles(unsigned int cycles)
 }
 
 // Set Convergence Count
-void NeuralNetworkTrainer::setConvergenceFactors(unsigned int count, double margin)
+template<typename T>
+void NeuralNetworkTrainerT<T>::setConvergenceFactors(unsigned int count, double margin)
 {
     // Check if the inputs are 0
     if (count == 0 || margin == 0)
@@ -83,7 +112,8 @@ void NeuralNetworkTrainer::setConvergenceFactors(unsigned int count, double marg
 }
 
 // Set Dataset Split Ratio
-void NeuralNetworkTrainer::setDataSplitRatio(float ratio)
+template<typename T>
+void NeuralNetworkTrainerT<T>::setDataSplitRatio(float ratio)
 {
     // Check that the ratio is in range
     if (ratio < 0 || ratio > 1)
@@ -97,7 +127,8 @@ void NeuralNetworkTrainer::setDataSplitRatio(float ratio)
 }
 
 // Set Learning Rate
-void NeuralNetworkTrainer::setLearnRate(float rate)
+template<typename T>
+void NeuralNetworkTrainerT<T>::setLearnRate(float rate)
 {
     // Check that the ratio is in range
     if (rate <= 0)
@@ -110,47 +141,232 @@ void NeuralNetworkTrainer::setLearnRate(float rate)
     this->learnRate = rate;
 }
 
+// Set Thread Count
+template<typename T>
+void NeuralNetworkTrainerT<T>::setThreadCount(unsigned int count)
+{
+    // Check that there is at least one worker
+    if (count == 0)
+    {
+        std::cout << "Error: thread count must be at least 1, count not set" << std::endl;
+        return;
+    }
+
+    // Set the count
+    this->threadCount = count;
+}
+
+// Set Batch Size
+template<typename T>
+void NeuralNetworkTrainerT<T>::setBatchSize(unsigned int size)
+{
+    this->batchSize = size;
+}
+
+// Set Training Mode
+template<typename T>
+void NeuralNetworkTrainerT<T>::setTrainingMode(NeuralTrainingMode mode)
+{
+    this->trainingMode = mode;
+}
+
+// Set Optimizer
+template<typename T>
+void NeuralNetworkTrainerT<T>::setOptimizer(NeuralOptimizerType type)
+{
+    this->optimizer.setType(type);
+}
+
+// Set Optimizer Factors
+template<typename T>
+void NeuralNetworkTrainerT<T>::setOptimizerFactors(double beta1, double beta2, double epsilon)
+{
+    this->optimizer.setFactors(beta1, beta2, epsilon);
+}
+
+// Set Classification Threshold
+template<typename T>
+void NeuralNetworkTrainerT<T>::setClassificationThreshold(double threshold)
+{
+    this->classificationThreshold = threshold;
+}
+
+// Set Blind Loss Samples
+template<typename T>
+void NeuralNetworkTrainerT<T>::setBlindLossSamples(unsigned int samples)
+{
+    this->blindLossSamples = samples;
+}
+
+// Set Seed
+template<typename T>
+void NeuralNetworkTrainerT<T>::setSeed(unsigned int seed)
+{
+    this->generator.seed(seed);
+}
+
+// Set Checkpoint
+template<typename T>
+void NeuralNetworkTrainerT<T>::setCheckpoint(const std::string &path, unsigned int interval)
+{
+    this->checkpointPath = path;
+    this->checkpointInterval = path.empty() ? 0 : interval;
+}
+
 /*********************** GETTERS ***********************************/
 
 // Get Training Cycles
-unsigned int NeuralNetworkTrainer::getTrainingCycles()
+template<typename T>
+unsigned int NeuralNetworkTrainerT<T>::getTrainingCycles()
 {
     return this->trainingCycles;
 }
 
 // Get Convergence Count
-unsigned int NeuralNetworkTrainer::getConvergenceCount()
+template<typename T>
+unsigned int NeuralNetworkTrainerT<T>::getConvergenceCount()
 {
     return this->convergenceCount;
 }
 
 // Get Convergence Margin
-double NeuralNetworkTrainer::getConvergenceMargin()
+template<typename T>
+double NeuralNetworkTrainerT<T>::getConvergenceMargin()
 {
     return this->convergenceMargin;
 }
 
 // Get Dataset Split Ratio
-float NeuralNetworkTrainer::getDataSplitRatio()
+template<typename T>
+float NeuralNetworkTrainerT<T>::getDataSplitRatio()
 {
     return this->dataSplitRatio;
 }
 
 // Get Learn Rate
-float NeuralNetworkTrainer::getLearnRate()
+template<typename T>
+float NeuralNetworkTrainerT<T>::getLearnRate()
 {
     return this->learnRate;
 }
 
+// Get Thread Count
+template<typename T>
+unsigned int NeuralNetworkTrainerT<T>::getThreadCount()
+{
+    return this->threadCount;
+}
+
+// Get Batch Size
+template<typename T>
+unsigned int NeuralNetworkTrainerT<T>::getBatchSize()
+{
+    return this->batchSize;
+}
+
+// Get Training Mode
+template<typename T>
+NeuralTrainingMode NeuralNetworkTrainerT<T>::getTrainingMode()
+{
+    return this->trainingMode;
+}
+
+// Get Optimizer
+template<typename T>
+NeuralOptimizerType NeuralNetworkTrainerT<T>::getOptimizer()
+{
+    return this->optimizer.getType();
+}
+
+// Get Classification Threshold
+template<typename T>
+double NeuralNetworkTrainerT<T>::getClassificationThreshold()
+{
+    return this->classificationThreshold;
+}
+
+// Get Blind Loss Samples
+template<typename T>
+unsigned int NeuralNetworkTrainerT<T>::getBlindLossSamples()
+{
+    return this->blindLossSamples;
+}
+
+// Get Checkpoint Path
+template<typename T>
+std::string NeuralNetworkTrainerT<T>::getCheckpointPath()
+{
+    return this->checkpointPath;
+}
+
+// Get Checkpoint Interval
+template<typename T>
+unsigned int NeuralNetworkTrainerT<T>::getCheckpointInterval()
+{
+    return this->checkpointInterval;
+}
+
+// Get Completed Cycles
+template<typename T>
+unsigned int NeuralNetworkTrainerT<T>::getCompletedCycles()
+{
+    return this->currentCycle;
+}
+
+// Get Epoch Loss
+template<typename T>
+double NeuralNetworkTrainerT<T>::getEpochLoss()
+{
+    return this->epochLoss;
+}
+
+// Get Blind Loss
+template<typename T>
+double NeuralNetworkTrainerT<T>::getBlindLoss()
+{
+    return this->blindLoss;
+}
+
+// Get Samples Per Second
+template<typename T>
+double NeuralNetworkTrainerT<T>::getSamplesPerSecond()
+{
+    return this->samplesPerSecond;
+}
+
 // Get Base Network
-NeuralNetwork NeuralNetworkTrainer::getNetwork()
+template<typename T>
+NeuralNetworkT<T> NeuralNetworkTrainerT<T>::getNetwork()
+{
+    return (NeuralNetworkT<T>)(*this);
+}
+
+// Get Fold Results
+template<typename T>
+const std::vector<NeuralFoldResult> & NeuralNetworkTrainerT<T>::getFoldResults() const
+{
+    return this->foldResults;
+}
+
+// Get Cross Validation Accuracy
+template<typename T>
+double NeuralNetworkTrainerT<T>::getCrossValidationAccuracy() const
 {
-    return (NeuralNetwork)(*this);
+    double correct = 0.0;
+    unsigned long rows = 0;
+    for (const NeuralFoldResult &result : this->foldResults)
+    {
+        correct += result.trueAccuracy * result.rows;
+        rows += result.rows;
+    }
+    return (rows > 0) ? correct / rows : -1.0;
 }
 
 /*********************** FUNCTIONAL ********************************/
 
-void NeuralNetworkTrainer::trainTestLoop(std::vector<std::vector<double>> inputs, std::vector<std::vector<double>> truths)
+template<typename T>
+void NeuralNetworkTrainerT<T>::trainTestLoop(const std::vector<std::vector<T>> &inputs,
+                                             const std::vector<std::vector<T>> &truths)
 {
     // Let's make sure the size of the parameters is the same
     if (inputs.size() != truths.size())
@@ -161,228 +377,977 @@ void NeuralNetworkTrainer::trainTestLoop(std::vector<std::vector<double>> inputs
 
     // We grab these here, so we don't have to get this every time in the loop.
     unsigned int networkInputCount = this->getInputCount();
-    unsigned int networkOutputCount = this->network[this->layerCount() -1].neuronCount();
+    unsigned int networkOutputCount = this->getOutputCount();
 
-    // Purge the data of unexpected inputs
-    for(int i = inputs.size() - 1; i >= 0; i--)
+    // One pass over the data: well formed rows go into the row tables, the rest are left out
+    std::vector<const T *> inputRows;
+    std::vector<const T *> truthRows;
+    inputRows.reserve(inputs.size());
+    truthRows.reserve(truths.size());
+    for (size_t i = 0; i < inputs.size(); i++)
     {
-        bool pop = false;
         if (inputs[i].size() != networkInputCount)
         {
             std::cout << "Error: The size of the inputs on index: " << i << " not correct, removing" << std::endl;
-            pop = true;
         }
         else if (truths[i].size() != networkOutputCount)
         {
             std::cout << "Error: The size of the truths (output) on index: " << i << " not correct, removing" << std::endl;
-            pop = true;
         }
-        if (pop)
+        else
         {
-            std::swap(inputs[i], inputs.back());
-            inputs.pop_back();
-            std::swap(truths[i], truths.back());
-            truths.pop_back();
+            inputRows.push_back(inputs[i].data());
+            truthRows.push_back(truths[i].data());
         }
     }
 
+    this->trainTestLoop(NeuralDataViewT<T>(inputRows.data(), (unsigned int)inputRows.size(), networkInputCount),
+                        NeuralDataViewT<T>(truthRows.data(), (unsigned int)truthRows.size(), networkOutputCount));
+}
+
+template<typename T>
+void NeuralNetworkTrainerT<T>::trainTestLoop(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths)
+{
+    // Check that the views match each other and the network
+    if (this->layerCount() == 0 || inputs.getRowCount() != truths.getRowCount())
+    {
+        std::cout << "Error: network has no layers or the input and truth row counts differ" << std::endl;
+        return;
+    }
+    if (inputs.getColumnCount() != this->getInputCount() || truths.getColumnCount() != this->getOutputCount())
+    {
+        std::cout << "Error: view columns do not match the network inputs / outputs" << std::endl;
+        return;
+    }
+
     // We will loop across the dataset for the portion of the data
-    unsigned int trainingSize = std::ceil(inputs.size()*this->dataSplitRatio);
+    this->trainTest(inputs, truths, std::ceil(inputs.getRowCount()*this->dataSplitRatio));
+}
+
+template<typename T>
+bool NeuralNetworkTrainerT<T>::resumeTestLoop(const std::string &path, const NeuralDataViewT<T> &inputs,
+                                              const NeuralDataViewT<T> &truths)
+{
+    // Check that the views match each other and the network
+    if (this->layerCount() == 0 || inputs.getRowCount() != truths.getRowCount())
+    {
+        std::cout << "Error: network has no layers or the input and truth row counts differ" << std::endl;
+        return false;
+    }
+    if (inputs.getColumnCount() != this->getInputCount() || truths.getColumnCount() != this->getOutputCount())
+    {
+        std::cout << "Error: view columns do not match the network inputs / outputs" << std::endl;
+        return false;
+    }
+
+    NeuralSnapshotT<T> snapshot;
+    if (!NeuralCheckpointT<T>::read(path, &snapshot))
+    {
+        return false;
+    }
+
+    // Check the checkpoint was taken of this network
+    std::vector<unsigned int> shape;
+    size_t weightCount = 0;
+    for (NeuralLayerT<T> &layer : this->network)
+    {
+        shape.push_back(layer.neuronCount());
+        shape.push_back(layer.getInputCount());
+        shape.push_back(layer.getWeightStride());
+        weightCount += (size_t)layer.neuronCount() * layer.getWeightStride();
+    }
+    if (shape != snapshot.shape || weightCount != snapshot.weights.size())
+    {
+        std::cout << "Error: checkpoint does not match the network topology" << std::endl;
+        return false;
+    }
+
+    // ... with this optimizer
+    this->optimizer.shape(&this->network);
+    if (snapshot.optimizerType != (unsigned int)this->optimizer.getType() ||
+        snapshot.optimizerState.size() != this->optimizer.getStateSize())
+    {
+        std::cout << "Error: checkpoint was taken with a different optimizer" << std::endl;
+        return false;
+    }
+
+    // ... over this data and split
+    const unsigned int rowCount = inputs.getRowCount();
+    const unsigned int trainingSize = std::ceil(rowCount*this->dataSplitRatio);
+    const bool rowsMatch = snapshot.rowCount == rowCount && snapshot.indexes.size() == trainingSize &&
+        std::all_of(snapshot.indexes.begin(), snapshot.indexes.end(),
+                    [trainingSize](int row) { return row >= 0 && (unsigned int)row < trainingSize; }) &&
+        std::all_of(snapshot.blindIndexes.begin(), snapshot.blindIndexes.end(),
+                    [trainingSize, rowCount](unsigned int row) { return row >= trainingSize && row < rowCount; });
+    if (!rowsMatch)
+    {
+        std::cout << "Error: checkpoint was taken over different data or a different split" << std::endl;
+        return false;
+    }
+
+    return this->trainTest(inputs, truths, trainingSize, &snapshot);
+}
+
+template<typename T>
+bool NeuralNetworkTrainerT<T>::trainTest(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths,
+                                         unsigned int trainingSize, const NeuralSnapshotT<T> *resume)
+{
+    const unsigned int rowCount = inputs.getRowCount();
 
     // Create a shuffled index 
     std::vector<int> indexes;
-    indexes.reserve(trainingSize - 1);
+    indexes.reserve(trainingSize);
     for (unsigned int i = 0; i < trainingSize; ++i)
     {
         indexes.push_back(i);
     }
 
+    // The worker state is sized once for the run, the optimizer starts from zero state
+    this->shapeWorkspaces();
+    this->shapeOptimizer();
+    NeuralWorkerPool pool(this->threadCount);
+    NeuralCheckpointT<T> checkpoint((this->checkpointInterval > 0) ? this->checkpointPath : std::string());
+
+    // A random sample of the blind data, drawn once so every cycle is measured alike
+    const unsigned int blindSize = rowCount - trainingSize;
+    const unsigned int blindDrawn = std::min(this->blindLossSamples, blindSize);
+    std::vector<unsigned int> blindIndexes;
+    blindIndexes.reserve(blindSize);
+    for (unsigned int i = trainingSize; i < rowCount; ++i)
+    {
+        blindIndexes.push_back(i);
+    }
+
+    // Partial Fisher-Yates, so no blind row is sampled twice
+    for (unsigned int drawIdx = 0; drawIdx < blindDrawn; drawIdx++)
+    {
+        std::uniform_int_distribution<unsigned int> blindDraw(drawIdx, blindSize - 1);
+        std::swap(blindIndexes[drawIdx], blindIndexes[blindDraw(this->generator)]);
+    }
+    blindIndexes.resize(blindDrawn);
+
+    // Convergence is judged on the blind loss when it is sampled, the epoch loss otherwise
+    this->resetConvergence();
+    bool converged = false;
+    unsigned int startCycle = 0;
+
+    // A resumed run takes all of its state from the checkpoint instead
+    if (resume)
+    {
+        if (!this->restoreSnapshot(*resume))
+        {
+            return false;
+        }
+        indexes = resume->indexes;
+        blindIndexes = resume->blindIndexes;
+        startCycle = resume->cycle;
+
+        // A checkpoint of the converging cycle ends the run there, as the uninterrupted run did
+        converged = this->convergenceCount > 0 && this->currentConvergenceCount >= this->convergenceCount;
+    }
+
+    const unsigned int blindSamples = (unsigned int)blindIndexes.size();
+    std::vector<const T *> blindInputRows(blindSamples);
+    std::vector<const T *> blindTruthRows(blindSamples);
+    for (unsigned int sampleIdx = 0; sampleIdx < blindSamples; sampleIdx++)
+    {
+        blindInputRows[sampleIdx] = inputs.row(blindIndexes[sampleIdx]);
+        blindTruthRows[sampleIdx] = truths.row(blindIndexes[sampleIdx]);
+    }
+    const NeuralDataViewT<T> blindInputs(blindInputRows.data(), blindSamples, inputs.getColumnCount());
+    const NeuralDataViewT<T> blindTruths(blindTruthRows.data(), blindSamples, truths.getColumnCount());
+
+    std::chrono::steady_clock::time_point trainingStart = std::chrono::steady_clock::now();
+
     // Loop across each training cycle
-    for(this->currentCycle = 0; this->currentCycle < this->trainingCycles; this->currentCycle++)
+    for(this->currentCycle = startCycle; this->currentCycle < this->trainingCycles && !converged; this->currentCycle++)
     {
         // Shuffle the index
-        std::random_shuffle(indexes.begin(), indexes.end());
+        std::shuffle(indexes.begin(), indexes.end(), this->generator);
 
-        // Set up the data index
-        unsigned int dataIdx = 0;
-        unsigned int averageCount = 0;
+        // The epoch loss comes for free from the costs summed while training
+        double loopCost = this->trainIndexes(inputs, truths, indexes.data(), trainingSize, &pool);
+        this->epochLoss = (trainingSize > 0) ? loopCost / trainingSize / 2 : 0.0;
 
-        // best neural change is the sum of the cost gradients over a large set
-        std::map<std::string, double> cost_gradient;
+        if (blindSamples > 0)
+        {
+            this->blindLoss = this->rowsCost(blindInputs, blindTruths) / blindSamples / 2;
+        }
 
-        double loopCost = 0.0;
+        converged = this->checkConvergence((blindSamples > 0) ? this->blindLoss : this->epochLoss);
 
-        // Loop over the first N*splitRatio dataPoints
-        for (;dataIdx < trainingSize; dataIdx++)
+        // Copy the state aside for the checkpoint writer, which takes it from here
+        if (checkpoint.isEnabled() && (this->currentCycle + 1) % this->checkpointInterval == 0)
         {
-            int localIdx = indexes[dataIdx];
-            
-            // Place the network call (outputs are stored in memory)
-            this->recall(&(inputs[localIdx]));
+            this->captureSnapshot(checkpoint.acquire(), indexes, blindIndexes, rowCount, this->currentCycle + 1);
+            checkpoint.publish();
+        }
+    }
 
-            // Update the cost value for sample
-            for (unsigned int i = 0; i < (unsigned int)truths[0].size(); i++)
-            {
-                double diff = this->network[this->layerCount() - 1].getNeuron(i)->getNeuronMemory() - truths[localIdx][i];
-                loopCost += diff*diff;
-            }
+    // Record the achieved throughput
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - trainingStart;
+    if (elapsed.count() > 0.0)
+    {
+        this->samplesPerSecond = (double)trainingSize * (this->currentCycle - startCycle) / elapsed.count();
+    }
 
-            std::map<std::string, double> return_cost_gradient = this->backPropigation(&(inputs[localIdx]), &(truths[localIdx]));
+    // Score the network on the data it was trained on, and on the blind remainder
+    std::array<unsigned long, 4> trainingCounts{};
+    std::array<unsigned long, 4> blindCounts{};
+    this->classifyRows(inputs.slice(0, trainingSize), truths.slice(0, trainingSize), &pool, &trainingCounts);
+    this->classifyRows(inputs.slice(trainingSize, blindSize), truths.slice(trainingSize, blindSize), &pool, &blindCounts);
+    this->recordEvaluation(DatasetType::TRAINING, trainingCounts);
+    this->recordEvaluation(DatasetType::TRUE, blindCounts);
+    return true;
+}
 
-            // If the cost_gradient is empty, just copy
-            if (cost_gradient.size() == 0)
-            {
-                cost_gradient = return_cost_gradient;
-            }
-            // Else sum the two vectors
-            else
+template<typename T>
+void NeuralNetworkTrainerT<T>::trainTestStream(NeuralDataStreamT<T> *stream)
+{
+    // Check that the stream matches the network
+    if (!stream || this->layerCount() == 0)
+    {
+        std::cout << "Error: network has no layers or stream pointer null" << std::endl;
+        return;
+    }
+    if (stream->getInputCount() != this->getInputCount() || stream->getTruthCount() != this->getOutputCount())
+    {
+        std::cout << "Error: stream columns do not match the network inputs / outputs" << std::endl;
+        return;
+    }
+
+    // Nothing of a previous run is left to be mistaken for this one's, should the stream fail
+    this->trainedAccuracy = -1.0;
+    this->trueAccuracy = -1.0;
+    this->classifierCounts.erase(DatasetType::TRAINING);
+    this->classifierCounts.erase(DatasetType::TRUE);
+    this->samplesPerSecond = 0.0;
+
+    // The worker state is sized once for the run, the optimizer starts from zero state
+    this->shapeWorkspaces();
+    this->shapeOptimizer();
+    NeuralWorkerPool pool(this->threadCount);
+
+    // Views and shuffled index of the block in hand
+    NeuralDataBlockT<T> block;
+    block.rows = 0;
+    NeuralDataViewT<T> inputs;
+    NeuralDataViewT<T> truths;
+    std::vector<int> indexes;
+    indexes.reserve(NeuralDataStreamT<T>::BLOCK_ROWS);
+
+    // Each block is split like a whole dataset: the leading rows train, the rest are blind
+    unsigned int trainingRows = 0;
+    unsigned int blindRows = 0;
+    const std::function<void()> mapBlock = [&]()
+    {
+        inputs = NeuralDataViewT<T>(block.inputs.data(), block.rows, stream->getInputCount());
+        truths = NeuralDataViewT<T>(block.truths.data(), block.rows, stream->getTruthCount());
+        trainingRows = std::ceil(block.rows*this->dataSplitRatio);
+        blindRows = block.rows - trainingRows;
+    };
+
+    // Convergence is judged on the blind loss when it is sampled, the epoch loss otherwise
+    this->resetConvergence();
+    bool converged = false;
+    unsigned long trainedRows = 0;
+
+    std::chrono::steady_clock::time_point trainingStart = std::chrono::steady_clock::now();
+
+    // Each training cycle is one pass over the stream
+    for(this->currentCycle = 0; this->currentCycle < this->trainingCycles && !converged; this->currentCycle++)
+    {
+        if (!stream->rewind())
+        {
+            std::cout << "Error: unable to rewind the stream, training stopped at cycle " << this->currentCycle << std::endl;
+            return;
+        }
+
+        double loopCost = 0.0;
+        unsigned long cycleRows = 0;
+        double blindCost = 0.0;
+        unsigned int blindSampled = 0;
+        while (stream->nextBlock(&block))
+        {
+            mapBlock();
+
+            // Shuffled within the block
+            indexes.resize(trainingRows);
+            for (unsigned int i = 0; i < trainingRows; ++i)
             {
-                std::map<std::string, double>::iterator i = cost_gradient.begin();
-                for (; i != cost_gradient.cend(); i++)
-                {
-                    i->second += return_cost_gradient[i->first];
-                }
+                indexes[i] = i;
             }
-            averageCount++;
+            std::shuffle(indexes.begin(), indexes.end(), this->generator);
+            loopCost += this->trainIndexes(inputs, truths, indexes.data(), trainingRows, &pool);
+            cycleRows += trainingRows;
 
-            // Every 100 data samples or final sample, adjust weights
-            if (averageCount == 100 || dataIdx == trainingSize -1)
+            // The blind sample is the first blind rows of the pass, the same rows every cycle
+            const unsigned int blindTake = std::min(blindRows, this->blindLossSamples - blindSampled);
+            if (blindTake > 0)
             {
-                updateNetworkWeights(cost_gradient, averageCount);
-                //std::cout << loopCost / averageCount / 2 << std::endl;
-                cost_gradient = std::map<std::string,double>();
-                averageCount=0;
+                blindCost += this->rowsCost(inputs.slice(trainingRows, blindTake), truths.slice(trainingRows, blindTake));
+                blindSampled += blindTake;
             }
         }
-        
-        //std::cout << "----------------------------------" << std::endl;
+
+        this->epochLoss = (cycleRows > 0) ? loopCost / cycleRows / 2 : 0.0;
+        if (blindSampled > 0)
+        {
+            this->blindLoss = blindCost / blindSampled / 2;
+        }
+        trainedRows += cycleRows;
+
+        converged = this->checkConvergence((blindSampled > 0) ? this->blindLoss : this->epochLoss);
+    }
+
+    // Record the achieved throughput (parsing included)
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - trainingStart;
+    if (elapsed.count() > 0.0)
+    {
+        this->samplesPerSecond = (double)trainedRows / elapsed.count();
+    }
+
+    // Score the network with one more pass
+    if (!stream->rewind())
+    {
+        std::cout << "Error: unable to rewind the stream, the network was not evaluated" << std::endl;
+        return;
+    }
+    std::array<unsigned long, 4> trainingCounts{};
+    std::array<unsigned long, 4> blindCounts{};
+    while (stream->nextBlock(&block))
+    {
+        mapBlock();
+        this->classifyRows(inputs.slice(0, trainingRows), truths.slice(0, trainingRows), &pool, &trainingCounts);
+        this->classifyRows(inputs.slice(trainingRows, blindRows), truths.slice(trainingRows, blindRows),
+                           &pool, &blindCounts);
     }
+    this->recordEvaluation(DatasetType::TRAINING, trainingCounts);
+    this->recordEvaluation(DatasetType::TRUE, blindCounts);
 }
 
-void NeuralNetworkTrainer::updateNetworkWeights(std::map<std::string, double> weight_change, int count)
+// Cross Validate
+template<typename T>
+void NeuralNetworkTrainerT<T>::crossValidate(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths,
+                                             unsigned int folds)
 {
-    // Loop through the network and update the weights
-    int layerIdx = 0;
-    for (NeuralLayer &layer : this->network)
+    // Check that the views match each other and the network
+    if (this->layerCount() == 0 || inputs.getRowCount() != truths.getRowCount())
+    {
+        std::cout << "Error: network has no layers or the input and truth row counts differ" << std::endl;
+        return;
+    }
+    if (inputs.getColumnCount() != this->getInputCount() || truths.getColumnCount() != this->getOutputCount())
+    {
+        std::cout << "Error: view columns do not match the network inputs / outputs" << std::endl;
+        return;
+    }
+    const unsigned int rowCount = inputs.getRowCount();
+    if (folds < 2 || folds > rowCount)
+    {
+        std::cout << "Error: fold count must be between 2 and the row count" << std::endl;
+        return;
+    }
+
+    // Shuffle the rows once, fold f is the shuffled rows [bounds[f], bounds[f + 1])
+    std::vector<unsigned int> shuffled(rowCount);
+    for (unsigned int i = 0; i < rowCount; i++)
+    {
+        shuffled[i] = i;
+    }
+    std::shuffle(shuffled.begin(), shuffled.end(), this->generator);
+    std::vector<unsigned int> bounds(folds + 1);
+    for (unsigned int fold = 0; fold <= folds; fold++)
     {
-        for (unsigned int neuronIdx = 0; neuronIdx < layer.neuronCount(); neuronIdx++)
+        bounds[fold] = (unsigned int)((unsigned long)rowCount * fold / folds);
+    }
+
+    // The shuffled rows twice over: the rowCount rows from bounds[f + 1] are the
+    // other folds' rows followed by fold f's, held out last
+    std::vector<const T *> inputRows((size_t)2 * rowCount);
+    std::vector<const T *> truthRows((size_t)2 * rowCount);
+    for (size_t i = 0; i < inputRows.size(); i++)
+    {
+        inputRows[i] = inputs.row(shuffled[i % rowCount]);
+        truthRows[i] = truths.row(shuffled[i % rowCount]);
+    }
+
+    // One model per fold, copies of this network's shape and settings, each group taking every
+    // groups-th fold on its share of the threads (the leftover threads go to the first groups)
+    const unsigned int groups = std::min(folds, this->threadCount);
+    std::vector<NeuralNetworkTrainerT<T>> models(folds, *this);
+    for (unsigned int fold = 0; fold < folds; fold++)
+    {
+        const unsigned int group = fold % groups;
+
+        // Fresh weights, drawn as a new layer draws them, so no fold starts from what this network has learned
+        for (unsigned int layerIdx = 0; layerIdx < models[fold].layerCount(); layerIdx++)
         {
-            Neuron *neuron = layer.getNeuron(neuronIdx);
-            std::vector<double> newWeights = neuron->getWeights();
-
-            // This string stream used to fetch map keys
-            std::stringstream key;
-
-            // Set the new bias weight first
-            key << "bias_" << layerIdx << "_" << neuronIdx;
-            //std::cout << "bias: " << newWeights[0] << "   " << weight_change.find(key.str())->second << "   ";
-            newWeights[0] -= this->learnRate * weight_change[key.str()] / count;
-            //std::cout << newWeights[0] << std::endl;
-            // Loop though each oh the weights and calculate the weight gradients
-            for (int i = 1; i < (int)neuron->getWeights().size(); i++)
+            NeuralLayerT<T> *layer = models[fold].getLayer(layerIdx);
+            for (unsigned int neuronIdx = 0; neuronIdx < layer->neuronCount(); neuronIdx++)
             {
-                key.str("");
-                key << "weight_" << layerIdx << "_" << neuronIdx << "_" << i-1;
-                //std::cout << key.str() << ": " << newWeights[i] << "   " << weight_change.find(key.str())->second << "   ";
-                newWeights[i] -= this->learnRate * weight_change[key.str()] / count;
-                //std::cout << newWeights[i] << std::endl;
+                T *row = layer->getWeightMatrix() + (size_t)neuronIdx * layer->getWeightStride();
+                for (unsigned int weightIdx = 0; weightIdx <= layer->getInputCount(); weightIdx++)
+                {
+                    row[weightIdx] = .6*(double)rand() / RAND_MAX - 0.3;
+                }
             }
+        }
+
+        // The held out fold is only scored, it never steers convergence
+        models[fold].setBlindLossSamples(0);
+        models[fold].setCheckpoint(std::string(), 0);
+        models[fold].setThreadCount(this->threadCount / groups + ((group < this->threadCount % groups) ? 1 : 0));
+        models[fold].setSeed(this->generator());
+    }
+
+    // The folds cost the same, so a fixed deal balances them and keeps each fold's threads repeatable
+    this->foldResults.assign(folds, NeuralFoldResult{});
+    auto work = [&](unsigned int group)
+    {
+        for (unsigned int fold = group; fold < folds; fold += groups)
+        {
+            const size_t at = bounds[fold + 1];
+            const NeuralDataViewT<T> foldInputs(inputRows.data() + at, rowCount, inputs.getColumnCount());
+            const NeuralDataViewT<T> foldTruths(truthRows.data() + at, rowCount, truths.getColumnCount());
+            const unsigned int heldOut = bounds[fold + 1] - bounds[fold];
+            const unsigned int trainingSize = rowCount - heldOut;
+
+            NeuralNetworkTrainerT<T> &model = models[fold];
+            model.trainTest(foldInputs, foldTruths, trainingSize);
+
+            NeuralFoldResult &result = this->foldResults[fold];
+            result.rows = heldOut;
+            result.cycles = model.getCompletedCycles();
+            result.trainedAccuracy = model.getTrainedAccuracy();
+            result.trueAccuracy = model.getTrueAccuracy();
+            result.loss = model.rowsCost(foldInputs.slice(trainingSize, heldOut),
+                                         foldTruths.slice(trainingSize, heldOut)) / heldOut / 2;
+        }
+    };
+    NeuralWorkerPool pool(groups);
+    pool.run(std::ref(work));
+}
+
+// Evaluate Dataset
+template<typename T>
+void NeuralNetworkTrainerT<T>::evaluate(const std::vector<std::vector<T>> &inputs,
+                                        const std::vector<std::vector<T>> &truths, DatasetType dataset)
+{
+    // Let's make sure the size of the parameters is the same
+    if (inputs.size() != truths.size())
+    {
+        std::cout << "Error: The size of the inputs does not match size of the truth values" << std::endl;
+        return;
+    }
 
-            // Set the neuron weights
-            neuron->setWeights(&newWeights);
-            newWeights = neuron->getWeights();
+    unsigned int networkInputCount = this->getInputCount();
+    unsigned int networkOutputCount = this->getOutputCount();
+
+    // Samples of the wrong size are reported and left out of the row tables
+    std::vector<const T *> inputRows;
+    std::vector<const T *> truthRows;
+    inputRows.reserve(inputs.size());
+    truthRows.reserve(truths.size());
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        if (inputs[i].size() != networkInputCount)
+        {
+            std::cout << "Error: The size of the inputs on index: " << i << " not correct, removing" << std::endl;
+        }
+        else if (truths[i].size() != networkOutputCount)
+        {
+            std::cout << "Error: The size of the truths (output) on index: " << i << " not correct, removing" << std::endl;
+        }
+        else
+        {
+            inputRows.push_back(inputs[i].data());
+            truthRows.push_back(truths[i].data());
         }
-        layerIdx++;
     }
-    
+
+    this->evaluate(NeuralDataViewT<T>(inputRows.data(), (unsigned int)inputRows.size(), networkInputCount),
+                   NeuralDataViewT<T>(truthRows.data(), (unsigned int)truthRows.size(), networkOutputCount),
+                   dataset);
 }
 
-std::map<std::string, double> NeuralNetworkTrainer::backPropigation(std::vector<double> * inputs, std::vector<double> * truths)
+// Evaluate Dataset (data view)
+template<typename T>
+void NeuralNetworkTrainerT<T>::evaluate(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths,
+                                        DatasetType dataset)
 {
-    // This is this run's cost gradient
-    std::map<std::string, double> cost_gradient;
+    // Check that the views match each other and the network
+    if (this->layerCount() == 0 || inputs.getRowCount() != truths.getRowCount())
+    {
+        std::cout << "Error: network has no layers or the input and truth row counts differ" << std::endl;
+        return;
+    }
+    if (inputs.getColumnCount() != this->getInputCount() || truths.getColumnCount() != this->getOutputCount())
+    {
+        std::cout << "Error: view columns do not match the network inputs / outputs" << std::endl;
+        return;
+    }
 
-    // We start at the outter most layer and calculate backwards
-    for (std::vector<NeuralLayer>::reverse_iterator layerIter = this->network.rbegin(); 
-         layerIter != this->network.rend(); ++layerIter )
+    // Evaluation may come before (or without) any training run
+    this->shapeWorkspaces();
+    NeuralWorkerPool pool(this->threadCount);
+    std::array<unsigned long, 4> counts{};
+    this->classifyRows(inputs, truths, &pool, &counts);
+    this->recordEvaluation(dataset, counts);
+}
+
+template<typename T>
+double NeuralNetworkTrainerT<T>::trainIndexes(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths,
+                                              const int *indexes, unsigned int count, NeuralWorkerPool *pool)
+{
+    for (Workspace &workspace : this->workspaces)
     {
-        // We use this for creating maps
-        int layerIdx = this->network.rend() - layerIter - 1;
+        workspace.cost = 0.0;
+    }
 
-        // We setup the inputs that feed the layer we're working on
-        std::vector<double> layerInputs;
-        if (layerIdx == 0)
+    // Bounds of the mini-batch currently being worked
+    unsigned int batchStart = 0;
+    unsigned int batchEnd = 0;
+
+    // Each worker takes a contiguous share of the shuffled mini-batch
+    auto trainShare = [&](unsigned int workerIdx)
+    {
+        const unsigned long batchLength = batchEnd - batchStart;
+        const unsigned int shareStart = batchStart + batchLength * workerIdx / this->threadCount;
+        const unsigned int shareEnd = batchStart + batchLength * (workerIdx + 1) / this->threadCount;
+        for (unsigned int dataIdx = shareStart; dataIdx < shareEnd; dataIdx++)
         {
-            // First layer the inputs are the feed
-            layerInputs = *inputs;
+            int localIdx = indexes[dataIdx];
+            this->trainSample(inputs.row(localIdx), truths.row(localIdx), &this->workspaces[workerIdx]);
         }
-        else
+    };
+
+    // Asynchronously, workers claim chunks of the shuffled index until it runs out
+    std::atomic<unsigned int> nextSample(0);
+    auto trainAsync = [&](unsigned int workerIdx)
+    {
+        Workspace &workspace = this->workspaces[workerIdx];
+        unsigned int chunkStart;
+        while ((chunkStart = nextSample.fetch_add(ASYNC_CHUNK, std::memory_order_relaxed)) < count)
         {
-            // Any other layer, the inputs are the previous layer's activation
-            layerInputs = this->network[layerIdx -1].getLayerMemory();
+            const unsigned int chunkEnd = std::min(chunkStart + ASYNC_CHUNK, count);
+            for (unsigned int dataIdx = chunkStart; dataIdx < chunkEnd; dataIdx++)
+            {
+                int localIdx = indexes[dataIdx];
+                this->trainSample(inputs.row(localIdx), truths.row(localIdx), &workspace);
+                this->applyNetworkWeightsAsync(&workspace.gradient, 1);
+            }
         }
+    };
 
-        for (unsigned int neuronIdx = 0; neuronIdx < layerIter->neuronCount(); neuronIdx++ )
+    // No barriers within the cycle, workers only meet again for the next shuffle
+    // (the tasks are handed over by reference, wrapping the captures would allocate)
+    if (this->trainingMode == NeuralTrainingMode::ASYNCHRONOUS)
+    {
+        pool->run(std::ref(trainAsync));
+    }
+    else
+    {
+        // Loop over the samples, one weight adjustment per mini-batch (0 - the whole set)
+        const unsigned int miniBatch = (this->batchSize == 0) ? count : this->batchSize;
+        for (batchStart = 0; batchStart < count; batchStart = batchEnd)
         {
-            // This string stream used to calculate map keys
-            std::stringstream key;
+            batchEnd = std::min(batchStart + miniBatch, count);
 
-            Neuron neuron = *layerIter->getNeuron(neuronIdx);
-            double d_activation = 0.0;
+            // best neural change is the sum of the cost gradients over a large set
+            pool->run(std::ref(trainShare));
 
-            // The activation is different for the output (last) layer.
-            if (layerIter == this->network.rbegin())
+            // Reduce the worker gradients into the first, then adjust weights
+            NeuralGradientT<T> &costGradient = this->workspaces[0].gradient;
+            for (unsigned int workerIdx = 1; workerIdx < this->threadCount; workerIdx++)
             {
-                //dC_N/da_L; Cost function = 1/2*(a - y)^2
-                d_activation = neuron.getNeuronMemory() - (*truths)[neuronIdx];
+                costGradient.accumulate(this->workspaces[workerIdx].gradient);
+                this->workspaces[workerIdx].gradient.reset();
             }
-            else
+            updateNetworkWeights(&costGradient, batchEnd - batchStart);
+            costGradient.reset();
+        }
+    }
+
+    double loopCost = 0.0;
+    for (Workspace &workspace : this->workspaces)
+    {
+        loopCost += workspace.cost;
+    }
+    return loopCost;
+}
+
+template<typename T>
+double NeuralNetworkTrainerT<T>::rowsCost(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths)
+{
+    // Run between cycles on the calling thread, with the first worker's scratch
+    const unsigned int networkOutputCount = this->getOutputCount();
+    const unsigned int count = inputs.getRowCount();
+    Workspace &workspace = this->workspaces[0];
+    T *batchOutputs = workspace.outputs.data();
+
+    double cost = 0.0;
+    for (unsigned int chunkStart = 0; chunkStart < count; chunkStart += EVALUATION_CHUNK)
+    {
+        const unsigned int chunkSize = std::min(chunkStart + EVALUATION_CHUNK, count) - chunkStart;
+        this->recallBatch(inputs.slice(chunkStart, chunkSize), batchOutputs, &workspace.context);
+
+        for (unsigned int sampleIdx = 0; sampleIdx < chunkSize; sampleIdx++)
+        {
+            const T *outputs = batchOutputs + (size_t)sampleIdx * networkOutputCount;
+            const T *expected = truths.row(chunkStart + sampleIdx);
+            for (unsigned int i = 0; i < networkOutputCount; i++)
             {
-                // The new cr_activation is the sum of the activation impacts on the next layer
-                NeuralLayer previousLayer = this->network[layerIdx + 1];
-                for (unsigned int i = 0; i < previousLayer.neuronCount(); i++)
-                {
-                    // Get the neruon that the activation its in the next layer this is dz^n/da^(n-1)
-                    double activationWeight = previousLayer.getNeuron(i)->getWeights()[neuronIdx+1];
+                double diff = (double)outputs[i] - (double)expected[i];
+                cost += diff*diff;
+            }
+        }
+    }
+    return cost;
+}
+
+template<typename T>
+void NeuralNetworkTrainerT<T>::resetConvergence()
+{
+    this->epochLoss = -1.0;
+    this->blindLoss = -1.0;
+    this->bestLoss = -1.0;
+    this->currentConvergenceCount = 0;
+}
+
+template<typename T>
+bool NeuralNetworkTrainerT<T>::checkConvergence(double loss)
+{
+    if (this->convergenceCount == 0)
+    {
+        return false;
+    }
+
+    // Count consecutive cycles that fail to improve on the best loss by more than the margin
+    if (this->bestLoss >= 0.0 && this->bestLoss - loss < this->convergenceMargin)
+    {
+        this->currentConvergenceCount++;
+    }
+    else
+    {
+        this->currentConvergenceCount = 0;
+    }
+    this->bestLoss = (this->bestLoss < 0.0) ? loss : std::min(this->bestLoss, loss);
+    return this->currentConvergenceCount >= this->convergenceCount;
+}
+
+template<typename T>
+void NeuralNetworkTrainerT<T>::classifyRows(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths,
+                                            NeuralWorkerPool *pool, std::array<unsigned long, 4> *counts)
+{
+    const unsigned int networkOutputCount = this->getOutputCount();
+    const unsigned int count = inputs.getRowCount();
+    const unsigned int workerCount = pool->size();
+    const T threshold = (T)this->classificationThreshold;
+
+    // One row of counts per worker, indexed by BinaryClassifierType, merged at the end
+    std::vector<std::array<unsigned long, 4>> workerCounts(workerCount, std::array<unsigned long, 4>{});
+
+    // Each worker recalls its share with the scratch of its own workspace
+    auto evaluateShare = [&](unsigned int workerIdx)
+    {
+        const unsigned int shareStart = (unsigned int)((unsigned long)count * workerIdx / workerCount);
+        const unsigned int shareEnd = (unsigned int)((unsigned long)count * (workerIdx + 1) / workerCount);
+        Workspace &workspace = this->workspaces[workerIdx];
+        T *batchOutputs = workspace.outputs.data();
+        std::array<unsigned long, 4> localCounts{};
+
+        for (unsigned int chunkStart = shareStart; chunkStart < shareEnd; chunkStart += EVALUATION_CHUNK)
+        {
+            const unsigned int chunkSize = std::min(chunkStart + EVALUATION_CHUNK, shareEnd) - chunkStart;
+            this->recallBatch(inputs.slice(chunkStart, chunkSize), batchOutputs, &workspace.context);
 
-                    // Times the previous bias (dC_dZ) terms
-                    key.str("");
-                    key << "bias_" << layerIdx+1 << "_" << i;
-                    d_activation += activationWeight * cost_gradient[key.str()];
+            // Each output is a binary classification
+            for (unsigned int sampleIdx = 0; sampleIdx < chunkSize; sampleIdx++)
+            {
+                const T *outputs = batchOutputs + (size_t)sampleIdx * networkOutputCount;
+                const T *expected = truths.row(chunkStart + sampleIdx);
+                for (unsigned int i = 0; i < networkOutputCount; i++)
+                {
+                    const bool predicted = outputs[i] >= threshold;
+                    const bool actual = expected[i] >= threshold;
+                    BinaryClassifierType outcome = predicted ? (actual ? BinaryClassifierType::TRUE_POSITIVE
+                                                                       : BinaryClassifierType::FALSE_POSITIVE)
+                                                             : (actual ? BinaryClassifierType::FALSE_NEGATIVE
+                                                                       : BinaryClassifierType::TRUE_NEGATIVE);
+                    localCounts[(int)outcome]++;
                 }
             }
-            // std::cout << "d_activation: " << d_activation << std::endl;
+        }
+        workerCounts[workerIdx] = localCounts;
+    };
+    pool->run(std::ref(evaluateShare));
 
-            // We leverage the fact that the cr_summation == cr_bias
-            key.str("");
-            key << "bias_" << layerIdx << "_" << neuronIdx;
-            double d_bias = d_activation_fun(neuron)*d_activation;
-            cost_gradient.insert({key.str(), d_bias});
+    for (const std::array<unsigned long, 4> &localCounts : workerCounts)
+    {
+        for (unsigned int i = 0; i < 4; i++)
+        {
+            (*counts)[i] += localCounts[i];
+        }
+    }
+}
+
+template<typename T>
+void NeuralNetworkTrainerT<T>::recordEvaluation(DatasetType dataset, const std::array<unsigned long, 4> &counts)
+{
+    std::map<BinaryClassifierType, unsigned long> &datasetCounts = this->classifierCounts[dataset];
+    const BinaryClassifierType outcomes[] = {BinaryClassifierType::FALSE_POSITIVE, BinaryClassifierType::FALSE_NEGATIVE,
+                                             BinaryClassifierType::TRUE_POSITIVE, BinaryClassifierType::TRUE_NEGATIVE};
+    unsigned long total = 0;
+    for (BinaryClassifierType outcome : outcomes)
+    {
+        datasetCounts[outcome] = counts[(int)outcome];
+        total += counts[(int)outcome];
+    }
+
+    // Nothing evaluated (EX: a split ratio of 1.0 leaves no blind data) leaves the accuracy unset
+    double accuracy = -1.0;
+    if (total > 0)
+    {
+        accuracy = (double)(datasetCounts[BinaryClassifierType::TRUE_POSITIVE] +
+                            datasetCounts[BinaryClassifierType::TRUE_NEGATIVE]) / total;
+    }
+
+    if (dataset == DatasetType::TRAINING)
+    {
+        this->trainedAccuracy = accuracy;
+    }
+    else
+    {
+        this->trueAccuracy = accuracy;
+    }
+}
+
+template<typename T>
+void NeuralNetworkTrainerT<T>::updateNetworkWeights(NeuralGradientT<T> *gradient, int count)
+{
+    if (!this->optimizer.beginStep(&this->network, gradient))
+    {
+        return;
+    }
+
+    // Loop through the network and update the weights (bias column included)
+    for (unsigned int layerIdx = 0; layerIdx < this->layerCount(); layerIdx++)
+    {
+        ADAM_INSTRUMENT(const uint64_t start = NeuralInstrumentation::now());
+        this->optimizer.updateLayer(layerIdx, this->network[layerIdx].getWeightMatrix(),
+                                    gradient->getLayerGradient(layerIdx), (T)this->learnRate, count);
+        ADAM_INSTRUMENT(this->instrumentation.recordUpdate(layerIdx, NeuralInstrumentation::now() - start));
+    }
+}
 
-            // std::cout << "d_bias: " << d_bias << std::endl;
+template<typename T>
+void NeuralNetworkTrainerT<T>::applyNetworkWeightsAsync(NeuralGradientT<T> *gradient, int count)
+{
+    // Loop through the network and update the weights (bias column included)
+    for (unsigned int layerIdx = 0; layerIdx < this->layerCount(); layerIdx++)
+    {
+        ADAM_INSTRUMENT(const uint64_t start = NeuralInstrumentation::now());
+        T *weights = this->network[layerIdx].getWeightMatrix();
+        T *change = gradient->getLayerGradient(layerIdx);
+        const size_t size = gradient->getLayerSize(layerIdx);
 
-            // Loop though each oh the weights and calculate the weight gradients
-            for (int i = 0; i < (int)neuron.getWeights().size() - 1; i++)
+        for (size_t i = 0; i < size; i++)
+        {
+            // Untouched weights are left alone, avoiding needless cache line traffic
+            if (change[i] == 0.0)
             {
-                key.str("");
-                key << "weight_" << layerIdx << "_" << neuronIdx << "_" << i;
-                cost_gradient.insert({key.str(), d_bias*layerInputs[i]});
-                // std::cout << key.str() << ": " << d_bias*layerInputs[i] << std::endl;
+                continue;
             }
+
+            // Relaxed read-modify-write; a racing update may be lost, as in Hogwild
+            // (the other workers' passes read these with plain loads, see header)
+            T weight;
+            __atomic_load(&weights[i], &weight, __ATOMIC_RELAXED);
+            weight -= this->learnRate * change[i] / count;
+            __atomic_store(&weights[i], &weight, __ATOMIC_RELAXED);
+            change[i] = 0.0;
         }
+        ADAM_INSTRUMENT(this->instrumentation.recordUpdate(layerIdx, NeuralInstrumentation::now() - start));
+    }
+}
+
+template<typename T>
+void NeuralNetworkTrainerT<T>::shapeWorkspaces()
+{
+    const size_t outputsSize = (size_t)EVALUATION_CHUNK * this->getOutputCount();
+    this->workspaces.resize(this->threadCount);
+    for (Workspace &workspace : this->workspaces)
+    {
+        workspace.arena.shape(&this->network, ARENA_SLOTS);
+        workspace.gradient.shape(&this->network);
+        workspace.outputs.resize(outputsSize);
+        workspace.cost = 0.0;
+    }
+}
+
+template<typename T>
+void NeuralNetworkTrainerT<T>::shapeOptimizer()
+{
+    this->optimizer.shape(&this->network);
+    if (this->trainingMode == NeuralTrainingMode::ASYNCHRONOUS && this->optimizer.getType() != NeuralOptimizerType::SGD)
+    {
+        std::cout << "Warning: asynchronous training applies plain SGD, the optimizer is ignored" << std::endl;
+    }
+}
+
+template<typename T>
+void NeuralNetworkTrainerT<T>::captureSnapshot(NeuralSnapshotT<T> *snapshot, const std::vector<int> &indexes,
+                                               const std::vector<unsigned int> &blindIndexes, unsigned int rowCount,
+                                               unsigned int cycle)
+{
+    snapshot->cycle = cycle;
+    snapshot->rowCount = rowCount;
+    snapshot->convergenceCount = this->currentConvergenceCount;
+    snapshot->bestLoss = this->bestLoss;
+    snapshot->epochLoss = this->epochLoss;
+    snapshot->blindLoss = this->blindLoss;
+    snapshot->optimizerType = (unsigned int)this->optimizer.getType();
+    snapshot->optimizerSteps = this->optimizer.getStepCount();
+
+    // Plain copies into the buffer's existing storage
+    snapshot->shape.clear();
+    snapshot->weights.clear();
+    for (NeuralLayerT<T> &layer : this->network)
+    {
+        const T *weights = layer.getWeightMatrix();
+        snapshot->shape.push_back(layer.neuronCount());
+        snapshot->shape.push_back(layer.getInputCount());
+        snapshot->shape.push_back(layer.getWeightStride());
+        snapshot->weights.insert(snapshot->weights.end(), weights,
+                                 weights + (size_t)layer.neuronCount() * layer.getWeightStride());
+    }
+    snapshot->optimizerState.assign(this->optimizer.getState(),
+                                    this->optimizer.getState() + this->optimizer.getStateSize());
+    snapshot->indexes.assign(indexes.begin(), indexes.end());
+    snapshot->blindIndexes.assign(blindIndexes.begin(), blindIndexes.end());
+
+    std::ostringstream generatorState;
+    generatorState << this->generator;
+    snapshot->generatorState = generatorState.str();
+}
+
+template<typename T>
+bool NeuralNetworkTrainerT<T>::restoreSnapshot(const NeuralSnapshotT<T> &snapshot)
+{
+    // The generator is parsed first, so a corrupt state leaves the trainer untouched
+    std::mt19937 generator;
+    std::istringstream generatorState(snapshot.generatorState);
+    if (!(generatorState >> generator))
+    {
+        std::cout << "Error: checkpoint generator state is corrupt" << std::endl;
+        return false;
+    }
+    this->generator = generator;
+
+    const T *weights = snapshot.weights.data();
+    for (NeuralLayerT<T> &layer : this->network)
+    {
+        const size_t size = (size_t)layer.neuronCount() * layer.getWeightStride();
+        std::copy(weights, weights + size, layer.getWeightMatrix());
+        weights += size;
+    }
+    this->optimizer.restoreState(snapshot.optimizerState.data(), snapshot.optimizerState.size(),
+                                 snapshot.optimizerSteps);
+
+    this->currentConvergenceCount = snapshot.convergenceCount;
+    this->bestLoss = snapshot.bestLoss;
+    this->epochLoss = snapshot.epochLoss;
+    this->blindLoss = snapshot.blindLoss;
+    return true;
+}
+
+template<typename T>
+void NeuralNetworkTrainerT<T>::trainSample(const T *inputs, const T *truths, Workspace *workspace)
+{
+    // Place the network call (outputs are stored in the workspace)
+    const T *layerInputs = inputs;
+    for (unsigned int layerIdx = 0; layerIdx < this->layerCount(); layerIdx++)
+    {
+        ADAM_INSTRUMENT(const uint64_t start = NeuralInstrumentation::now());
+        T *activations = workspace->arena.buffer(ACTIVATION_SLOT, layerIdx);
+        this->network[layerIdx].forwardTrain(layerInputs, activations, workspace->arena.buffer(DERIVATIVE_SLOT, layerIdx));
+        ADAM_INSTRUMENT(this->instrumentation.recordForward(layerIdx, NeuralInstrumentation::now() - start, 1));
+        layerInputs = activations;
     }
-    return cost_gradient;
+
+    // Update the cost value for sample
+    const T *outputs = layerInputs;
+    const unsigned int outputCount = this->network.back().neuronCount();
+    for (unsigned int i = 0; i < outputCount; i++)
+    {
+        T diff = outputs[i] - truths[i];
+        workspace->cost += diff*diff;
+    }
+
+    this->backPropigation(inputs, truths, workspace);
 }
 
-// d_sigmoid/d_x = (sigmoid(x)*(1-sigmoid(x)))
-double NeuralNetworkTrainer::d_activation_fun(Neuron neuron)
+template<typename T>
+void NeuralNetworkTrainerT<T>::backPropigation(const T *inputs, const T *truths, Workspace *workspace)
 {
-    switch(neuron.getActivationType())
+    // We start at the outter most layer and calculate backwards
+    for (int layerIdx = (int)this->layerCount() - 1; layerIdx >= 0; layerIdx--)
     {
-        case NeuralActivationType::SIGMOID:
-            return neuron.getNeuronMemory()*(1-neuron.getNeuronMemory());
-        default:
-            return 0.0;
+        ADAM_INSTRUMENT(const uint64_t start = NeuralInstrumentation::now());
+        NeuralLayerT<T> &layer = this->network[layerIdx];
+        const unsigned int neuronCount = layer.neuronCount();
+        const unsigned int inputCount = layer.getInputCount();
+        const T *activations = workspace->arena.buffer(ACTIVATION_SLOT, layerIdx);
+        const T *derivatives = workspace->arena.buffer(DERIVATIVE_SLOT, layerIdx);
+        T *delta = workspace->arena.buffer(DELTA_SLOT, layerIdx);
+
+        // We setup the inputs that feed the layer we're working on
+        const T *layerInputs = (layerIdx == 0) ? inputs : workspace->arena.buffer(ACTIVATION_SLOT, layerIdx - 1);
+
+        // The activation is different for the output (last) layer.
+        if (layerIdx == (int)this->layerCount() - 1)
+        {
+            //dC_N/da_L; Cost function = 1/2*(a - y)^2
+            for (unsigned int neuronIdx = 0; neuronIdx < neuronCount; neuronIdx++)
+            {
+                delta[neuronIdx] = activations[neuronIdx] - truths[neuronIdx];
+            }
+        }
+        else
+        {
+            // The d_activation is the sum of the activation impacts on the next layer,
+            // dz^n/da^(n-1) (next layer weights) times the next layer bias (dC_dZ) terms
+            NeuralLayerT<T> &nextLayer = this->network[layerIdx + 1];
+            const T *nextWeights = nextLayer.getWeightMatrix();
+            const T *nextDelta = workspace->arena.buffer(DELTA_SLOT, layerIdx + 1);
+            const unsigned int nextStride = nextLayer.getWeightStride();
+
+            std::fill(delta, delta + neuronCount, 0.0);
+            for (unsigned int i = 0; i < nextLayer.neuronCount(); i++)
+            {
+                NeuralKernels::axpy(nextDelta[i], nextWeights + (size_t)i * nextStride + 1, delta, neuronCount);
+            }
+        }
+
+        T *layerGradient = workspace->gradient.getLayerGradient(layerIdx);
+        const unsigned int stride = workspace->gradient.getStride(layerIdx);
+        for (unsigned int neuronIdx = 0; neuronIdx < neuronCount; neuronIdx++)
+        {
+            // We leverage the fact that the cr_summation == cr_bias
+            T d_bias = derivatives[neuronIdx] * delta[neuronIdx];
+            delta[neuronIdx] = d_bias;
+
+            // Bias gradient first, then each of the weight gradients
+            T *row = layerGradient + (size_t)neuronIdx * stride;
+            row[0] += d_bias;
+            NeuralKernels::axpy(d_bias, layerInputs, row + 1, inputCount);
+        }
+        ADAM_INSTRUMENT(this->instrumentation.recordBackward(layerIdx, NeuralInstrumentation::now() - start, 1));
     }
 }
 
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralNetworkTrainerT<float>;
+template class NeuralNetworkTrainerT<double>;
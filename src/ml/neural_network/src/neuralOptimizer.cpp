@@ -0,0 +1,278 @@
+#ifndef NEURALOPTIMIZER_H
+#include "neuralOptimizer.hpp"
+#endif
+
+#ifndef NEURALKERNELS_H
+#include "neuralKernels.hpp"
+#endif
+
+#include <cmath>
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Default
+template<typename T>
+NeuralOptimizerT<T>::NeuralOptimizerT()
+{
+    this->type = NeuralOptimizerType::SGD;
+    this->beta1 = 0.9;
+    this->beta2 = 0.999;
+    this->epsilon = 1e-8;
+    this->steps = 0;
+    this->rateCorrection = 1.0;
+}
+
+// Constructor with the update rule
+template<typename T>
+NeuralOptimizerT<T>::NeuralOptimizerT(NeuralOptimizerType type): NeuralOptimizerT()
+{
+    this->type = type;
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+template<typename T>
+NeuralOptimizerT<T>::~NeuralOptimizerT()
+{
+    // This object maintains ownership of data, no pointers to clean up
+}
+
+/*********************** SETTERS ***********************************/
+
+// Set Type
+template<typename T>
+void NeuralOptimizerT<T>::setType(NeuralOptimizerType type)
+{
+    this->type = type;
+    this->state.clear();
+    this->offsets.clear();
+    this->sizes.clear();
+    this->steps = 0;
+}
+
+// Set Factors
+template<typename T>
+void NeuralOptimizerT<T>::setFactors(double beta1, double beta2, double epsilon)
+{
+    // Check the decays keep the state bounded
+    if (beta1 < 0.0 || beta1 >= 1.0 || beta2 < 0.0 || beta2 >= 1.0)
+    {
+        std::cout << "Error: optimizer decays must be in [0, 1)" << std::endl;
+        return;
+    }
+
+    // Check the guard is usable
+    if (epsilon <= 0.0)
+    {
+        std::cout << "Error: optimizer epsilon must be positive" << std::endl;
+        return;
+    }
+
+    this->beta1 = beta1;
+    this->beta2 = beta2;
+    this->epsilon = epsilon;
+}
+
+// Shape State
+template<typename T>
+void NeuralOptimizerT<T>::shape(std::vector<NeuralLayerT<T>> *network)
+{
+    // Check that the vector is null
+    if (!network)
+    {
+        std::cout << "Error: network pointer null" << std::endl;
+        return;
+    }
+
+    this->offsets.clear();
+    this->sizes.clear();
+
+    // Each layer holds its slots back to back, mirroring its weight matrix
+    size_t total = 0;
+    for (NeuralLayerT<T> &layer : *network)
+    {
+        const size_t size = (size_t)layer.neuronCount() * layer.getWeightStride();
+        this->offsets.push_back(total);
+        this->sizes.push_back(size);
+        total += size * this->slotCount();
+    }
+
+    this->state.resize(total);
+    this->reset();
+}
+
+// Restore State
+template<typename T>
+bool NeuralOptimizerT<T>::restoreState(const T *state, size_t size, unsigned long steps)
+{
+    // Check the state mirrors the shaped one
+    if (size != this->state.size())
+    {
+        std::cout << "Error: optimizer state size does not match, state not restored" << std::endl;
+        return false;
+    }
+
+    std::copy(state, state + size, this->state.begin());
+    this->steps = steps;
+    return true;
+}
+
+/*********************** GETTERS ***********************************/
+
+// Get Type
+template<typename T>
+NeuralOptimizerType NeuralOptimizerT<T>::getType() const
+{
+    return this->type;
+}
+
+// Get Beta1
+template<typename T>
+double NeuralOptimizerT<T>::getBeta1() const
+{
+    return this->beta1;
+}
+
+// Get Beta2
+template<typename T>
+double NeuralOptimizerT<T>::getBeta2() const
+{
+    return this->beta2;
+}
+
+// Get Epsilon
+template<typename T>
+double NeuralOptimizerT<T>::getEpsilon() const
+{
+    return this->epsilon;
+}
+
+// Get Step Count
+template<typename T>
+unsigned long NeuralOptimizerT<T>::getStepCount() const
+{
+    return this->steps;
+}
+
+// Get State
+template<typename T>
+const T * NeuralOptimizerT<T>::getState() const
+{
+    return this->state.data();
+}
+
+// Get State Size
+template<typename T>
+size_t NeuralOptimizerT<T>::getStateSize() const
+{
+    return this->state.size();
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Reset State
+template<typename T>
+void NeuralOptimizerT<T>::reset()
+{
+    std::fill(this->state.begin(), this->state.end(), 0.0);
+    this->steps = 0;
+}
+
+// Step
+template<typename T>
+void NeuralOptimizerT<T>::step(std::vector<NeuralLayerT<T>> *network, NeuralGradientT<T> *gradient, T rate, int count)
+{
+    if (!this->beginStep(network, gradient))
+    {
+        return;
+    }
+
+    // Loop through the network and update the weights (bias column included)
+    for (unsigned int layerIdx = 0; layerIdx < this->sizes.size(); layerIdx++)
+    {
+        this->updateLayer(layerIdx, (*network)[layerIdx].getWeightMatrix(), gradient->getLayerGradient(layerIdx),
+                          rate, count);
+    }
+}
+
+// Begin Step
+template<typename T>
+bool NeuralOptimizerT<T>::beginStep(std::vector<NeuralLayerT<T>> *network, NeuralGradientT<T> *gradient)
+{
+    // Check the state mirrors the network
+    if (!network || network->size() != this->sizes.size() || gradient->layerCount() != this->sizes.size())
+    {
+        std::cout << "Error: optimizer not shaped to the network, skipping step" << std::endl;
+        return false;
+    }
+
+    this->steps++;
+
+    // Fold both ADAM bias corrections into the rate
+    this->rateCorrection = 1.0;
+    if (this->type == NeuralOptimizerType::ADAM)
+    {
+        const double correction1 = 1.0 - std::pow(this->beta1, (double)this->steps);
+        const double correction2 = 1.0 - std::pow(this->beta2, (double)this->steps);
+        this->rateCorrection = std::sqrt(correction2) / correction1;
+    }
+    return true;
+}
+
+// Update Layer
+template<typename T>
+void NeuralOptimizerT<T>::updateLayer(unsigned int layerIdx, T *weights, const T *gradient, T rate, int count)
+{
+    const size_t size = this->sizes[layerIdx];
+    T *slots = this->state.data() + this->offsets[layerIdx];
+    const T scale = (T)(1.0 / count);
+
+    switch(this->type)
+    {
+        case NeuralOptimizerType::MOMENTUM:
+        case NeuralOptimizerType::NESTEROV:
+            NeuralKernels::momentumStep(weights, slots, gradient, (unsigned int)size, scale, rate, (T)this->beta1,
+                                        this->type == NeuralOptimizerType::NESTEROV);
+            break;
+        case NeuralOptimizerType::RMSPROP:
+            NeuralKernels::rmspropStep(weights, slots, gradient, (unsigned int)size, scale, rate,
+                                       (T)this->beta2, (T)this->epsilon);
+            break;
+        case NeuralOptimizerType::ADAM:
+            NeuralKernels::adamStep(weights, slots, slots + size, gradient, (unsigned int)size, scale,
+                                    (T)(rate * this->rateCorrection), (T)this->beta1, (T)this->beta2,
+                                    (T)this->epsilon);
+            break;
+        default:
+            // Plain SGD, padding columns have a zero gradient so they remain untouched
+            for (size_t i = 0; i < size; i++)
+            {
+                weights[i] -= rate * gradient[i] / count;
+            }
+            break;
+    }
+}
+
+/*********************** PRIVATE FUNCTIONS *************************/
+
+// Slot Count
+template<typename T>
+unsigned int NeuralOptimizerT<T>::slotCount() const
+{
+    switch(this->type)
+    {
+        case NeuralOptimizerType::MOMENTUM:
+        case NeuralOptimizerType::NESTEROV:
+        case NeuralOptimizerType::RMSPROP:
+            return 1;
+        case NeuralOptimizerType::ADAM:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralOptimizerT<float>;
+template class NeuralOptimizerT<double>;
@@ -0,0 +1,323 @@
+#ifndef NEURALQUANTIZEDNETWORK_H
+#include "neuralQuantizedNetwork.hpp"
+#endif
+
+#include <cmath>
+#include <algorithm>
+
+// Round to the nearest int8 step, saturating to the symmetric range (vectorizable)
+template<typename T>
+static inline int8_t quantizeValue(T value)
+{
+    value = std::min((T)127, std::max((T)-127, value));
+    return (int8_t)(int)(value + (value < 0 ? (T)-0.5 : (T)0.5));
+}
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Default
+template<typename T>
+NeuralQuantizedNetworkT<T>::NeuralQuantizedNetworkT()
+{
+    this->initialized = false;
+    this->inputCount = 0;
+    this->calibrationDrift = NeuralQuantizationDrift{0.0, 0.0, 0.0, 0};
+}
+
+// Constructor quantizing a trained network
+template<typename T>
+NeuralQuantizedNetworkT<T>::NeuralQuantizedNetworkT(NeuralNetworkT<T> *network,
+                                                    std::vector<std::vector<T>> *calibration): NeuralQuantizedNetworkT()
+{
+    this->quantize(network, calibration);
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+template<typename T>
+NeuralQuantizedNetworkT<T>::~NeuralQuantizedNetworkT()
+{
+    // This object maintains ownership of data, no pointers to clean up
+}
+
+/*********************** GETTERS ***********************************/
+
+// Is Initialized?
+template<typename T>
+bool NeuralQuantizedNetworkT<T>::isInitialized()
+{
+    return this->initialized;
+}
+
+// Returns Network Expected Input
+template<typename T>
+unsigned int NeuralQuantizedNetworkT<T>::getInputCount()
+{
+    return this->inputCount;
+}
+
+// Returns Network Output Count
+template<typename T>
+unsigned int NeuralQuantizedNetworkT<T>::getOutputCount()
+{
+    if (this->network.empty())
+    {
+        return 0;
+    }
+    return (unsigned int)this->network.back().biases.size();
+}
+
+// Get Layer Count
+template<typename T>
+unsigned int NeuralQuantizedNetworkT<T>::layerCount()
+{
+    return (unsigned int)this->network.size();
+}
+
+// Get Weight Bytes
+template<typename T>
+size_t NeuralQuantizedNetworkT<T>::getWeightBytes()
+{
+    size_t bytes = 0;
+    for (QuantizedLayer &layer : this->network)
+    {
+        bytes += layer.weights.size();
+    }
+    return bytes;
+}
+
+// Get Calibration Drift
+template<typename T>
+NeuralQuantizationDrift NeuralQuantizedNetworkT<T>::getCalibrationDrift()
+{
+    return this->calibrationDrift;
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Quantize Network
+template<typename T>
+bool NeuralQuantizedNetworkT<T>::quantize(NeuralNetworkT<T> *network, std::vector<std::vector<T>> *calibration)
+{
+    // Check that there is a network to quantize
+    if (!network || network->layerCount() == 0)
+    {
+        std::cout << "Error: network has no layers or pointer null" << std::endl;
+        return false;
+    }
+
+    // Check that there is calibration data
+    if (!calibration || calibration->empty())
+    {
+        std::cout << "Error: calibration data was empty or pointer null" << std::endl;
+        return false;
+    }
+
+    const unsigned int layers = network->layerCount();
+    unsigned int widest = 0;
+    for (unsigned int layerIdx = 0; layerIdx < layers; layerIdx++)
+    {
+        widest = std::max(widest, network->getLayer(layerIdx)->neuronCount());
+    }
+
+    // Calibrate - the largest input magnitude seen by each layer
+    std::vector<T> inputRanges(layers, 0);
+    AlignedVector<T> front(widest);
+    AlignedVector<T> back(widest);
+    unsigned int calibrated = 0;
+    for (std::vector<T> &sample : *calibration)
+    {
+        if (sample.size() != network->getInputCount())
+        {
+            continue;
+        }
+
+        const T *layerInputs = sample.data();
+        for (unsigned int layerIdx = 0; layerIdx < layers; layerIdx++)
+        {
+            NeuralLayerT<T> *layer = network->getLayer(layerIdx);
+            for (unsigned int i = 0; i < layer->getInputCount(); i++)
+            {
+                inputRanges[layerIdx] = std::max(inputRanges[layerIdx], (T)std::fabs(layerInputs[i]));
+            }
+            layer->forward(layerInputs, front.data());
+            layerInputs = front.data();
+            std::swap(front, back);
+        }
+        calibrated++;
+    }
+
+    if (calibrated == 0)
+    {
+        std::cout << "Error: no calibration sample had " << network->getInputCount() << " inputs" << std::endl;
+        return false;
+    }
+
+    // Freeze every layer
+    std::vector<QuantizedLayer> quantized(layers);
+    size_t widestInput = 0;
+    for (unsigned int layerIdx = 0; layerIdx < layers; layerIdx++)
+    {
+        NeuralLayerT<T> *layer = network->getLayer(layerIdx);
+        QuantizedLayer &target = quantized[layerIdx];
+        const unsigned int neuronCount = layer->neuronCount();
+        const unsigned int sourceStride = layer->getWeightStride();
+        const T *source = layer->getWeightMatrix();
+
+        target.inputCount = layer->getInputCount();
+        target.weightStride = alignedStride<int8_t>(target.inputCount);
+        target.weights.assign((size_t)neuronCount * target.weightStride, 0);
+        target.rowScales.resize(neuronCount);
+        target.biases.resize(neuronCount);
+        target.activationTypes.assign(layer->getActivationTypes(), layer->getActivationTypes() + neuronCount);
+        widestInput = std::max(widestInput, (size_t)target.inputCount);
+
+        // A range of zero (EX: an input that never varies) keeps a unit scale
+        const T inputScale = (inputRanges[layerIdx] > 0) ? inputRanges[layerIdx] / 127 : 1;
+        target.inputInverseScale = 1 / inputScale;
+
+        for (unsigned int neuronIdx = 0; neuronIdx < neuronCount; neuronIdx++)
+        {
+            const T *row = source + (size_t)neuronIdx * sourceStride;
+            int8_t *quantizedRow = target.weights.data() + (size_t)neuronIdx * target.weightStride;
+
+            // Symmetric per-row scale, the bias (column 0) stays at full precision
+            T rowRange = 0;
+            for (unsigned int i = 1; i <= target.inputCount; i++)
+            {
+                rowRange = std::max(rowRange, (T)std::fabs(row[i]));
+            }
+            const T rowScale = (rowRange > 0) ? rowRange / 127 : 1;
+            for (unsigned int i = 1; i <= target.inputCount; i++)
+            {
+                quantizedRow[i - 1] = quantizeValue(row[i] / rowScale);
+            }
+
+            target.biases[neuronIdx] = row[0];
+            target.rowScales[neuronIdx] = rowScale * inputScale;
+        }
+    }
+
+    // If we made it here, swap the frozen network in
+    this->network = std::move(quantized);
+    this->inputCount = network->getInputCount();
+    this->quantizedInputs.assign(widestInput, 0);
+    this->front.assign(widest, 0);
+    this->back.assign(widest, 0);
+    this->initialized = true;
+
+    this->calibrationDrift = this->measureDrift(network, calibration);
+    return true;
+}
+
+// Measure Drift
+template<typename T>
+NeuralQuantizationDrift NeuralQuantizedNetworkT<T>::measureDrift(NeuralNetworkT<T> *reference,
+                                                                 std::vector<std::vector<T>> *inputs)
+{
+    NeuralQuantizationDrift drift{0.0, 0.0, 0.0, 0};
+
+    // Check that both networks can be fired
+    if (!this->initialized || !reference || !inputs)
+    {
+        std::cout << "Error: quantized network not initialized or pointer null" << std::endl;
+        return drift;
+    }
+    if (reference->getInputCount() != this->inputCount || reference->getOutputCount() != this->getOutputCount())
+    {
+        std::cout << "Error: reference network shape does not match" << std::endl;
+        return drift;
+    }
+
+    std::vector<T> outputs(this->getOutputCount());
+    double absSum = 0.0;
+    double squareSum = 0.0;
+    for (std::vector<T> &sample : *inputs)
+    {
+        if (sample.size() != this->inputCount)
+        {
+            continue;
+        }
+
+        std::vector<T> expected = reference->recall(&sample);
+        this->recall(sample.data(), outputs.data());
+        for (unsigned int i = 0; i < (unsigned int)outputs.size(); i++)
+        {
+            double error = std::fabs((double)outputs[i] - (double)expected[i]);
+            drift.maxAbsError = std::max(drift.maxAbsError, error);
+            absSum += error;
+            squareSum += error * error;
+        }
+        drift.sampleCount++;
+    }
+
+    if (drift.sampleCount > 0)
+    {
+        const double count = (double)drift.sampleCount * outputs.size();
+        drift.meanAbsError = absSum / count;
+        drift.rmsError = std::sqrt(squareSum / count);
+    }
+    return drift;
+}
+
+// Quantized Recall
+template<typename T>
+std::vector<T> NeuralQuantizedNetworkT<T>::recall(std::vector<T> *inputs)
+{
+    // Check that the network was quantized
+    if (!this->initialized)
+    {
+        std::cout << "Error: quantized network not initialized" << std::endl;
+        return std::vector<T>();
+    }
+
+    // Check the input size
+    if (!inputs || inputs->size() != this->inputCount)
+    {
+        std::cout << "Error: invalid input size, expected " << this->inputCount << std::endl;
+        return std::vector<T>();
+    }
+
+    std::vector<T> outputs(this->getOutputCount());
+    this->recall(inputs->data(), outputs.data());
+    return outputs;
+}
+
+// Quantized Recall (raw)
+template<typename T>
+void NeuralQuantizedNetworkT<T>::recall(const T *inputs, T *outputs)
+{
+    const unsigned int lastLayer = (unsigned int)this->network.size() - 1;
+    const T *layerInputs = inputs;
+    int8_t *quantized = this->quantizedInputs.data();
+
+    for (unsigned int layerIdx = 0; layerIdx <= lastLayer; layerIdx++)
+    {
+        const QuantizedLayer &layer = this->network[layerIdx];
+
+        // Quantize the layer inputs with the calibrated scale (saturating)
+        for (unsigned int i = 0; i < layer.inputCount; i++)
+        {
+            quantized[i] = quantizeValue(layerInputs[i] * layer.inputInverseScale);
+        }
+
+        // int32 accumulation, dequantized before the activation
+        T *layerOutputs = (layerIdx == lastLayer) ? outputs : this->front.data();
+        const unsigned int neuronCount = (unsigned int)layer.biases.size();
+        for (unsigned int neuronIdx = 0; neuronIdx < neuronCount; neuronIdx++)
+        {
+            const int8_t *row = layer.weights.data() + (size_t)neuronIdx * layer.weightStride;
+            int32_t sum = NeuralKernels::dot(row, quantized, layer.inputCount);
+            T localSum = layer.biases[neuronIdx] + layer.rowScales[neuronIdx] * (T)sum;
+            layerOutputs[neuronIdx] = NeuronT<T>::activate(localSum, layer.activationTypes[neuronIdx]);
+        }
+
+        layerInputs = layerOutputs;
+        std::swap(this->front, this->back);
+    }
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralQuantizedNetworkT<float>;
+template class NeuralQuantizedNetworkT<double>;
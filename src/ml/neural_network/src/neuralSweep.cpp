@@ -0,0 +1,557 @@
+#ifndef NEURALSWEEP_H
+#include "neuralSweep.hpp"
+#endif
+
+#include <cmath>
+#include <limits>
+#include <cstdio>
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Default
+template<typename T>
+NeuralSweepT<T>::NeuralSweepT()
+{
+    this->learnRateLow = 0.0f;
+    this->learnRateHigh = 0.0f;
+    this->searchType = NeuralSearchType::GRID;
+    this->searchSamples = 0;
+    this->trainingCycles = 1000;
+    this->halvingRate = 2;
+    this->threadCount = 1;
+    this->blindLossSamples = 1000;
+    this->generator.seed(rand());
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+template<typename T>
+NeuralSweepT<T>::~NeuralSweepT()
+{
+    // This object maintains ownership of data, no pointers to clean up
+}
+
+/*********************** SETTERS ***********************************/
+
+// Add Topology
+template<typename T>
+void NeuralSweepT<T>::addTopology(const std::vector<unsigned int> &layers)
+{
+    // Check every layer has neurons
+    if (layers.empty() || std::find(layers.begin(), layers.end(), 0u) != layers.end())
+    {
+        std::cout << "Error: topology must have at least one layer, each with neurons" << std::endl;
+        return;
+    }
+    this->topologies.push_back(layers);
+}
+
+// Add Learn Rate
+template<typename T>
+void NeuralSweepT<T>::addLearnRate(float rate)
+{
+    this->learnRates.push_back(rate);
+}
+
+// Add Data Split Ratio
+template<typename T>
+void NeuralSweepT<T>::addDataSplitRatio(float ratio)
+{
+    // Check that the ratio is valid
+    if (ratio < 0.0f || ratio > 1.0f)
+    {
+        std::cout << "Error: data split ratio must be in [0,1]" << std::endl;
+        return;
+    }
+    this->dataSplitRatios.push_back(ratio);
+}
+
+// Add Batch Size
+template<typename T>
+void NeuralSweepT<T>::addBatchSize(unsigned int size)
+{
+    this->batchSizes.push_back(size);
+}
+
+// Add Optimizer
+template<typename T>
+void NeuralSweepT<T>::addOptimizer(NeuralOptimizerType type)
+{
+    this->optimizers.push_back(type);
+}
+
+// Set Learn Rate Range
+template<typename T>
+void NeuralSweepT<T>::setLearnRateRange(float low, float high)
+{
+    // Check the range can be drawn log-uniformly
+    if (low <= 0.0f || high < low)
+    {
+        std::cout << "Error: learn rate range must satisfy 0 < low <= high" << std::endl;
+        return;
+    }
+    this->learnRateLow = low;
+    this->learnRateHigh = high;
+}
+
+// Set Search
+template<typename T>
+void NeuralSweepT<T>::setSearch(NeuralSearchType type, unsigned int samples)
+{
+    this->searchType = type;
+    this->searchSamples = samples;
+}
+
+// Set Training Cycles
+template<typename T>
+void NeuralSweepT<T>::setTrainingCycles(unsigned int cycles)
+{
+    // Check the cycle count is usable
+    if (cycles == 0 || cycles > (unsigned int)NeuralNetworkTrainerT<T>::MAX_TRAINING_CYCLES)
+    {
+        std::cout << "Error: training cycles must be in [1, " << NeuralNetworkTrainerT<T>::MAX_TRAINING_CYCLES
+                  << "]" << std::endl;
+        return;
+    }
+    this->trainingCycles = cycles;
+}
+
+// Set Halving Rate
+template<typename T>
+void NeuralSweepT<T>::setHalvingRate(unsigned int rate)
+{
+    this->halvingRate = rate;
+}
+
+// Set Thread Count
+template<typename T>
+void NeuralSweepT<T>::setThreadCount(unsigned int count)
+{
+    this->threadCount = std::max(1u, count);
+}
+
+// Set Blind Loss Samples
+template<typename T>
+void NeuralSweepT<T>::setBlindLossSamples(unsigned int samples)
+{
+    this->blindLossSamples = samples;
+}
+
+// Set Seed
+template<typename T>
+void NeuralSweepT<T>::setSeed(unsigned int seed)
+{
+    this->generator.seed(seed);
+}
+
+/*********************** GETTERS ***********************************/
+
+// Get Results
+template<typename T>
+const std::vector<NeuralSweepResult> & NeuralSweepT<T>::getResults() const
+{
+    return this->results;
+}
+
+// Get Best Network
+template<typename T>
+NeuralNetworkT<T> NeuralSweepT<T>::getBestNetwork()
+{
+    if (this->results.empty())
+    {
+        return NeuralNetworkT<T>();
+    }
+    return this->trainers[this->results[0].candidate].getNetwork();
+}
+
+// To Text
+template<typename T>
+std::string NeuralSweepT<T>::toText() const
+{
+    static const char *OPTIMIZER_NAMES[] = {"SGD", "MOMENTUM", "NESTEROV", "RMSPROP", "ADAM"};
+
+    char line[512];
+    std::string text;
+    std::snprintf(line, sizeof(line), "%4s %4s %8s %12s %9s %9s %9s %8s %6s %6s %-9s %s\n", "rank", "rung",
+                  "cycles", "loss", "trn_acc", "true_acc", "seconds", "rate", "split", "batch", "optimizer",
+                  "topology");
+    text += line;
+
+    for (unsigned int rank = 0; rank < this->results.size(); rank++)
+    {
+        const NeuralSweepResult &result = this->results[rank];
+        std::string topology;
+        for (unsigned int neurons : result.topology)
+        {
+            topology += (topology.empty() ? "" : "-") + std::to_string(neurons);
+        }
+        std::snprintf(line, sizeof(line), "%4u %4u %8u %12.6g %9.4f %9.4f %9.3f %8.4g %6.2f %6u %-9s %s\n",
+                      rank + 1, result.rung, result.cycles, result.loss, result.trainedAccuracy,
+                      result.trueAccuracy, result.seconds, result.learnRate, result.dataSplitRatio,
+                      result.batchSize, OPTIMIZER_NAMES[(int)result.optimizer], topology.c_str());
+        text += line;
+    }
+    return text;
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Run Sweep
+template<typename T>
+void NeuralSweepT<T>::run(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths)
+{
+    // Check that the views match each other
+    if (inputs.getRowCount() != truths.getRowCount() || inputs.getRowCount() == 0)
+    {
+        std::cout << "Error: sweep data is empty or the input and truth row counts differ" << std::endl;
+        return;
+    }
+
+    this->drawConfigurations(truths.getColumnCount());
+    if (this->results.empty())
+    {
+        std::cout << "Error: sweep search space is empty" << std::endl;
+        return;
+    }
+    this->buildTrainers(inputs.getColumnCount());
+
+    // One held out set for the whole run, from the rows no configuration trains on
+    const unsigned int rowCount = inputs.getRowCount();
+    float largestSplit = 0.0f;
+    for (const NeuralSweepResult &result : this->results)
+    {
+        largestSplit = std::max(largestSplit, result.dataSplitRatio);
+    }
+    const unsigned int heldOutStart = std::ceil(rowCount*largestSplit);
+    const unsigned int heldOutSize = rowCount - heldOutStart;
+    const unsigned int heldOutDrawn = std::min(this->blindLossSamples, heldOutSize);
+    if (this->blindLossSamples > 0 && heldOutDrawn == 0)
+    {
+        std::cout << "Warning: every row is trained on by some split, ranking on the training loss" << std::endl;
+    }
+
+    // Partial Fisher-Yates, so no row is held out twice
+    std::vector<unsigned int> heldOutRows;
+    heldOutRows.reserve(heldOutSize);
+    for (unsigned int row = heldOutStart; row < rowCount; row++)
+    {
+        heldOutRows.push_back(row);
+    }
+    for (unsigned int drawIdx = 0; drawIdx < heldOutDrawn; drawIdx++)
+    {
+        std::uniform_int_distribution<unsigned int> rowDraw(drawIdx, heldOutSize - 1);
+        std::swap(heldOutRows[drawIdx], heldOutRows[rowDraw(this->generator)]);
+    }
+    std::vector<const T *> heldOutInputRows(heldOutDrawn);
+    std::vector<const T *> heldOutTruthRows(heldOutDrawn);
+    for (unsigned int sampleIdx = 0; sampleIdx < heldOutDrawn; sampleIdx++)
+    {
+        heldOutInputRows[sampleIdx] = inputs.row(heldOutRows[sampleIdx]);
+        heldOutTruthRows[sampleIdx] = truths.row(heldOutRows[sampleIdx]);
+    }
+    const NeuralDataViewT<T> heldOutInputs(heldOutInputRows.data(), heldOutDrawn, inputs.getColumnCount());
+    const NeuralDataViewT<T> heldOutTruths(heldOutTruthRows.data(), heldOutDrawn, truths.getColumnCount());
+
+    // Enough rungs to halve the configurations down to one, as long as every
+    // rung still trains more cycles than the one before it
+    const unsigned int count = (unsigned int)this->results.size();
+    unsigned int rungs = 1;
+    if (this->halvingRate >= 2)
+    {
+        for (unsigned long reach = 1; reach < count && reach * this->halvingRate <= this->trainingCycles;
+             reach *= this->halvingRate)
+        {
+            rungs++;
+        }
+    }
+
+    std::vector<unsigned int> alive(count);
+    for (unsigned int candidate = 0; candidate < count; candidate++)
+    {
+        alive[candidate] = candidate;
+    }
+
+    NeuralWorkerPool pool(this->threadCount);
+    for (unsigned int rung = 0; rung < rungs; rung++)
+    {
+        // Each rung grows the cycles by the halving rate, the last trains to the full count
+        const double share = std::pow((double)this->halvingRate, (double)(rungs - 1 - rung));
+        const unsigned int cycles = std::max(1u, (unsigned int)(this->trainingCycles / share));
+        this->trainRung(inputs, truths, heldOutInputs, heldOutTruths, alive, rung, cycles, &pool);
+
+        // Only the best of the rung go on
+        this->rankByLoss(&alive);
+        if (rung + 1 < rungs)
+        {
+            alive.resize((alive.size() + this->halvingRate - 1) / this->halvingRate);
+        }
+    }
+
+    // Later rungs first, then the lower loss
+    std::stable_sort(this->results.begin(), this->results.end(),
+                     [](const NeuralSweepResult &a, const NeuralSweepResult &b)
+                     {
+                         return (a.rung != b.rung) ? a.rung > b.rung
+                                                   : NeuralSweepT<T>::ranksBefore(a.loss, b.loss);
+                     });
+}
+
+/*********************** PRIVATE FUNCTIONS *************************/
+
+// Draw Configurations
+template<typename T>
+void NeuralSweepT<T>::drawConfigurations(unsigned int outputCount)
+{
+    this->results.clear();
+
+    // Unlisted settings take the trainer defaults
+    NeuralNetworkTrainerT<T> defaults;
+    std::vector<std::vector<unsigned int>> topologies;
+    for (const std::vector<unsigned int> &topology : this->topologies)
+    {
+        if (topology.back() != outputCount)
+        {
+            std::cout << "Error: topology output layer does not match the truth columns, skipping" << std::endl;
+            continue;
+        }
+        topologies.push_back(topology);
+    }
+    const std::vector<float> learnRates = this->learnRates.empty()
+        ? std::vector<float>{defaults.getLearnRate()} : this->learnRates;
+    const std::vector<float> dataSplitRatios = this->dataSplitRatios.empty()
+        ? std::vector<float>{defaults.getDataSplitRatio()} : this->dataSplitRatios;
+    const std::vector<unsigned int> batchSizes = this->batchSizes.empty()
+        ? std::vector<unsigned int>{defaults.getBatchSize()} : this->batchSizes;
+    const std::vector<NeuralOptimizerType> optimizers = this->optimizers.empty()
+        ? std::vector<NeuralOptimizerType>{defaults.getOptimizer()} : this->optimizers;
+    if (topologies.empty())
+    {
+        return;
+    }
+
+    NeuralSweepResult result{};
+    result.loss = -1.0;
+    result.trainedAccuracy = -1.0;
+    result.trueAccuracy = -1.0;
+
+    switch(this->searchType)
+    {
+        case NeuralSearchType::RANDOM:
+        {
+            const bool logRange = this->learnRateLow > 0.0f;
+            std::uniform_real_distribution<double> logRate(std::log(this->learnRateLow > 0.0f ? this->learnRateLow : 1.0f),
+                                                           std::log(this->learnRateHigh > 0.0f ? this->learnRateHigh : 1.0f));
+            for (unsigned int sample = 0; sample < this->searchSamples; sample++)
+            {
+                result.candidate = sample;
+                result.topology = topologies[this->generator() % topologies.size()];
+                result.learnRate = logRange ? (float)std::exp(logRate(this->generator))
+                                            : learnRates[this->generator() % learnRates.size()];
+                result.dataSplitRatio = dataSplitRatios[this->generator() % dataSplitRatios.size()];
+                result.batchSize = batchSizes[this->generator() % batchSizes.size()];
+                result.optimizer = optimizers[this->generator() % optimizers.size()];
+                this->results.push_back(result);
+            }
+            break;
+        }
+        default:
+        {
+            // Every combination, counted off in mixed radix with the optimizer varying fastest
+            const size_t combinations = topologies.size() * learnRates.size() * dataSplitRatios.size()
+                                      * batchSizes.size() * optimizers.size();
+            for (size_t combination = 0; combination < combinations; combination++)
+            {
+                size_t digits = combination;
+                result.candidate = (unsigned int)combination;
+                result.optimizer = optimizers[digits % optimizers.size()];
+                digits /= optimizers.size();
+                result.batchSize = batchSizes[digits % batchSizes.size()];
+                digits /= batchSizes.size();
+                result.dataSplitRatio = dataSplitRatios[digits % dataSplitRatios.size()];
+                digits /= dataSplitRatios.size();
+                result.learnRate = learnRates[digits % learnRates.size()];
+                digits /= learnRates.size();
+                result.topology = topologies[digits];
+                this->results.push_back(result);
+            }
+            break;
+        }
+    }
+}
+
+// Build Trainers
+template<typename T>
+void NeuralSweepT<T>::buildTrainers(unsigned int inputCount)
+{
+    // Built in order on this thread, so the rand() weights do not depend on the workers
+    this->trainers.clear();
+    this->trainers.reserve(this->results.size());
+    for (const NeuralSweepResult &result : this->results)
+    {
+        this->trainers.emplace_back();
+        NeuralNetworkTrainerT<T> &trainer = this->trainers.back();
+        trainer.addLayer(result.topology[0], inputCount);
+        for (unsigned int layerIdx = 1; layerIdx < result.topology.size(); layerIdx++)
+        {
+            trainer.addLayer(result.topology[layerIdx]);
+        }
+        trainer.setLearnRate(result.learnRate);
+        trainer.setDataSplitRatio(result.dataSplitRatio);
+        trainer.setBatchSize(result.batchSize);
+        trainer.setOptimizer(result.optimizer);
+        trainer.setThreadCount(1);
+        trainer.setSeed(this->generator());
+    }
+}
+
+// Train Rung
+template<typename T>
+void NeuralSweepT<T>::trainRung(const NeuralDataViewT<T> &inputs, const NeuralDataViewT<T> &truths,
+                                const NeuralDataViewT<T> &heldOutInputs, const NeuralDataViewT<T> &heldOutTruths,
+                                const std::vector<unsigned int> &alive, unsigned int rung, unsigned int cycles,
+                                NeuralWorkerPool *pool)
+{
+    // Deal the configurations round robin, the costliest first so the cheap ones fill in the tail
+    std::vector<unsigned int> order(alive);
+    std::vector<double> cost(this->results.size(), 0.0);
+    for (unsigned int candidate : order)
+    {
+        const NeuralSweepResult &result = this->results[candidate];
+        double weights = 0.0;
+        unsigned int width = inputs.getColumnCount();
+        for (unsigned int neurons : result.topology)
+        {
+            weights += (double)neurons * (width + 1);
+            width = neurons;
+        }
+        cost[candidate] = weights * result.dataSplitRatio * (cycles - result.cycles);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&cost](unsigned int a, unsigned int b) { return cost[a] > cost[b]; });
+
+    std::vector<WorkQueue> queues(pool->size());
+    for (unsigned int i = 0; i < order.size(); i++)
+    {
+        queues[i % queues.size()].candidates.push_back(order[i]);
+    }
+
+    // Each worker scores the held out rows in its own scratch
+    const unsigned int heldOutCount = heldOutInputs.getRowCount();
+    const unsigned int outputCount = heldOutTruths.getColumnCount();
+    std::vector<NeuralContextT<T>> contexts(pool->size());
+    std::vector<std::vector<T>> heldOutOutputs(pool->size(), std::vector<T>((size_t)heldOutCount * outputCount));
+
+    // Each worker trains its own queue, then helps the others
+    auto work = [&](unsigned int workerIdx)
+    {
+        unsigned int candidate;
+        while (NeuralSweepT<T>::takeCandidate(&queues, workerIdx, &candidate))
+        {
+            NeuralSweepResult &result = this->results[candidate];
+            NeuralNetworkTrainerT<T> &trainer = this->trainers[candidate];
+            if (result.cycles >= cycles)
+            {
+                // Nothing left to train this rung, the last scores stand
+                result.rung = rung;
+                continue;
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            trainer.setTrainingCycles(cycles - result.cycles);
+            trainer.trainTestLoop(inputs, truths);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            // Results are only touched by the worker holding the configuration
+            result.rung = rung;
+            result.cycles += trainer.getCompletedCycles();
+            result.loss = trainer.getEpochLoss();
+            if (heldOutCount > 0)
+            {
+                // Scored as the trainer scores its blind loss, half the mean squared error per row
+                T *outputs = heldOutOutputs[workerIdx].data();
+                trainer.recallBatch(heldOutInputs, outputs, &contexts[workerIdx]);
+                double cost = 0.0;
+                for (unsigned int sampleIdx = 0; sampleIdx < heldOutCount; sampleIdx++)
+                {
+                    const T *expected = heldOutTruths.row(sampleIdx);
+                    for (unsigned int i = 0; i < outputCount; i++)
+                    {
+                        const double diff = (double)outputs[(size_t)sampleIdx * outputCount + i] - (double)expected[i];
+                        cost += diff*diff;
+                    }
+                }
+                result.loss = cost / heldOutCount / 2;
+            }
+            if (std::isnan(result.loss))
+            {
+                // A diverged configuration ranks last
+                result.loss = std::numeric_limits<double>::infinity();
+            }
+            result.trainedAccuracy = trainer.getTrainedAccuracy();
+            result.trueAccuracy = trainer.getTrueAccuracy();
+            result.seconds += elapsed.count();
+        }
+    };
+    pool->run(std::ref(work));
+}
+
+// Take Candidate
+template<typename T>
+bool NeuralSweepT<T>::takeCandidate(std::vector<WorkQueue> *queues, unsigned int workerIdx, unsigned int *candidate)
+{
+    // Own queue first, from the front
+    {
+        WorkQueue &own = (*queues)[workerIdx];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.candidates.empty())
+        {
+            *candidate = own.candidates.front();
+            own.candidates.pop_front();
+            return true;
+        }
+    }
+
+    // Then steal from the back of the others, the next worker along first
+    const unsigned int count = (unsigned int)queues->size();
+    for (unsigned int offset = 1; offset < count; offset++)
+    {
+        WorkQueue &victim = (*queues)[(workerIdx + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.candidates.empty())
+        {
+            *candidate = victim.candidates.back();
+            victim.candidates.pop_back();
+            return true;
+        }
+    }
+
+    // Nothing is added during a rung, so empty queues mean it is done
+    return false;
+}
+
+// Rank By Loss
+template<typename T>
+void NeuralSweepT<T>::rankByLoss(std::vector<unsigned int> *candidates) const
+{
+    std::stable_sort(candidates->begin(), candidates->end(),
+                     [this](unsigned int a, unsigned int b)
+                     {
+                         return NeuralSweepT<T>::ranksBefore(this->results[a].loss, this->results[b].loss);
+                     });
+}
+
+// Ranks Before
+template<typename T>
+bool NeuralSweepT<T>::ranksBefore(double a, double b)
+{
+    // An unscored configuration (negative loss) ranks after every scored one
+    if ((a < 0.0) != (b < 0.0))
+    {
+        return b < 0.0;
+    }
+    return a < b;
+}
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuralSweepT<float>;
+template class NeuralSweepT<double>;
@@ -0,0 +1,103 @@
+#ifndef NEURALWORKERPOOL_H
+#include "neuralWorkerPool.hpp"
+#endif
+
+/*********************** CONSTRUCTORS ******************************/
+
+// Constructor with worker count
+NeuralWorkerPool::NeuralWorkerPool(unsigned int threadCount)
+{
+    this->task = nullptr;
+    this->generation = 0;
+    this->pending = 0;
+    this->stopping = false;
+
+    // The caller is worker 0, so only (threadCount - 1) threads are needed
+    for (unsigned int workerIdx = 1; workerIdx < threadCount; workerIdx++)
+    {
+        this->threads.emplace_back(&NeuralWorkerPool::workerLoop, this, workerIdx);
+    }
+}
+
+/*********************** DESTRUCTORS *******************************/
+
+NeuralWorkerPool::~NeuralWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->poolMutex);
+        this->stopping = true;
+    }
+    this->taskPosted.notify_all();
+
+    for (std::thread &thread : this->threads)
+    {
+        thread.join();
+    }
+}
+
+/*********************** GETTERS ***********************************/
+
+// Worker Count
+unsigned int NeuralWorkerPool::size() const
+{
+    return (unsigned int)this->threads.size() + 1;
+}
+
+/*********************** FUNCTIONAL ********************************/
+
+// Run Task on Every Worker
+void NeuralWorkerPool::run(const std::function<void(unsigned int)> &task)
+{
+    // Nothing to hand off, just run it
+    if (this->threads.empty())
+    {
+        task(0);
+        return;
+    }
+
+    // Post the task
+    {
+        std::lock_guard<std::mutex> lock(this->poolMutex);
+        this->task = &task;
+        this->pending = (unsigned int)this->threads.size();
+        this->generation++;
+    }
+    this->taskPosted.notify_all();
+
+    // The caller takes its share
+    task(0);
+
+    // Wait for the rest
+    std::unique_lock<std::mutex> lock(this->poolMutex);
+    this->taskFinished.wait(lock, [this] { return this->pending == 0; });
+    this->task = nullptr;
+}
+
+// Worker Loop
+void NeuralWorkerPool::workerLoop(unsigned int workerIdx)
+{
+    unsigned long seen = 0;
+    std::unique_lock<std::mutex> lock(this->poolMutex);
+    while (true)
+    {
+        // Park until a new task or stop is posted
+        this->taskPosted.wait(lock, [this, seen] { return this->stopping || this->generation != seen; });
+        if (this->stopping)
+        {
+            return;
+        }
+        seen = this->generation;
+        const std::function<void(unsigned int)> *current = this->task;
+
+        // Do the work outside the lock
+        lock.unlock();
+        (*current)(workerIdx);
+        lock.lock();
+
+        // Last one out wakes the caller
+        if (--this->pending == 0)
+        {
+            this->taskFinished.notify_one();
+        }
+    }
+}
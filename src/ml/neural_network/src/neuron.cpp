@@ -5,18 +5,22 @@
 /*********************** CONSTRUCTORS ******************************/
 
 // Default
-Neuron::Neuron()
+template<typename T>
+NeuronT<T>::NeuronT()
 {
     // inputCount is initialized to 0 (uninitialized neuron)
     this->initialized = false;
     this->activated = false;
     this->neuronMemory = -12345678.9;
     this->inputCount = 0;
+    this->weightSize = 0;
     this->activationType = NeuralActivationType::SIGMOID;
+    this->bindLocal();
 }
 
 // Constructor with inputCount - unassigned weights
-Neuron::Neuron(unsigned int inputCount): Neuron()
+template<typename T>
+NeuronT<T>::NeuronT(unsigned int inputCount): NeuronT()
 {
     // Preliminary checks
     if ( inputCount == 0 )
@@ -24,23 +28,25 @@ Neuron::Neuron(unsigned int inputCount): Neuron()
         std::cout << "Error: inputCount must be greater than 0" << std::endl;
         return;
     }
-    
+
     // Set up new assessment
     this->inputCount = inputCount;
     this->weightSize = (inputCount + 1);
-    
+
     // Generate random weights by default
     for (unsigned int i = 0; i < this->weightSize; i++)
     {
         this->weights.push_back(.6*(double)rand() / RAND_MAX - 0.3);
     }
-    
+    this->bindLocal();
+
     // Set status as initialized
     this->initialized = true;
 }
 
 // Constructor with assigned weights
-Neuron::Neuron(std::vector<double> *weights): Neuron()
+template<typename T>
+NeuronT<T>::NeuronT(std::vector<T> *weights): NeuronT()
 {
     // Preliminary checks
     if ( weights->empty() )
@@ -55,27 +61,77 @@ Neuron::Neuron(std::vector<double> *weights): Neuron()
                   << "Invalid weightArray size (size >= 2)" << std::endl;
         return;
     }
-    
+
     // Set up new assessment
     this->inputCount = inputCount;
     this->weights = *weights;
     this->weightSize = inputCount + 1;
-    
+    this->bindLocal();
+
     // Set status as initialized
     this->initialized = true;
 }
 
+// Constructor of a bound neuron (layer view)
+template<typename T>
+NeuronT<T>::NeuronT(unsigned int inputCount, T *weights, T *memory,
+                    bool *activated, NeuralActivationType *activationType): NeuronT()
+{
+    this->inputCount = inputCount;
+    this->weightSize = inputCount + 1;
+    this->bound = true;
+    this->weightView = weights;
+    this->memoryView = memory;
+    this->activatedView = activated;
+    this->activationTypeView = activationType;
+    this->initialized = true;
+}
+
+// Copy Constructor
+template<typename T>
+NeuronT<T>::NeuronT(const NeuronT<T> &other)
+{
+    *this = other;
+}
+
+// Copy Assignment
+template<typename T>
+NeuronT<T> & NeuronT<T>::operator=(const NeuronT<T> &other)
+{
+    this->initialized = other.initialized;
+    this->activated = other.activated;
+    this->inputCount = other.inputCount;
+    this->neuronMemory = other.neuronMemory;
+    this->weights = other.weights;
+    this->weightSize = other.weightSize;
+    this->activationType = other.activationType;
+    this->bound = other.bound;
+    this->weightView = other.weightView;
+    this->memoryView = other.memoryView;
+    this->activatedView = other.activatedView;
+    this->activationTypeView = other.activationTypeView;
+
+    // A standalone neuron must view its own copy, not the source object
+    if (!this->bound)
+    {
+        this->bindLocal();
+    }
+    return *this;
+}
+
 /*********************** DESTRUCTORS *******************************/
 
-Neuron::~Neuron()
+template<typename T>
+NeuronT<T>::~NeuronT()
 {
-    // This object maintains ownership of data, no pointers to clean up
-} 
+    // Views are non-owning, the layer maintains ownership of bound storage
+}
 
 /*********************** SETTERS ***********************************/
 
 // Set Weights
-void Neuron::setWeights(std::vector<double> *weights)
+template<typename T>
+void NeuronT<T>::setWeights(std::vector<T> *weights)
 {
     // Check that the vector is empty or null
     if (!weights || weights->size() == 0)
@@ -98,66 +154,86 @@ void Neuron::setWeights(std::vector<double> *weights)
                   << "Invalid weightArray size" << std::endl;
         return;
     }
-    
+
     // Should be safe for assignment
-    this->weights = *weights;
+    std::copy(weights->begin(), weights->begin() + this->weightSize, this->weightView);
 }
 
 // Set Activation Type
-void Neuron::setActivationType(NeuralActivationType type)
+template<typename T>
+void NeuronT<T>::setActivationType(NeuralActivationType type)
 {
-    this->activationType = type;
+    *this->activationTypeView = type;
 }
 
 /*********************** GETTERS ***********************************/
 
 // Is Initialized?
-bool Neuron::isInitialized()
+template<typename T>
+bool NeuronT<T>::isInitialized()
 {
     return this->initialized;
 }
 
 // Has activated?
-bool Neuron::hasActivated()
+template<typename T>
+bool NeuronT<T>::hasActivated()
 {
-    return this->activated;
+    return *this->activatedView;
 }
 
 // Get Weights
-std::vector<double> Neuron::getWeights()
+template<typename T>
+std::vector<T> NeuronT<T>::getWeights()
+{
+    if (!this->weightView)
+    {
+        return std::vector<T>();
+    }
+    return std::vector<T>(this->weightView, this->weightView + this->weightSize);
+}
+
+// Get Weight Data
+template<typename T>
+const T * NeuronT<T>::getWeightData()
 {
-    return this->weights;
+    return this->weightView;
 }
 
 // Get Input Count
-unsigned int Neuron::getInputCount()
+template<typename T>
+unsigned int NeuronT<T>::getInputCount()
 {
     return this->inputCount;
 }
 
 // Get Neuron Memory
-double Neuron::getNeuronMemory()
+template<typename T>
+T NeuronT<T>::getNeuronMemory()
 {
-    return this->neuronMemory;
+    return *this->memoryView;
 }
 
 // Get Activation Type
-NeuralActivationType Neuron::getActivationType()
+template<typename T>
+NeuralActivationType NeuronT<T>::getActivationType()
 {
-    return this->activationType;
+    return *this->activationTypeView;
 }
 
 /*********************** FUNCTIONAL ********************************/
 
 // Clear Neuron
-void Neuron::clearNeruon()
+template<typename T>
+void NeuronT<T>::clearNeruon()
 {
-    this->activated = false;
-    this->neuronMemory = -12345678.9;
+    *this->activatedView = false;
+    *this->memoryView = -12345678.9;
 }
 
 // Neuron Recall Method
-double Neuron::recall(std::vector<double> *inputs)
+template<typename T>
+T NeuronT<T>::recall(std::vector<T> *inputs)
 {
     // Check that the vector is empty or null
     if (!inputs || inputs->size() == 0)
@@ -180,58 +256,91 @@ double Neuron::recall(std::vector<double> *inputs)
         return -12345678.9;
     }
 
-    // Get some iterators
-    std::vector<double>::iterator weightsItr = this->weights.begin();
-    std::vector<double>::iterator inputsItr = inputs->begin(); 
+    // Calculate sum with the bias first multiplied by one, then the input*weight vectors
+    T localSum = this->weightView[0] + NeuralKernels::dot(this->weightView + 1, inputs->data(), this->inputCount);
 
-    // Calculate sum with the bias first multiplied by one
-    double localSum = *(weightsItr);
-    weightsItr++;
+    // Let's assume that we activated first
+    *this->activatedView = true;
+    *this->memoryView = NeuronT<T>::activate(localSum, *this->activationTypeView);
 
-    // Sum the input*weight vectors
-    for (; inputsItr != inputs->cend(); ++inputsItr, ++weightsItr)
+    // Somehow we got an unknown activation, unset neuron
+    if (*this->memoryView == (T)-12345678.9)
     {
-        localSum += (*weightsItr) * (*inputsItr);
+        *this->activatedView = false;
     }
 
-    // Let's assume that we activated first
-    this->activated = true;
+    return *this->memoryView;
+}
 
+// Activation Function
+template<typename T>
+T NeuronT<T>::activate(T sum, NeuralActivationType type)
+{
     // Return value based upon activation type
-    switch(this->activationType)
+    switch(type)
     {
         // SWITCH
         case NeuralActivationType::SWITCH:
-            this->neuronMemory = (localSum > 0.0)? 1.0 : 0.0;
-            break;
+            return (sum > 0.0)? 1.0 : 0.0;
 
         // SIGMOID
         case NeuralActivationType::SIGMOID:
-            this->neuronMemory = 1/ ( 1 + std::exp(-localSum));
-            break;
+            return 1/ ( 1 + std::exp(-sum));
 
         // HYPERBOLIC TANGENT
         case NeuralActivationType::HYPERBOLIC_TANGENT:
-            this->neuronMemory = std::tanh(localSum);
-            break;
+            return std::tanh(sum);
 
         // RAW
         case NeuralActivationType::RAW:
-            this->neuronMemory = localSum;
-            break;
+            return sum;
 
         // CATEGORICAL
         case NeuralActivationType::CATEGORICAL:
-            this->neuronMemory = std::floor(localSum);
-            break;
+            return std::floor(sum);
 
         // ??
         default:
-            // Somehow we got here, unset neuron
-            this->neuronMemory = -12345678.9;
-            this->activated = false;
-            break;
+            return -12345678.9;
     }
+}
+
+// Activation Derivative
+template<typename T>
+T NeuronT<T>::derivative(T activation, NeuralActivationType type)
+{
+    switch(type)
+    {
+        // SIGMOID: s * (1 - s)
+        case NeuralActivationType::SIGMOID:
+            return activation * (1 - activation);
 
-    return this->neuronMemory;
+        // HYPERBOLIC TANGENT: 1 - tanh^2
+        case NeuralActivationType::HYPERBOLIC_TANGENT:
+            return 1 - activation * activation;
+
+        // RAW
+        case NeuralActivationType::RAW:
+            return 1.0;
+
+        // SWITCH, CATEGORICAL and ?? are flat almost everywhere
+        default:
+            return 0.0;
+    }
+}
+
+// Bind views to own members
+template<typename T>
+void NeuronT<T>::bindLocal()
+{
+    this->bound = false;
+    this->weightView = this->weights.empty() ? nullptr : this->weights.data();
+    this->memoryView = &this->neuronMemory;
+    this->activatedView = &this->activated;
+    this->activationTypeView = &this->activationType;
 }
+
+/*********************** INSTANTIATIONS ****************************/
+
+template class NeuronT<float>;
+template class NeuronT<double>;
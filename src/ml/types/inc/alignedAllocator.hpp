@@ -0,0 +1,91 @@
+#ifndef ALIGNEDALLOCATOR_H
+#define ALIGNEDALLOCATOR_H
+
+#include <new>
+#include <vector>
+#include <cstddef>
+
+/// The byte alignment used for all contiguous numeric storage (one cache line)
+const std::size_t ADAM_ALIGNMENT = 64;
+
+/**
+ * This is a minimal standard allocator that returns storage aligned to
+ * ADAM_ALIGNMENT bytes.  It is used for the contiguous weight and activation
+ * buffers, so that rows begin on a cache line and can be consumed by wide
+ * vector loads.
+ */
+template <typename T>
+class AlignedAllocator
+{
+public: // Public Members
+
+    typedef T value_type;
+
+    /// Rebind is required for allocators with non-type template parameters
+    template <typename U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U> other;
+    };
+
+public: // Public Methods
+
+    /*********************** CONSTRUCTORS ******************************/
+
+    /// Default
+    AlignedAllocator() noexcept {}
+
+    /// Converting constructor (allocators are stateless)
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U> &) noexcept {}
+
+    /*********************** FUNCTIONAL ********************************/
+
+    /**
+     * Allocate storage for count objects of T, aligned to ADAM_ALIGNMENT
+     *
+     * @param count - the number of objects to allocate for
+     * @return - pointer to the aligned storage
+     */
+    T * allocate(std::size_t count)
+    {
+        return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(ADAM_ALIGNMENT)));
+    }
+
+    /**
+     * Release storage previously returned by allocate
+     *
+     * @param ptr - the storage to release
+     * @param count - the number of objects the storage was allocated for
+     */
+    void deallocate(T *ptr, std::size_t count) noexcept
+    {
+        ::operator delete(ptr, std::align_val_t(ADAM_ALIGNMENT));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T> &, const AlignedAllocator<U> &) { return true; }
+
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T> &, const AlignedAllocator<U> &) { return false; }
+
+/// Vector with cache line aligned contiguous storage
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * This returns the padded row length (in elements) such that each row of a
+ * row-major matrix starts on an ADAM_ALIGNMENT boundary.
+ *
+ * @param columns - the number of used columns in the row
+ * @return - the row stride in elements
+ */
+template <typename T>
+inline unsigned int alignedStride(unsigned int columns)
+{
+    const unsigned int perLine = ADAM_ALIGNMENT / sizeof(T);
+    return ((columns + perLine - 1) / perLine) * perLine;
+}
+
+#endif
@@ -47,6 +47,98 @@ enum class NeuralActivationType
     HYPERBOLIC_TANGENT
 };
 
+/**
+ * Enumeration to select how accurately a network evaluates its sigmoid and
+ * hyperbolic tangent neurons.  Either way, a layer activates all of its
+ * neurons of one type together with the vectorized kernels.
+ */
+enum class NeuralActivationMode
+{
+    /** Within a few ULP of the standard library functions */
+    EXACT,
+
+    /**
+     * A low degree approximation, within about 1e-5 relative, for wide
+     * layers where the activation costs as much as the weighted sums
+     */
+    FAST
+};
+
+/**
+ * Enumeration to select how the trainer schedules weight updates across
+ * its worker threads
+ */
+enum class NeuralTrainingMode
+{
+    /**
+     * Each mini-batch is partitioned across the workers, the worker gradients
+     * are reduced, and the weights are updated once per mini-batch.  Results
+     * are deterministic for a fixed thread count (the thread count changes
+     * the order the gradients are summed in).
+     */
+    SYNCHRONOUS,
+
+    /**
+     * Lock-free (Hogwild style) training.  Workers pull shuffled samples and
+     * apply each sample's gradient straight to the shared weights with relaxed
+     * atomics, without waiting on each other between samples.  Workers may
+     * read weights mid-update, so results vary from run to run.  Those reads
+     * are plain (vectorized) loads racing the atomic stores: a deliberate,
+     * non-conforming Hogwild read that relies on aligned scalars not tearing.
+     */
+    ASYNCHRONOUS
+};
+
+/**
+ * Enumeration to select the rule the trainer applies the (mini-batch
+ * averaged) gradient to the weights with
+ */
+enum class NeuralOptimizerType
+{
+    /** Plain gradient descent, w -= rate * g */
+    SGD,
+
+    /**
+     * Heavy ball momentum: a velocity accumulates the decayed gradients and
+     * the weights move along it, carrying them through flat or noisy stretches
+     */
+    MOMENTUM,
+
+    /**
+     * Nesterov momentum: as MOMENTUM, but the step looks ahead along the
+     * velocity, which damps the overshoot of plain momentum
+     */
+    NESTEROV,
+
+    /**
+     * Each weight's step is divided by a running root mean square of its
+     * gradients, so steep and shallow directions advance at similar speed
+     */
+    RMSPROP,
+
+    /**
+     * Adaptive moment estimation: momentum on the gradient (first moment)
+     * combined with RMSProp scaling (second moment), both bias corrected
+     */
+    ADAM
+};
+
+/**
+ * Enumeration to select how a hyperparameter sweep draws its configurations
+ * from the search space
+ */
+enum class NeuralSearchType
+{
+    /** Every combination of the listed values */
+    GRID,
+
+    /**
+     * A fixed number of configurations, each value drawn at random from its
+     * list (the learn rate log-uniformly from its range, when one is set)
+     */
+    RANDOM
+};
+
 /**
  * Enumeration to distinguish between different datasets
  */
@@ -0,0 +1,221 @@
+// Adam regression tests
+//
+// Each test builds a small network or dataset, exercises one behaviour and
+// reports PASS / FAIL.  The exit code is the number of failed tests.
+//
+// Usage: AdamTest
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+#include <iostream>
+
+#include "neuralNetworkTrainer.hpp"
+
+/*********************** HELPERS ***********************************/
+
+/// Scratch files are written here and removed by the test that made them
+static const std::string TEST_DIRECTORY = "/tmp/";
+
+/*********************** TESTS *************************************/
+
+// Export an imported (memory mapped) network back over its own file, then recall it
+static bool testExportOverImport()
+{
+    const std::string path = TEST_DIRECTORY + "AdamTestExportOverImport.model";
+    NeuralNetwork source;
+    source.addLayer(4, 2);
+    source.addLayer(1);
+    std::vector<double> inputs{0.25, -0.5};
+    const double expected = source.recall(&inputs)[0];
+    if (!source.exportNetwork(path))
+    {
+        return false;
+    }
+
+    NeuralNetwork model;
+    bool passed = model.importNetwork(path) && model.exportNetwork(path);
+
+    // The mapping must still be readable, and the file must still be a model
+    passed = passed && model.recall(&inputs)[0] == expected;
+    NeuralNetwork reloaded;
+    passed = passed && reloaded.importNetwork(path) && reloaded.recall(&inputs)[0] == expected;
+    std::remove(path.c_str());
+    return passed;
+}
+
+// A model whose first layer takes no inputs is rejected on import
+static bool testImportRejectsNoInputs()
+{
+    const std::string path = TEST_DIRECTORY + "AdamTestImportNoInputs.model";
+    NeuralNetwork source;
+    source.addLayer(3, 2);
+    source.addLayer(1);
+    if (!source.exportNetwork(path))
+    {
+        return false;
+    }
+
+    // Zero the input count of the header (offset 24) and of the first layer entry (offset 68)
+    const uint32_t zero = 0;
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(24);
+        file.write((const char *)&zero, sizeof(zero));
+        file.seekp(68);
+        file.write((const char *)&zero, sizeof(zero));
+    }
+
+    NeuralNetwork model;
+    const bool passed = !model.importNetwork(path);
+    std::remove(path.c_str());
+    return passed;
+}
+
+// A stream that cannot be rewound leaves no accuracies of an earlier run behind
+static bool testStreamRewindFailure()
+{
+    const std::string path = TEST_DIRECTORY + "AdamTestStreamRewind.csv";
+    {
+        std::ofstream file(path);
+        for (unsigned int row = 0; row < 200; row++)
+        {
+            const double x = (double)(row % 20) / 20.0;
+            file << x << "," << (x < 0.5 ? 1 : 0) << "\n";
+        }
+    }
+
+    NeuralNetworkTrainer trainer;
+    trainer.addLayer(2, 1);
+    trainer.addLayer(1);
+    trainer.setTrainingCycles(5);
+    NeuralDataStream stream(path, {0}, {1});
+    trainer.trainTestStream(&stream);
+    bool passed = trainer.getTrueAccuracy() >= 0.0 && trainer.getSamplesPerSecond() > 0.0;
+
+    // The file is gone for the second run, so its first rewind fails
+    std::remove(path.c_str());
+    trainer.trainTestStream(&stream);
+    passed = passed && trainer.getTrainedAccuracy() < 0.0 && trainer.getTrueAccuracy() < 0.0 &&
+             trainer.getSamplesPerSecond() == 0.0;
+    return passed;
+}
+
+// A stream listing an input column twice refuses to read rather than leave a slot stale
+static bool testStreamRejectsDuplicateInputs()
+{
+    const std::string path = TEST_DIRECTORY + "AdamTestStreamDuplicate.csv";
+    {
+        std::ofstream file(path);
+        file << "0.5,0.25,1\n";
+    }
+
+    NeuralDataStream duplicate(path, {0, 0}, {2});
+    NeuralDataStream distinct(path, {0, 1}, {2});
+    const bool passed = !duplicate.rewind() && distinct.rewind();
+    std::remove(path.c_str());
+    return passed;
+}
+
+// Each fold starts from fresh weights, not from the weights of the network validated
+static bool testFoldsStartFresh()
+{
+    const unsigned int rows = 40;
+    std::vector<double> inputs(rows * 2);
+    std::vector<double> truths(rows);
+    for (unsigned int row = 0; row < rows; row++)
+    {
+        inputs[row * 2] = (double)row / rows;
+        inputs[row * 2 + 1] = 1.0 - (double)row / rows;
+        truths[row] = row % 2;
+    }
+
+    // Zero weights recall 0.5 for every row, a loss of exactly 0.125 if a fold kept them
+    NeuralNetworkTrainer trainer;
+    trainer.addLayer(3, 2);
+    trainer.addLayer(1);
+    for (unsigned int layerIdx = 0; layerIdx < trainer.layerCount(); layerIdx++)
+    {
+        NeuralLayer *layer = trainer.getLayer(layerIdx);
+        double *weights = layer->getWeightMatrix();
+        std::fill(weights, weights + layer->neuronCount() * layer->getWeightStride(), 0.0);
+    }
+    trainer.setTrainingCycles(0);
+    trainer.crossValidate(NeuralDataView(inputs.data(), rows, 2), NeuralDataView(truths.data(), rows, 1), 4);
+
+    bool passed = trainer.getFoldResults().size() == 4;
+    for (const NeuralFoldResult &result : trainer.getFoldResults())
+    {
+        passed = passed && result.loss != 0.125;
+    }
+    return passed;
+}
+
+// Resuming from the checkpoint of the converging cycle trains no further cycles
+static bool testResumeAtConvergence()
+{
+    const std::string path = TEST_DIRECTORY + "AdamTestResumeConverged.checkpoint";
+    const unsigned int rows = 40;
+    std::vector<double> inputs(rows * 2);
+    std::vector<double> truths(rows);
+    for (unsigned int row = 0; row < rows; row++)
+    {
+        inputs[row * 2] = (double)row / rows;
+        inputs[row * 2 + 1] = 1.0 - (double)row / rows;
+        truths[row] = (row < rows / 2) ? 1.0 : 0.0;
+    }
+    const NeuralDataView inputView(inputs.data(), rows, 2);
+    const NeuralDataView truthView(truths.data(), rows, 1);
+
+    // No cycle improves on the best loss by the margin, so the run converges on its third cycle
+    NeuralNetworkTrainer trainer;
+    trainer.addLayer(3, 2);
+    trainer.addLayer(1);
+    trainer.setTrainingCycles(50);
+    trainer.setConvergenceFactors(2, 1.0);
+    trainer.setSeed(7);
+    NeuralNetworkTrainer resumed(trainer);
+    trainer.setCheckpoint(path, 1);
+    trainer.trainTestLoop(inputView, truthView);
+
+    std::vector<double> sample{0.25, 0.75};
+    bool passed = trainer.getCompletedCycles() == 3 && resumed.resumeTestLoop(path, inputView, truthView);
+    passed = passed && resumed.getCompletedCycles() == 3 && resumed.recall(&sample)[0] == trainer.recall(&sample)[0];
+    std::remove(path.c_str());
+    return passed;
+}
+
+/*********************** MAIN **************************************/
+
+int main()
+{
+    srand(1);
+
+    struct Test
+    {
+        const char *name;
+        bool (*run)();
+    };
+    const std::vector<Test> tests = {
+        {"export over import", testExportOverImport},
+        {"import rejects no inputs", testImportRejectsNoInputs},
+        {"stream rewind failure", testStreamRewindFailure},
+        {"stream rejects duplicate inputs", testStreamRejectsDuplicateInputs},
+        {"folds start fresh", testFoldsStartFresh},
+        {"resume at convergence", testResumeAtConvergence},
+    };
+
+    int failures = 0;
+    for (const Test &test : tests)
+    {
+        const bool passed = test.run();
+        std::cout << (passed ? "PASS " : "FAIL ") << test.name << std::endl;
+        failures += passed ? 0 : 1;
+    }
+    std::cout << tests.size() - failures << " / " << tests.size() << " tests passed" << std::endl;
+    return failures;
+}